@@ -0,0 +1,334 @@
+#include "Boxfish.h"
+#include <chrono>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace Boxfish;
+
+// Microbenchmarks for the hot paths of the search.
+// Usage: Boxfish-Bench [--min-time seconds] [--filter substring] [--out filename]
+// Results are written as JSON in the same layout as Google Benchmark so that existing comparison tools can read them.
+
+struct BenchmarkResult
+{
+public:
+	std::string Name;
+	size_t Iterations;
+	double NanosecondsPerOp;
+};
+
+struct BenchmarkOptions
+{
+public:
+	double MinTimeSeconds = 0.5;
+	std::string Filter = "";
+	std::string OutputFile = "";
+};
+
+// Results are accumulated here so that the compiler cannot discard the benchmarked work
+static volatile uint64_t s_Sink = 0;
+
+static BenchmarkOptions s_Options;
+static std::vector<BenchmarkResult> s_Results;
+
+// Calls func repeatedly until the minimum time has passed, func performs opsPerCall operations each time
+template<typename Func>
+void RunBenchmark(const std::string& name, size_t opsPerCall, Func func)
+{
+	if (name.find(s_Options.Filter) == std::string::npos || opsPerCall == 0)
+		return;
+	func();
+
+	const auto minTime = std::chrono::duration<double>(s_Options.MinTimeSeconds);
+	size_t calls = 0;
+	auto startTime = std::chrono::high_resolution_clock::now();
+	std::chrono::nanoseconds elapsed(0);
+	do
+	{
+		func();
+		calls++;
+		elapsed = std::chrono::high_resolution_clock::now() - startTime;
+	} while (elapsed < minTime);
+
+	BenchmarkResult result;
+	result.Name = name;
+	result.Iterations = calls * opsPerCall;
+	result.NanosecondsPerOp = (double)elapsed.count() / result.Iterations;
+	s_Results.push_back(result);
+	std::cerr << name << ": " << result.NanosecondsPerOp << " ns/op (" << result.Iterations << " iterations)" << std::endl;
+}
+
+// The bench positions and every position one legal move away from them
+std::vector<Position> CreatePositionSet()
+{
+	std::vector<Position> positions;
+	for (const std::string& fen : GetBenchPositions())
+	{
+		Position position = CreatePositionFromFEN(fen);
+		positions.push_back(position);
+
+		Move buffer[MAX_MOVES];
+		MoveList moves(buffer);
+		MoveGenerator generator(position);
+		generator.GetLegalMoves(moves);
+		for (int i = 0; i < moves.MoveCount; i++)
+		{
+			Position child = position;
+			ApplyMove(child, moves.Moves[i]);
+			positions.push_back(child);
+		}
+	}
+	return positions;
+}
+
+struct PositionMove
+{
+public:
+	const Position* Pos;
+	Move Mv;
+};
+
+void BenchMoveGeneration(const std::vector<Position>& positions)
+{
+	RunBenchmark("movegen/pseudo_legal_filter", positions.size(), [&]()
+	{
+		for (const Position& position : positions)
+		{
+			Move buffer[MAX_MOVES];
+			MoveList moves(buffer);
+			MoveGenerator generator(position);
+			generator.GetPseudoLegalMoves(moves);
+			generator.FilterLegalMoves(moves);
+			s_Sink += moves.MoveCount;
+		}
+	});
+	RunBenchmark("movegen/legal", positions.size(), [&]()
+	{
+		for (const Position& position : positions)
+		{
+			Move buffer[MAX_MOVES];
+			MoveList moves(buffer);
+			MoveGenerator generator(position);
+			generator.GetLegalMoves(moves);
+			s_Sink += moves.MoveCount;
+		}
+	});
+}
+
+void BenchSee(const std::vector<PositionMove>& captures)
+{
+	RunBenchmark("see/SeeGE", captures.size(), [&]()
+	{
+		for (const PositionMove& capture : captures)
+			s_Sink += SeeGE(*capture.Pos, capture.Mv);
+	});
+}
+
+void BenchEvaluation(const std::vector<Position>& positions)
+{
+	RunBenchmark("eval/EvaluateDetailed", positions.size(), [&]()
+	{
+		for (const Position& position : positions)
+			s_Sink += MgValue(EvaluateDetailed(position).Total);
+	});
+}
+
+void BenchMakeMove(std::vector<Position>& positions, const std::vector<std::vector<Move>>& legalMoves, size_t moveCount)
+{
+	RunBenchmark("position/ApplyMove_UndoMove", moveCount, [&]()
+	{
+		for (size_t i = 0; i < positions.size(); i++)
+		{
+			Position& position = positions[i];
+			for (Move move : legalMoves[i])
+			{
+				UndoInfo undo;
+				ApplyMove(position, move, &undo);
+				s_Sink += position.Hash.Hash;
+				UndoMove(position, move, undo);
+			}
+		}
+	});
+}
+
+void BenchHashing(const std::vector<Position>& positions)
+{
+	RunBenchmark("zobrist/SetFromPosition", positions.size(), [&]()
+	{
+		for (const Position& position : positions)
+		{
+			ZobristHash hash;
+			hash.SetFromPosition(position);
+			s_Sink += hash.Hash;
+		}
+	});
+}
+
+void BenchTranspositionTable()
+{
+	// Large enough that most probes miss the cache, half of the probed keys are present in the table
+	constexpr size_t TABLE_BYTES = 64 * 1024 * 1024;
+	constexpr size_t KEY_COUNT = 1 << 20;
+	constexpr size_t PREFETCH_DISTANCE = 8;
+
+	TranspositionTable table(TABLE_BYTES);
+	std::vector<ZobristHash> keys;
+	keys.reserve(KEY_COUNT);
+	uint64_t state = 0x9E3779B97F4A7C15ULL;
+	for (size_t i = 0; i < KEY_COUNT; i++)
+	{
+		// xorshift64
+		state ^= state << 13;
+		state ^= state >> 7;
+		state ^= state << 17;
+		keys.push_back(ZobristHash(state));
+		if (i % 2 == 0)
+		{
+			bool found;
+			TranspositionTableData data;
+			table.GetEntry(keys.back(), found, data)->Update(keys.back(), MOVE_NONE, 1 + (int)(i % 8), 0, EXACT, table.GetAge(), false);
+		}
+	}
+
+	RunBenchmark("tt/GetEntry", keys.size(), [&]()
+	{
+		for (const ZobristHash& key : keys)
+		{
+			bool found;
+			TranspositionTableData data;
+			table.GetEntry(key, found, data);
+			s_Sink += found + data.Data;
+		}
+	});
+	RunBenchmark("tt/Prefetch_GetEntry", keys.size(), [&]()
+	{
+		for (size_t i = 0; i < keys.size(); i++)
+		{
+			if (i + PREFETCH_DISTANCE < keys.size())
+				table.Prefetch(keys[i + PREFETCH_DISTANCE]);
+			bool found;
+			TranspositionTableData data;
+			table.GetEntry(keys[i], found, data);
+			s_Sink += found + data.Data;
+		}
+	});
+}
+
+std::string EscapeJson(const std::string& str)
+{
+	std::string result;
+	for (char c : str)
+	{
+		if (c == '"' || c == '\\')
+			result += '\\';
+		result += c;
+	}
+	return result;
+}
+
+void WriteJson(std::ostream& stream, size_t positionCount)
+{
+	char date[64];
+	std::time_t now = std::time(nullptr);
+	std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+	stream << "{" << std::endl;
+	stream << "  \"context\": {" << std::endl;
+	stream << "    \"date\": \"" << date << "\"," << std::endl;
+	stream << "    \"executable\": \"Boxfish-Bench\"," << std::endl;
+#ifdef BOX_USE_PEXT
+	stream << "    \"pext\": true," << std::endl;
+#else
+	stream << "    \"pext\": false," << std::endl;
+#endif
+	stream << "    \"positions\": " << positionCount << "," << std::endl;
+	stream << "    \"min_time\": " << s_Options.MinTimeSeconds << std::endl;
+	stream << "  }," << std::endl;
+	stream << "  \"benchmarks\": [" << std::endl;
+	for (size_t i = 0; i < s_Results.size(); i++)
+	{
+		const BenchmarkResult& result = s_Results[i];
+		stream << "    {" << std::endl;
+		stream << "      \"name\": \"" << EscapeJson(result.Name) << "\"," << std::endl;
+		stream << "      \"iterations\": " << result.Iterations << "," << std::endl;
+		stream << "      \"real_time\": " << result.NanosecondsPerOp << "," << std::endl;
+		stream << "      \"time_unit\": \"ns\"" << std::endl;
+		stream << "    }" << ((i + 1 < s_Results.size()) ? "," : "") << std::endl;
+	}
+	stream << "  ]" << std::endl;
+	stream << "}" << std::endl;
+}
+
+bool ParseArguments(int argc, const char** argv)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const std::string arg = argv[i];
+		if (i + 1 >= argc)
+			return false;
+		if (arg == "--min-time")
+			s_Options.MinTimeSeconds = std::stod(argv[++i]);
+		else if (arg == "--filter")
+			s_Options.Filter = argv[++i];
+		else if (arg == "--out")
+			s_Options.OutputFile = argv[++i];
+		else
+			return false;
+	}
+	return true;
+}
+
+int main(int argc, const char** argv)
+{
+	if (!ParseArguments(argc, argv))
+	{
+		std::cerr << "Usage: Boxfish-Bench [--min-time seconds] [--filter substring] [--out filename]" << std::endl;
+		return 1;
+	}
+	Init();
+
+	std::vector<Position> positions = CreatePositionSet();
+	std::vector<std::vector<Move>> legalMoves;
+	std::vector<PositionMove> captures;
+	size_t moveCount = 0;
+	for (const Position& position : positions)
+	{
+		Move buffer[MAX_MOVES];
+		MoveList moves(buffer);
+		MoveGenerator generator(position);
+		generator.GetLegalMoves(moves);
+		legalMoves.emplace_back(moves.Moves, moves.Moves + moves.MoveCount);
+		moveCount += moves.MoveCount;
+		for (int i = 0; i < moves.MoveCount; i++)
+		{
+			if (moves.Moves[i].IsCapture())
+				captures.push_back({ &position, moves.Moves[i] });
+		}
+	}
+
+	BenchMoveGeneration(positions);
+	BenchSee(captures);
+	BenchEvaluation(positions);
+	BenchMakeMove(positions, legalMoves, moveCount);
+	BenchHashing(positions);
+	BenchTranspositionTable();
+
+	if (s_Options.OutputFile.empty())
+	{
+		WriteJson(std::cout, positions.size());
+	}
+	else
+	{
+		std::ofstream file(s_Options.OutputFile);
+		if (!file)
+		{
+			std::cerr << "Failed to open " << s_Options.OutputFile << std::endl;
+			return 1;
+		}
+		WriteJson(file, positions.size());
+	}
+	return 0;
+}
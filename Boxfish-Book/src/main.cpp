@@ -46,8 +46,7 @@ bool IsLegalMove(Move move, const Position& position)
 	Move moveBuffer[MAX_MOVES];
 	MoveList moves(moveBuffer);
 	MoveGenerator generator(position);
-	generator.GetPseudoLegalMoves(moves);
-	generator.FilterLegalMoves(moves);
+	generator.GetLegalMoves(moves);
 	for (int i = 0; i < moves.MoveCount; i++)
 	{
 		if (moves.Moves[i] == move)
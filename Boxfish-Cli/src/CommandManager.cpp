@@ -1,8 +1,12 @@
 #include "CommandManager.h"
+#include <cstdint>
 
 namespace Boxfish
 {
 
+	// Largest table size in MB whose size in bytes still fits in a size_t
+	static constexpr long long MAX_HASH_MB = (long long)(SIZE_MAX / (1024 * 1024));
+
 	CommandManager::CommandManager()
 		: m_CommandMap(), m_OpeningBook(), m_CurrentPosition(CreateStartingPosition()), m_Search(128 * 1024 * 1024), m_Settings(), m_Searching(false), m_SearchThread()
 	{
@@ -102,6 +106,23 @@ namespace Boxfish
 			}
 		};
 
+		m_CommandMap["divide"] = [this](const std::vector<std::string>& args)
+		{
+			if (args.size() > 0)
+			{
+				int depth = std::stoi(args[0]);
+				Divide(depth);
+			}
+		};
+
+		m_CommandMap["bench"] = [this](const std::vector<std::string>& args)
+		{
+			int depth = args.size() > 0 ? std::stoi(args[0]) : 10;
+			int threads = args.size() > 1 ? std::stoi(args[1]) : 1;
+			int hashMB = args.size() > 2 ? std::stoi(args[2]) : 16;
+			Bench(depth, threads, hashMB);
+		};
+
 		m_CommandMap["go"] = [this](const std::vector<std::string>& args)
 		{
 			if (args.size() > 0)
@@ -124,44 +145,25 @@ namespace Boxfish
 					}
 					else
 					{
-						int wtime = 0;
-						int btime = 0;
-						int winc = 0;
-						int binc = 0;
-						int movestogo = 0;
-
-						size_t moveStartIndex = 0;
+						// The time manager in the search splits the clock between moves
+						SearchLimits limits;
 						for (size_t i = 0; i < args.size(); i++)
 						{
 							const std::string& token = args[i];
 							if (token == "wtime" && i + 1 < args.size())
-								wtime = std::stoi(args[++i]);
+								limits.Time[TEAM_WHITE] = std::max(0, std::stoi(args[++i]));
 							else if (token == "btime" && i + 1 < args.size())
-								btime = std::stoi(args[++i]);
+								limits.Time[TEAM_BLACK] = std::max(0, std::stoi(args[++i]));
 							else if (token == "winc" && i + 1 < args.size())
-								winc = std::stoi(args[++i]);
+								limits.Increment[TEAM_WHITE] = std::max(0, std::stoi(args[++i]));
 							else if (token == "binc" && i + 1 < args.size())
-								binc = std::stoi(args[++i]);
+								limits.Increment[TEAM_BLACK] = std::max(0, std::stoi(args[++i]));
 							else if (token == "movestogo" && i + 1 < args.size())
-								movestogo = std::stoi(args[++i]);
+								limits.MovesToGo = std::max(0, std::stoi(args[++i]));
 							else
-							{
-								moveStartIndex = i;
 								break;
-							}
 						}
-						int colorTime = m_CurrentPosition.TeamToPlay == TEAM_WHITE ? wtime : btime;
-						int colorIncrement = m_CurrentPosition.TeamToPlay == TEAM_WHITE ? winc : binc;
-						int allocatedTime = 0;
-
-						if (colorIncrement > 0)
-							allocatedTime = int(colorTime * (1 + m_CurrentPosition.TotalTurns / 40.0f) / 16 + colorIncrement);
-						if (movestogo > 0)
-							allocatedTime = colorTime / (std::min(movestogo, 100) + 1) * 3 / 2;
-						else
-							allocatedTime = colorTime / 20;
-
-						GoTime(allocatedTime, {});
+						GoClock(limits);
 					}
 				}
 			}
@@ -177,6 +179,23 @@ namespace Boxfish
 			ProbeTT();
 		};
 
+		m_CommandMap["stats"] = [this](const std::vector<std::string>& args)
+		{
+			Stats();
+		};
+
+		m_CommandMap["savehash"] = [this](const std::vector<std::string>& args)
+		{
+			if (args.size() > 0)
+				SaveHash(args[0]);
+		};
+
+		m_CommandMap["loadhash"] = [this](const std::vector<std::string>& args)
+		{
+			if (args.size() > 0)
+				LoadHash(args[0]);
+		};
+
 		m_CommandMap["stop"] = [this](const std::vector<std::string>& args)
 		{
 			Stop();
@@ -187,6 +206,7 @@ namespace Boxfish
 			Quit();
 		};
 
+		m_Settings = m_Search.GetSettings();
 		ExecuteCommand("ucinewgame");
 	}
 
@@ -231,6 +251,11 @@ namespace Boxfish
 		std::cout << "\tPrint the static evaluation for the current position." << std::endl;
 		std::cout << "* perft <depth>" << std::endl;
 		std::cout << "\tPerformance test move generation for a given depth in the current position." << std::endl;
+		std::cout << "* divide <depth>" << std::endl;
+		std::cout << "\tSame as perft but also print the node count below each legal move." << std::endl;
+		std::cout << "* bench [depth] [threads] [hash]" << std::endl;
+		std::cout << "\tSearch a fixed set of positions to the given depth (default 10) using the given number of threads (default 1) and hash size in MB (default 16)." << std::endl;
+		std::cout << "\tPrints the total node count, which only changes when the search does if a single thread is used, and the overall nodes per second." << std::endl;
 		std::cout << "* go" << std::endl;
 		std::cout << "\tMain command to begin searching in the current position." << std::endl;
 		std::cout << "\tAccepts a number of different arguments:" << std::endl;
@@ -240,6 +265,14 @@ namespace Boxfish
 		std::cout << "\t\tSearch the current position to a given depth." << std::endl;
 		std::cout << "\t* movetime <time_ms>" << std::endl;
 		std::cout << "\t\tSearch the current position for a given number of milliseconds." << std::endl;
+		std::cout << "\t* wtime <time_ms> btime <time_ms> [winc <time_ms>] [binc <time_ms>] [movestogo <moves>]" << std::endl;
+		std::cout << "\t\tSearch the current position using the clock of the team to play." << std::endl;
+		std::cout << "* stats" << std::endl;
+		std::cout << "\tPrint the search statistics from the last search, only available if built with --stats." << std::endl;
+		std::cout << "* savehash <filename>" << std::endl;
+		std::cout << "\tWrite the contents of the hash table to a file." << std::endl;
+		std::cout << "* loadhash <filename>" << std::endl;
+		std::cout << "\tReplace the hash table with one previously written by savehash." << std::endl;
 		std::cout << "* stop" << std::endl;
 		std::cout << "\tStop searching as soon as possible." << std::endl;
 		std::cout << "* quit" << std::endl;
@@ -256,6 +289,7 @@ namespace Boxfish
 		if (!m_Searching)
 		{
 			m_Search.Reset();
+			m_Search.ClearTranspositionTable();
 			m_CurrentPosition = CreateStartingPosition();
 		}
 	}
@@ -279,6 +313,22 @@ namespace Boxfish
 		{
 			m_Settings.SkillLevel = std::min(std::max(0, std::stoi(value)), 20);
 		}
+		if (name == "lazy eval margin" && !m_Searching)
+		{
+			m_Settings.LazyEvalMargin = std::max(0, std::stoi(value));
+		}
+		if (name == "threads" && !m_Searching)
+		{
+			m_Settings.Threads = std::min(std::max(1, std::stoi(value)), 256);
+		}
+		if (name == "hash" && !m_Searching)
+		{
+			m_Settings.HashTableBytes = (size_t)std::min(std::max(1LL, std::stoll(value)), MAX_HASH_MB) * 1024 * 1024;
+		}
+		if (name == "perft hash" && !m_Searching)
+		{
+			m_Settings.PerftHashBytes = (size_t)std::min<long long>(std::max(0, std::stoi(value)), MAX_HASH_MB) * 1024 * 1024;
+		}
 		if (name == "book")
 		{
 			m_OpeningBook.Clear();
@@ -287,7 +337,42 @@ namespace Boxfish
 			else
 				std::cout << "Book file not found: " << value << std::endl;
 		}
+		if (name == "use nnue" && !m_Searching)
+		{
+			m_Settings.UseNNUE = value == "true";
+			if (m_Settings.UseNNUE && !IsNetworkLoaded())
+				std::cout << "No network loaded, set EvalFile first" << std::endl;
+		}
+		if (name == "evalfile" && !m_Searching)
+		{
+			if (LoadNetwork(value))
+				m_Search.ClearEvaluationCache();
+			else
+				std::cout << "Invalid or incompatible network file: " << value << std::endl;
+		}
+		if (name == "syzygypath" && !m_Searching)
+		{
+			m_Settings.SyzygyPath = value;
+		}
+		if (name == "move overhead")
+		{
+			m_Settings.MoveOverhead = std::min(std::max(0, std::stoi(value)), 5000);
+		}
+		if (name == "syzygyprobedepth")
+		{
+			m_Settings.SyzygyProbeDepth = std::max(1, std::stoi(value));
+		}
+		// A running search reads its settings without locking, anything changed meanwhile is applied when the next search starts
+		if (m_Searching)
+			return;
 		m_Search.SetSettings(m_Settings);
+		if (name == "hash" && m_Search.GetSettings().HashTableBytes != m_Settings.HashTableBytes)
+		{
+			m_Settings.HashTableBytes = m_Search.GetSettings().HashTableBytes;
+			std::cout << "Failed to allocate " << value << "MB hash, keeping " << m_Settings.HashTableBytes / (1024 * 1024) << "MB" << std::endl;
+		}
+		if (name == "syzygypath" && !value.empty() && value != "<empty>" && GetTablebaseCardinality() == 0)
+			std::cout << "No tablebases found in: " << value << std::endl;
 	}
 
 	void CommandManager::SetPositionFen(const std::string& fen)
@@ -308,7 +393,7 @@ namespace Boxfish
 			{
 				MoveList moves(moveBuffer);
 				MoveGenerator generator(m_CurrentPosition);
-				generator.GetPseudoLegalMoves(moves);
+				generator.GetLegalMoves(moves);
 				Move move = UCI::CreateMoveFromString(m_CurrentPosition, moveString);
 
 				bool legal = false;
@@ -316,12 +401,9 @@ namespace Boxfish
 				{
 					if (move == moves.Moves[i])
 					{
-						if (generator.IsLegal(move))
-						{
-							ApplyMove(m_CurrentPosition, move);
-							m_Search.PushPosition(m_CurrentPosition);
-							legal = true;
-						}
+						ApplyMove(m_CurrentPosition, move);
+						m_Search.PushPosition(m_CurrentPosition);
+						legal = true;
 						break;
 					}
 				}
@@ -348,6 +430,22 @@ namespace Boxfish
 		}
 	}
 
+	void CommandManager::Divide(int depth)
+	{
+		if (!m_Searching)
+		{
+			m_Search.Divide(m_CurrentPosition, depth);
+		}
+	}
+
+	void CommandManager::Bench(int depth, int threads, int hashMB)
+	{
+		if (!m_Searching)
+		{
+			RunBench(std::max(depth, 1), std::min(std::max(threads, 1), 256), (size_t)std::max(hashMB, 1) * 1024 * 1024);
+		}
+	}
+
 	void CommandManager::GoDepth(int depth, const std::unordered_set<Move>& includedMoves)
 	{
 		if (!m_Searching)
@@ -355,6 +453,7 @@ namespace Boxfish
 			m_Searching = true;
 			if (m_SearchThread.joinable())
 				m_SearchThread.join();
+			m_Search.SetSettings(m_Settings);
 			m_SearchThread = std::thread([this, depth, includedMoves]()
 			{
 				SearchLimits limits;
@@ -374,6 +473,7 @@ namespace Boxfish
 			m_Searching = true;
 			if (m_SearchThread.joinable())
 				m_SearchThread.join();
+			m_Search.SetSettings(m_Settings);
 			m_SearchThread = std::thread([this, milliseconds, includedMoves]()
 			{
 				SearchLimits limits;
@@ -386,6 +486,23 @@ namespace Boxfish
 		}
 	}
 
+	void CommandManager::GoClock(const SearchLimits& limits)
+	{
+		if (!m_Searching)
+		{
+			m_Searching = true;
+			if (m_SearchThread.joinable())
+				m_SearchThread.join();
+			m_Search.SetSettings(m_Settings);
+			m_SearchThread = std::thread([this, limits]()
+			{
+				Move bestMove = m_Search.SearchBestMove(m_CurrentPosition, limits);
+				std::cout << "bestmove " << UCI::FormatMove(bestMove) << std::endl;
+				m_Searching = false;
+			});
+		}
+	}
+
 	void CommandManager::GoPonder(const std::unordered_set<Move>& includedMoves)
 	{
 		if (!m_Searching)
@@ -393,6 +510,7 @@ namespace Boxfish
 			m_Searching = true;
 			if (m_SearchThread.joinable())
 				m_SearchThread.join();
+			m_Search.SetSettings(m_Settings);
 			m_SearchThread = std::thread([this, includedMoves]()
 			{
 				SearchLimits limits;
@@ -408,8 +526,7 @@ namespace Boxfish
 		Move moveBuffer[MAX_MOVES];
 		MoveGenerator generator(m_CurrentPosition);
 		MoveList moves(moveBuffer);
-		generator.GetPseudoLegalMoves(moves);
-		generator.FilterLegalMoves(moves);
+		generator.GetLegalMoves(moves);
 		for (int i = 0; i < moves.MoveCount; i++)
 		{
 			std::cout << UCI::FormatMove(moves.Moves[i]) << std::endl;
@@ -418,22 +535,21 @@ namespace Boxfish
 
 	void CommandManager::ProbeTT()
 	{
-		const TranspositionTableEntry* ttEntry = m_Search.ProbeTranspostionTable(m_CurrentPosition);
-		if (ttEntry)
+		TranspositionTableData ttData;
+		if (m_Search.ProbeTranspostionTable(m_CurrentPosition, ttData))
 		{
 			std::cout << "TT Entry" << std::endl;
-			std::cout << "Best Move: " << UCI::FormatMove(ttEntry->GetMove()) << std::endl;
-			std::cout << "Score: " << ttEntry->GetScore() << std::endl;
-			std::cout << "Depth: " << ttEntry->GetDepth() << std::endl;
-			std::cout << "Is PV: " << (ttEntry->IsPv() ? "true" : "false") << std::endl;
+			std::cout << "Best Move: " << UCI::FormatMove(ttData.GetMove()) << std::endl;
+			std::cout << "Score: " << ttData.GetScore() << std::endl;
+			std::cout << "Depth: " << ttData.GetDepth() << std::endl;
+			std::cout << "Is PV: " << (ttData.IsPv() ? "true" : "false") << std::endl;
 
 			Position position = m_CurrentPosition;
-			while (ttEntry != nullptr)
+			do
 			{
-				std::cout << UCI::FormatMove(ttEntry->GetMove()) << std::endl;
-				ApplyMove(position, ttEntry->GetMove());
-				ttEntry = m_Search.ProbeTranspostionTable(position);
-			}
+				std::cout << UCI::FormatMove(ttData.GetMove()) << std::endl;
+				ApplyMove(position, ttData.GetMove());
+			} while (m_Search.ProbeTranspostionTable(position, ttData));
 		}
 		else
 		{
@@ -441,6 +557,40 @@ namespace Boxfish
 		}
 	}
 
+	void CommandManager::Stats()
+	{
+		if (!SEARCH_STATS_ENABLED)
+		{
+			std::cout << "Search statistics are disabled, regenerate the projects with --stats" << std::endl;
+			return;
+		}
+		if (m_Searching)
+		{
+			std::cout << "Cannot print search statistics while searching" << std::endl;
+			return;
+		}
+		std::cout << FormatSearchStats(m_Search.GetSearchStats()) << std::endl;
+	}
+
+	void CommandManager::SaveHash(const std::string& filename)
+	{
+		if (!m_Searching)
+		{
+			if (!m_Search.SaveTranspositionTable(filename))
+				std::cout << "Failed to write hash file: " << filename << std::endl;
+		}
+	}
+
+	void CommandManager::LoadHash(const std::string& filename)
+	{
+		if (!m_Searching)
+		{
+			if (!m_Search.LoadTranspositionTable(filename))
+				std::cout << "Invalid or incompatible hash file: " << filename << std::endl;
+			m_Settings.HashTableBytes = m_Search.GetSettings().HashTableBytes;
+		}
+	}
+
 	void CommandManager::Stop()
 	{
 		if (m_Searching)
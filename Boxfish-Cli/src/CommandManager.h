@@ -35,8 +35,11 @@ namespace Boxfish
 		void ApplyMoves(const std::vector<std::string>& moves);
 		void Eval();
 		void Perft(int depth);
+		void Divide(int depth);
+		void Bench(int depth, int threads, int hashMB);
 		void GoDepth(int depth, const std::unordered_set<Move>& includedMoves);
 		void GoTime(int milliseconds, const std::unordered_set<Move>& includedMoves);
+		void GoClock(const SearchLimits& limits);
 		void GoPonder(const std::unordered_set<Move>& includedMoves);
 		void Stop();
 		void Quit();
@@ -44,6 +47,9 @@ namespace Boxfish
 		// Debug helpers
 		void Moves();
 		void ProbeTT();
+		void Stats();
+		void SaveHash(const std::string& filename);
+		void LoadHash(const std::string& filename);
 
 		// Utils
 		std::unordered_set<Move> GetMoveList(const std::vector<std::string>& args, int offset) const;
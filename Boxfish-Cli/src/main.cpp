@@ -12,6 +12,16 @@ int main(int argc, const char** argv)
 	std::cout << "Boxfish " << version << " by J. Morrison" << std::endl;
 
 	CommandManager commands;
+
+	// Run a single command from the command line (eg. boxfish bench) and exit
+	if (argc > 1)
+	{
+		std::string command = argv[1];
+		for (int i = 2; i < argc; i++)
+			command += std::string(" ") + argv[i];
+		commands.ExecuteCommand(command);
+		return 0;
+	}
  
 	char buffer[8192];
 	while (true)
@@ -11,8 +11,14 @@ namespace Boxfish
     BitBoard s_RookMasks[FILE_MAX * RANK_MAX] = { 0 };
     BitBoard s_BishopMasks[FILE_MAX * RANK_MAX] = { 0 };
 
-    BitBoard s_RookTable[FILE_MAX * RANK_MAX][4096] = { { 0 } };
-    BitBoard s_BishopTable[FILE_MAX * RANK_MAX][1024] = { { 0 } };
+    // Sum of 2^bits over every square
+    constexpr int ROOK_TABLE_SIZE = 102400;
+    constexpr int BISHOP_TABLE_SIZE = 5248;
+
+    BitBoard s_SlidingAttackTable[ROOK_TABLE_SIZE + BISHOP_TABLE_SIZE];
+
+    SlidingAttackInfo s_RookAttackInfo[FILE_MAX * RANK_MAX];
+    SlidingAttackInfo s_BishopAttackInfo[FILE_MAX * RANK_MAX];
 
     BitBoard GetBlockersFromIndex(int index, BitBoard mask)
     {
@@ -149,30 +155,34 @@ namespace Boxfish
         return attacks;
     }
 
-    void InitRookMagicTable()
+    // Returns the number of entries used from the table
+    int InitAttackTable(SlidingAttackInfo* infos, const BitBoard* masks, const BitBoard* magics, const int* indexBits, BitBoard* table, BitBoard (*getAttacks)(SquareIndex, BitBoard))
     {
+        int offset = 0;
         for (SquareIndex square = a1; square < FILE_MAX * RANK_MAX; square++)
         {
-            int maxBlockers = 1 << s_RookIndexBits[square];
+            SlidingAttackInfo& info = infos[square];
+            info.Attacks = table + offset;
+            info.Mask = masks[square];
+            info.Magic = magics[square];
+            info.Shift = 64 - indexBits[square];
+            BOX_ASSERT(info.Mask.GetCount() == indexBits[square], "Invalid index bits");
+            int maxBlockers = 1 << indexBits[square];
             for (int blockerIndex = 0; blockerIndex < maxBlockers; blockerIndex++)
             {
-                BitBoard blockers = GetBlockersFromIndex(blockerIndex, s_RookMasks[square]);
-                s_RookTable[square][(blockers.Board * s_RookMagics[square].Board) >> (int)(64 - s_RookIndexBits[square])] = GetRookAttacksSlow(square, blockers);
+                BitBoard blockers = GetBlockersFromIndex(blockerIndex, info.Mask);
+                info.Attacks[info.GetIndex(blockers)] = getAttacks(square, blockers);
             }
+            offset += maxBlockers;
         }
+        return offset;
     }
 
-    void InitBishopMagicTable()
+    void InitSlidingAttackTables()
     {
-        for (SquareIndex square = a1; square < FILE_MAX * RANK_MAX; square++)
-        {
-            int maxBlockers = 1 << s_BishopIndexBits[square];
-            for (int blockerIndex = 0; blockerIndex < maxBlockers; blockerIndex++)
-            {
-                BitBoard blockers = GetBlockersFromIndex(blockerIndex, s_BishopMasks[square]);
-                s_BishopTable[square][(blockers.Board * s_BishopMagics[square].Board) >> (int)(64 - s_BishopIndexBits[square])] = GetBishopAttacksSlow(square, blockers);
-            }
-        }
+        int rookEntries = InitAttackTable(s_RookAttackInfo, s_RookMasks, s_RookMagics, s_RookIndexBits, s_SlidingAttackTable, GetRookAttacksSlow);
+        int bishopEntries = InitAttackTable(s_BishopAttackInfo, s_BishopMasks, s_BishopMagics, s_BishopIndexBits, s_SlidingAttackTable + rookEntries, GetBishopAttacksSlow);
+        BOX_ASSERT(rookEntries == ROOK_TABLE_SIZE && bishopEntries == BISHOP_TABLE_SIZE, "Invalid sliding attack table size");
     }
 
     BitBoard s_Lines[FILE_MAX * RANK_MAX][FILE_MAX * RANK_MAX];
@@ -200,8 +210,7 @@ namespace Boxfish
             InitKingAttacks();
             InitRookMasks();
             InitBishopMasks();
-            InitRookMagicTable();
-            InitBishopMagicTable();
+            InitSlidingAttackTables();
             InitLines();
             s_Initialized = true;
         }
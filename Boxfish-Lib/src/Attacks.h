@@ -2,6 +2,10 @@
 #include "Bitboard.h"
 #include "Rays.h"
 
+#ifdef BOX_USE_PEXT
+#include <immintrin.h>
+#endif
+
 namespace Boxfish
 {
 
@@ -66,8 +70,29 @@ namespace Boxfish
     extern BitBoard s_BishopMasks[FILE_MAX * RANK_MAX];
     extern BitBoard s_RookMasks[FILE_MAX * RANK_MAX];
 
-    extern BitBoard s_RookTable[FILE_MAX * RANK_MAX][4096];
-    extern BitBoard s_BishopTable[FILE_MAX * RANK_MAX][1024];
+    // Everything needed to look up the attacks from one square, aligned so that a lookup touches a single cache line
+    // Attacks points into one table shared by every square and both piece types, sized 2^bits for each square
+    struct alignas(32) SlidingAttackInfo
+    {
+    public:
+        BitBoard* Attacks;
+        BitBoard Mask;
+        BitBoard Magic;
+        int Shift;
+
+    public:
+        inline size_t GetIndex(const BitBoard& blockers) const
+        {
+#ifdef BOX_USE_PEXT
+            return _pext_u64(blockers.Board, Mask.Board);
+#else
+            return ((blockers.Board & Mask.Board) * Magic.Board) >> Shift;
+#endif
+        }
+    };
+
+    extern SlidingAttackInfo s_RookAttackInfo[FILE_MAX * RANK_MAX];
+    extern SlidingAttackInfo s_BishopAttackInfo[FILE_MAX * RANK_MAX];
 
     void InitAttacks();
 
@@ -80,14 +105,14 @@ namespace Boxfish
 
     inline BitBoard GetBishopAttacks(SquareIndex squareIndex, BitBoard blockers)
     {
-        blockers &= s_BishopMasks[squareIndex];
-        return s_BishopTable[squareIndex][(blockers.Board * s_BishopMagics[squareIndex].Board) >> (64 - s_BishopIndexBits[squareIndex])];
+        const SlidingAttackInfo& info = s_BishopAttackInfo[squareIndex];
+        return info.Attacks[info.GetIndex(blockers)];
     }
 
     inline BitBoard GetRookAttacks(SquareIndex squareIndex, BitBoard blockers)
     {
-        blockers &= s_RookMasks[squareIndex];
-        return s_RookTable[squareIndex][(blockers.Board * s_RookMagics[squareIndex].Board) >> (64 - s_RookIndexBits[squareIndex])];
+        const SlidingAttackInfo& info = s_RookAttackInfo[squareIndex];
+        return info.Attacks[info.GetIndex(blockers)];
     }
 
     template<Piece PIECE>
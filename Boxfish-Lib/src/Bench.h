@@ -0,0 +1,28 @@
+#pragma once
+#include "Search.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+#ifdef SWIG
+#define BOX_API
+#endif
+
+namespace Boxfish
+{
+
+	struct BOX_API BenchResult
+	{
+	public:
+		size_t Nodes = 0;
+		std::chrono::nanoseconds Elapsed = std::chrono::nanoseconds(0);
+	};
+
+	// Fixed mix of opening, middlegame and endgame positions
+	const std::vector<std::string>& GetBenchPositions();
+
+	// Searches every bench position to a fixed depth, starting each from an empty transposition table and history.
+	// With a single thread the total node count is deterministic and changes only when the search does
+	BenchResult RunBench(int depth, int threads, size_t hashBytes, bool log = true);
+
+}
@@ -13,6 +13,7 @@ namespace Boxfish
 		InitRays();
 		InitAttacks();
 		InitEvaluation();
+		InitEndgames();
 		InitSearch();
 	}
 
@@ -10,9 +10,16 @@
 
 #include "Attacks.h"
 #include "MoveGenerator.h"
+#include "Perft.h"
+#include "PawnHashTable.h"
+#include "EvalHashTable.h"
 #include "Evaluation.h"
+#include "Endgame.h"
+#include "NNUE.h"
+#include "Tablebase.h"
 
 #include "Search.h"
+#include "Bench.h"
 #include "Format.h"
 #include "Settings.h"
 
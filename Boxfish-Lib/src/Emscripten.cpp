@@ -36,8 +36,7 @@ std::vector<Move> GenerateLegalMoves(const Position& position)
 	MoveList moves(buffer);
 
 	MoveGenerator generator(position);
-	generator.GetPseudoLegalMoves(moves);
-	generator.FilterLegalMoves(moves);
+	generator.GetLegalMoves(moves);
 
 	std::vector<Move> result;
 	result.reserve(moves.MoveCount);
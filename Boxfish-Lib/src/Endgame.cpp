@@ -0,0 +1,363 @@
+#include "Endgame.h"
+#include "Attacks.h"
+#include "Evaluation.h"
+#include "MoveGenerator.h"
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace Boxfish
+{
+
+	static std::unordered_map<uint64_t, EndgameEntry> s_Endgames;
+	static EndgameEntry s_KXK[TEAM_MAX];
+	static EndgameEntry s_KBPsK[TEAM_MAX];
+
+	// Every registered signature has at most this many pieces unless one side has a bare king
+	static constexpr int MAX_ENDGAME_PIECES = 4;
+
+	static constexpr int s_PushClose[8] = { 0, 0, 100, 80, 60, 40, 20, 10 };
+	static constexpr int s_PushAway[8] = { 0, 5, 20, 40, 60, 80, 90, 100 };
+
+	inline int Distance(SquareIndex a, SquareIndex b)
+	{
+		return std::max(std::abs(BitBoard::FileOfIndex(a) - BitBoard::FileOfIndex(b)), std::abs(BitBoard::RankOfIndex(a) - BitBoard::RankOfIndex(b)));
+	}
+
+	inline int PushToEdge(SquareIndex square)
+	{
+		int fileDistance = std::min<int>(BitBoard::FileOfIndex(square), FILE_H - BitBoard::FileOfIndex(square));
+		int rankDistance = std::min<int>(BitBoard::RankOfIndex(square), RANK_8 - BitBoard::RankOfIndex(square));
+		return 90 - (7 * fileDistance * fileDistance / 2 + 7 * rankDistance * rankDistance / 2);
+	}
+
+	// Largest on a1 and h8
+	inline int PushToCorner(SquareIndex square)
+	{
+		return std::abs(7 - BitBoard::RankOfIndex(square) - BitBoard::FileOfIndex(square));
+	}
+
+	inline SquareIndex FlipFile(SquareIndex square)
+	{
+		return (SquareIndex)(square ^ 7);
+	}
+
+	inline SquareIndex FlipRank(SquareIndex square)
+	{
+		return (SquareIndex)(square ^ 56);
+	}
+
+	inline bool IsBareKing(const Position& position, Team team)
+	{
+		return !MoreThanOne(position.GetTeamPieces(team));
+	}
+
+	// =================================================================================================================================
+	// KPK BITBASE
+	// =================================================================================================================================
+
+	// White has the pawn, which is always on files A-D and ranks 2-7
+	static constexpr int KPK_INDEX_MAX = 2 * 24 * SQUARE_MAX * SQUARE_MAX;
+	static uint32_t s_KPKBitbase[KPK_INDEX_MAX / 32];
+
+	enum KPKResult : uint8_t
+	{
+		KPK_INVALID = 0,
+		KPK_UNKNOWN = 1,
+		KPK_DRAW = 2,
+		KPK_WIN = 4
+	};
+
+	inline int KPKIndex(Team teamToPlay, SquareIndex blackKing, SquareIndex whiteKing, SquareIndex pawn)
+	{
+		return (int)teamToPlay | ((int)blackKing << 1) | ((int)whiteKing << 7) | (BitBoard::FileOfIndex(pawn) << 13) | ((RANK_7 - BitBoard::RankOfIndex(pawn)) << 15);
+	}
+
+	struct KPKPosition
+	{
+	public:
+		Team TeamToPlay;
+		SquareIndex Kings[TEAM_MAX];
+		SquareIndex Pawn;
+		uint8_t Result;
+	};
+
+	void InitKPKPosition(KPKPosition& position, int index)
+	{
+		position.TeamToPlay = Team(index & 1);
+		position.Kings[TEAM_BLACK] = SquareIndex((index >> 1) & 63);
+		position.Kings[TEAM_WHITE] = SquareIndex((index >> 7) & 63);
+		position.Pawn = BitBoard::SquareToBitIndex({ File((index >> 13) & 3), Rank(RANK_7 - ((index >> 15) & 7)) });
+
+		const SquareIndex promotion = SquareIndex(position.Pawn + FILE_MAX);
+		const BitBoard pawnAttacks = GetNonSlidingAttacks<PIECE_PAWN>(position.Pawn, TEAM_WHITE);
+		const BitBoard whiteKingAttacks = GetNonSlidingAttacks<PIECE_KING>(position.Kings[TEAM_WHITE]);
+		const BitBoard blackKingAttacks = GetNonSlidingAttacks<PIECE_KING>(position.Kings[TEAM_BLACK]);
+
+		if (Distance(position.Kings[TEAM_WHITE], position.Kings[TEAM_BLACK]) <= 1 || position.Kings[TEAM_WHITE] == position.Pawn || position.Kings[TEAM_BLACK] == position.Pawn
+			|| (position.TeamToPlay == TEAM_WHITE && (pawnAttacks & position.Kings[TEAM_BLACK])))
+			position.Result = KPK_INVALID;
+		// Promotes without being captured
+		else if (position.TeamToPlay == TEAM_WHITE && BitBoard::RankOfIndex(position.Pawn) == RANK_7 && position.Kings[TEAM_WHITE] != promotion
+			&& (Distance(position.Kings[TEAM_BLACK], promotion) > 1 || (whiteKingAttacks & promotion)))
+			position.Result = KPK_WIN;
+		// Stalemate or the pawn can be captured
+		else if (position.TeamToPlay == TEAM_BLACK && (!(blackKingAttacks & ~(whiteKingAttacks | pawnAttacks)) || (blackKingAttacks & position.Pawn & ~whiteKingAttacks)))
+			position.Result = KPK_DRAW;
+		else
+			position.Result = KPK_UNKNOWN;
+	}
+
+	uint8_t ClassifyKPKPosition(const std::vector<KPKPosition>& database, KPKPosition& position)
+	{
+		// White wins if any move wins, black draws if any move draws
+		const uint8_t good = (position.TeamToPlay == TEAM_WHITE) ? KPK_WIN : KPK_DRAW;
+		const uint8_t bad = (position.TeamToPlay == TEAM_WHITE) ? KPK_DRAW : KPK_WIN;
+		const Team otherTeam = OtherTeam(position.TeamToPlay);
+
+		uint8_t result = KPK_INVALID;
+		BitBoard kingMoves = GetNonSlidingAttacks<PIECE_KING>(position.Kings[position.TeamToPlay]);
+		while (kingMoves)
+		{
+			SquareIndex square = PopLeastSignificantBit(kingMoves);
+			result |= (position.TeamToPlay == TEAM_WHITE)
+				? database[KPKIndex(otherTeam, position.Kings[TEAM_BLACK], square, position.Pawn)].Result
+				: database[KPKIndex(otherTeam, square, position.Kings[TEAM_WHITE], position.Pawn)].Result;
+		}
+
+		if (position.TeamToPlay == TEAM_WHITE)
+		{
+			const SquareIndex push = SquareIndex(position.Pawn + FILE_MAX);
+			if (BitBoard::RankOfIndex(position.Pawn) < RANK_7)
+				result |= database[KPKIndex(otherTeam, position.Kings[TEAM_BLACK], position.Kings[TEAM_WHITE], push)].Result;
+			if (BitBoard::RankOfIndex(position.Pawn) == RANK_2 && push != position.Kings[TEAM_WHITE] && push != position.Kings[TEAM_BLACK])
+				result |= database[KPKIndex(otherTeam, position.Kings[TEAM_BLACK], position.Kings[TEAM_WHITE], SquareIndex(push + FILE_MAX))].Result;
+		}
+
+		position.Result = (result & good) ? good : (result & KPK_UNKNOWN) ? KPK_UNKNOWN : bad;
+		return position.Result;
+	}
+
+	void InitKPKBitbase()
+	{
+		std::vector<KPKPosition> database(KPK_INDEX_MAX);
+		for (int index = 0; index < KPK_INDEX_MAX; index++)
+			InitKPKPosition(database[index], index);
+
+		// Propagate results backwards until nothing changes, the remaining unknown positions are draws
+		bool changed = true;
+		while (changed)
+		{
+			changed = false;
+			for (KPKPosition& position : database)
+			{
+				if (position.Result == KPK_UNKNOWN && ClassifyKPKPosition(database, position) != KPK_UNKNOWN)
+					changed = true;
+			}
+		}
+
+		memset(s_KPKBitbase, 0, sizeof(s_KPKBitbase));
+		for (int index = 0; index < KPK_INDEX_MAX; index++)
+		{
+			if (database[index].Result == KPK_WIN)
+				s_KPKBitbase[index / 32] |= 1u << (index & 31);
+		}
+	}
+
+	bool ProbeKPK(const Position& position, Team strongTeam)
+	{
+		SquareIndex strongKing = position.GetKingSquare(strongTeam);
+		SquareIndex weakKing = position.GetKingSquare(OtherTeam(strongTeam));
+		SquareIndex pawn = ForwardBitScan(position.GetTeamPieces(strongTeam, PIECE_PAWN));
+		if (strongTeam == TEAM_BLACK)
+		{
+			strongKing = FlipRank(strongKing);
+			weakKing = FlipRank(weakKing);
+			pawn = FlipRank(pawn);
+		}
+		if (BitBoard::FileOfIndex(pawn) >= FILE_E)
+		{
+			strongKing = FlipFile(strongKing);
+			weakKing = FlipFile(weakKing);
+			pawn = FlipFile(pawn);
+		}
+		const Team teamToPlay = (position.TeamToPlay == strongTeam) ? TEAM_WHITE : TEAM_BLACK;
+		const int index = KPKIndex(teamToPlay, weakKing, strongKing, pawn);
+		return s_KPKBitbase[index / 32] & (1u << (index & 31));
+	}
+
+	// =================================================================================================================================
+	// VALUE FUNCTIONS
+	// =================================================================================================================================
+
+	// Any mating material against a bare king
+	ValueType EvaluateKXK(const Position& position, Team strongTeam)
+	{
+		const Team weakTeam = OtherTeam(strongTeam);
+		const SquareIndex strongKing = position.GetKingSquare(strongTeam);
+		const SquareIndex weakKing = position.GetKingSquare(weakTeam);
+
+		if (position.TeamToPlay == weakTeam && !position.InCheck(weakTeam))
+		{
+			Move moves[MAX_MOVES];
+			MoveList list(nullptr, moves);
+			MoveGenerator generator(position);
+			generator.GetLegalMoves(list);
+			if (list.MoveCount == 0)
+				return SCORE_DRAW;
+		}
+
+		ValueType result = position.GetNonPawnMaterial(strongTeam) + position.GetTeamPieces(strongTeam, PIECE_PAWN).GetCount() * GetPieceValue(PIECE_PAWN, ENDGAME);
+		result += PushToEdge(weakKing) + s_PushClose[Distance(strongKing, weakKing)];
+
+		const BitBoard bishops = position.GetTeamPieces(strongTeam, PIECE_BISHOP);
+		if (position.GetTeamPieces(strongTeam, PIECE_QUEEN, PIECE_ROOK) || (bishops && position.GetTeamPieces(strongTeam, PIECE_KNIGHT))
+			|| ((bishops & DARK_SQUARES_MASK) && (bishops & LIGHT_SQUARES_MASK)))
+			result += SCORE_KNOWN_WIN;
+		return result;
+	}
+
+	ValueType EvaluateKPK(const Position& position, Team strongTeam)
+	{
+		if (!ProbeKPK(position, strongTeam))
+			return SCORE_DRAW;
+		const SquareIndex pawn = ForwardBitScan(position.GetTeamPieces(strongTeam, PIECE_PAWN));
+		return SCORE_KNOWN_WIN + GetPieceValue(PIECE_PAWN, ENDGAME) + RelativeRank(strongTeam, BitBoard::RankOfIndex(pawn));
+	}
+
+	// Mate can only be forced in a corner the bishop controls
+	ValueType EvaluateKBNK(const Position& position, Team strongTeam)
+	{
+		const SquareIndex strongKing = position.GetKingSquare(strongTeam);
+		SquareIndex weakKing = position.GetKingSquare(OtherTeam(strongTeam));
+		// a1 and h8 are dark
+		if (!(position.GetTeamPieces(strongTeam, PIECE_BISHOP) & DARK_SQUARES_MASK))
+			weakKing = FlipFile(weakKing);
+		return SCORE_KNOWN_WIN + s_PushClose[Distance(strongKing, weakKing)] + 30 * PushToCorner(weakKing);
+	}
+
+	ValueType EvaluateKNNK(const Position& position, Team strongTeam)
+	{
+		return SCORE_DRAW;
+	}
+
+	// Drawish, but the weaker side should stay away from the edge
+	ValueType EvaluateKRKB(const Position& position, Team strongTeam)
+	{
+		return PushToEdge(position.GetKingSquare(OtherTeam(strongTeam)));
+	}
+
+	// Drawish, but the knight should stay close to its king
+	ValueType EvaluateKRKN(const Position& position, Team strongTeam)
+	{
+		const Team weakTeam = OtherTeam(strongTeam);
+		const SquareIndex weakKing = position.GetKingSquare(weakTeam);
+		const SquareIndex knight = ForwardBitScan(position.GetTeamPieces(weakTeam, PIECE_KNIGHT));
+		return PushToEdge(weakKing) + s_PushAway[Distance(weakKing, knight)];
+	}
+
+	// =================================================================================================================================
+	// SCALE FUNCTIONS
+	// =================================================================================================================================
+
+	// Bishop and rook pawns on one file cannot win if the bishop does not control the promotion square and the king defends it
+	int ScaleKBPsK(const Position& position, Team strongTeam)
+	{
+		const BitBoard pawns = position.GetTeamPieces(strongTeam, PIECE_PAWN);
+		const File pawnFile = BitBoard::FileOfIndex(ForwardBitScan(pawns));
+		if ((pawnFile == FILE_A || pawnFile == FILE_H) && !(pawns & ~FILE_MASKS[pawnFile]))
+		{
+			const SquareIndex promotion = BitBoard::SquareToBitIndex({ pawnFile, RelativeRank(strongTeam, RANK_8) });
+			const bool darkBishop = position.GetTeamPieces(strongTeam, PIECE_BISHOP) & DARK_SQUARES_MASK;
+			const bool darkPromotion = DARK_SQUARES_MASK & promotion;
+			if (darkBishop != darkPromotion && Distance(position.GetKingSquare(OtherTeam(strongTeam)), promotion) <= 1)
+				return SCALE_FACTOR_DRAW;
+		}
+		return SCALE_FACTOR_NORMAL;
+	}
+
+	// =================================================================================================================================
+	// REGISTRY
+	// =================================================================================================================================
+
+	uint64_t CreateMaterialKey(const std::string& signature, Team strongTeam)
+	{
+		uint64_t key = 0;
+		Team team = OtherTeam(strongTeam);
+		for (char c : signature)
+		{
+			Piece piece = PIECE_INVALID;
+			switch (c)
+			{
+			case 'P': piece = PIECE_PAWN; break;
+			case 'N': piece = PIECE_KNIGHT; break;
+			case 'B': piece = PIECE_BISHOP; break;
+			case 'R': piece = PIECE_ROOK; break;
+			case 'Q': piece = PIECE_QUEEN; break;
+			case 'K': piece = PIECE_KING; team = OtherTeam(team); break;
+			}
+			BOX_ASSERT(piece != PIECE_INVALID, "Invalid signature");
+			key += GetMaterialKeyIncrement(team, piece);
+		}
+		return key;
+	}
+
+	void AddEndgame(const std::string& signature, EndgameValueFunction function)
+	{
+		for (Team team : { TEAM_WHITE, TEAM_BLACK })
+		{
+			EndgameEntry entry;
+			entry.Value = function;
+			entry.StrongTeam = team;
+			s_Endgames[CreateMaterialKey(signature, team)] = entry;
+		}
+	}
+
+	void InitEndgames()
+	{
+		InitKPKBitbase();
+
+		s_Endgames.clear();
+		AddEndgame("KPK", EvaluateKPK);
+		AddEndgame("KBNK", EvaluateKBNK);
+		AddEndgame("KNNK", EvaluateKNNK);
+		AddEndgame("KRKB", EvaluateKRKB);
+		AddEndgame("KRKN", EvaluateKRKN);
+
+		for (Team team : { TEAM_WHITE, TEAM_BLACK })
+		{
+			s_KXK[team].Value = EvaluateKXK;
+			s_KXK[team].StrongTeam = team;
+			s_KBPsK[team].Scale = ScaleKBPsK;
+			s_KBPsK[team].StrongTeam = team;
+		}
+	}
+
+	const EndgameEntry* ProbeEndgame(const Position& position)
+	{
+		const bool bareKing[TEAM_MAX] = { IsBareKing(position, TEAM_WHITE), IsBareKing(position, TEAM_BLACK) };
+		if (!bareKing[TEAM_WHITE] && !bareKing[TEAM_BLACK])
+		{
+			if (position.GetAllPieces().GetCount() > MAX_ENDGAME_PIECES)
+				return nullptr;
+		}
+
+		auto it = s_Endgames.find(position.GetMaterialKey());
+		if (it != s_Endgames.end())
+			return &it->second;
+
+		for (Team team : { TEAM_WHITE, TEAM_BLACK })
+		{
+			if (!bareKing[OtherTeam(team)] || bareKing[team])
+				continue;
+			if (position.GetNonPawnMaterial(team) >= GetPieceValue(PIECE_ROOK, MIDGAME))
+				return &s_KXK[team];
+			const BitBoard bishops = position.GetTeamPieces(team, PIECE_BISHOP);
+			if (bishops && !MoreThanOne(bishops) && position.GetTeamPieces(team, PIECE_PAWN)
+				&& position.GetTeamPieces(team) == position.GetTeamPieces(team, PIECE_KING, PIECE_BISHOP, PIECE_PAWN))
+				return &s_KBPsK[team];
+		}
+		return nullptr;
+	}
+
+}
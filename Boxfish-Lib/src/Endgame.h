@@ -0,0 +1,43 @@
+#pragma once
+#include "Position.h"
+#include <string>
+
+#ifdef SWIG
+#define BOX_API
+#endif
+
+namespace Boxfish
+{
+
+	// Returned by specialized evaluators for positions that are won with correct play
+	constexpr ValueType SCORE_KNOWN_WIN = 10000;
+
+	// Scale factors are applied to the endgame half of the evaluation
+	constexpr int SCALE_FACTOR_DRAW = 0;
+	constexpr int SCALE_FACTOR_NORMAL = 64;
+
+	// Both return values relative to strongTeam
+	using EndgameValueFunction = ValueType(*)(const Position& position, Team strongTeam);
+	using EndgameScaleFunction = int(*)(const Position& position, Team strongTeam);
+
+	// At most one of Value and Scale is set, Value replaces the whole evaluation
+	struct BOX_API EndgameEntry
+	{
+	public:
+		EndgameValueFunction Value = nullptr;
+		EndgameScaleFunction Scale = nullptr;
+		Team StrongTeam = TEAM_WHITE;
+	};
+
+	void InitEndgames();
+
+	// Material key of a signature such as "KBNK", the pieces before the second king belong to strongTeam
+	uint64_t CreateMaterialKey(const std::string& signature, Team strongTeam);
+
+	// Returns nullptr if there is no specialized evaluator for the material on the board
+	const EndgameEntry* ProbeEndgame(const Position& position);
+
+	// King and pawn vs king bitbase, true if the side with the pawn wins
+	bool ProbeKPK(const Position& position, Team strongTeam);
+
+}
@@ -0,0 +1,18 @@
+#include "EvalHashTable.h"
+#include <cstring>
+
+namespace Boxfish
+{
+
+	EvalHashTable::EvalHashTable()
+		: m_Entries(std::make_unique<EvalHashEntry[]>(ENTRY_COUNT))
+	{
+		Clear();
+	}
+
+	void EvalHashTable::Clear()
+	{
+		std::memset(m_Entries.get(), 0, ENTRY_COUNT * sizeof(EvalHashEntry));
+	}
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include "Position.h"
+#include <memory>
+
+#ifdef SWIG
+#define BOX_API
+#endif
+
+namespace Boxfish
+{
+
+	// Static evaluation of a position from the perspective of the team to play
+	struct BOX_API EvalHashEntry
+	{
+	public:
+		uint64_t Key;
+		ValueType Score;
+	};
+
+	// Small per thread cache indexed by Position::Hash, entries are always replaced
+	class BOX_API EvalHashTable
+	{
+	public:
+		static constexpr size_t ENTRY_COUNT = 1 << 16;
+
+	private:
+		std::unique_ptr<EvalHashEntry[]> m_Entries;
+
+	public:
+		EvalHashTable();
+
+		inline EvalHashEntry* GetEntry(const ZobristHash& hash) const
+		{
+			return &m_Entries[hash.Hash & (ENTRY_COUNT - 1)];
+		}
+
+		void Clear();
+	};
+
+}
@@ -41,13 +41,15 @@ namespace Boxfish
 		return (team == TEAM_WHITE) ? whiteSquare : s_OppositeSquare[whiteSquare];
 	}
 
-	static int s_PhaseWeights[PIECE_MAX];
+	int s_PhaseWeights[PIECE_MAX];
 	int s_MaxPhaseValue = 0;
 
 	static int s_DistanceTable[SQUARE_MAX][SQUARE_MAX];
 
 	static ValueType s_MaterialValues[GAME_STAGE_MAX][PIECE_MAX];
-	static ValueType s_PieceSquareTables[GAME_STAGE_MAX][TEAM_MAX][PIECE_MAX][SQUARE_MAX];
+	static ValueType s_PieceSquareValues[GAME_STAGE_MAX][TEAM_MAX][PIECE_MAX][SQUARE_MAX];
+	static Score s_PieceSquareTables[TEAM_MAX][PIECE_MAX][SQUARE_MAX];
+	Score s_PieceScores[TEAM_MAX][PIECE_MAX][SQUARE_MAX];
 
 	static constexpr ValueType s_KnightAdjust[9] = { -20, -16, -12, -8, -4, 0, 4, 8, 12 };
 	static constexpr ValueType s_RookAdjust[9] = { 15, 12, 9, 6, 3, 0, -3, -6, -9 };
@@ -254,10 +256,10 @@ namespace Boxfish
 			 5, 10, 10,-10,-10, 10,  5,  5,
 			 0,  0,  0,  0,  0,  0,  0,  0
 		};
-		MirrorTable(s_PieceSquareTables[MIDGAME][TEAM_WHITE][PIECE_PAWN], whitePawnsTable);
-		MirrorTable(s_PieceSquareTables[MIDGAME][TEAM_BLACK][PIECE_PAWN], s_PieceSquareTables[MIDGAME][TEAM_WHITE][PIECE_PAWN]);
-		MirrorTable(s_PieceSquareTables[ENDGAME][TEAM_WHITE][PIECE_PAWN], s_PieceSquareTables[MIDGAME][TEAM_BLACK][PIECE_PAWN]);
-		MirrorTable(s_PieceSquareTables[ENDGAME][TEAM_BLACK][PIECE_PAWN], s_PieceSquareTables[MIDGAME][TEAM_WHITE][PIECE_PAWN]);
+		MirrorTable(s_PieceSquareValues[MIDGAME][TEAM_WHITE][PIECE_PAWN], whitePawnsTable);
+		MirrorTable(s_PieceSquareValues[MIDGAME][TEAM_BLACK][PIECE_PAWN], s_PieceSquareValues[MIDGAME][TEAM_WHITE][PIECE_PAWN]);
+		MirrorTable(s_PieceSquareValues[ENDGAME][TEAM_WHITE][PIECE_PAWN], s_PieceSquareValues[MIDGAME][TEAM_BLACK][PIECE_PAWN]);
+		MirrorTable(s_PieceSquareValues[ENDGAME][TEAM_BLACK][PIECE_PAWN], s_PieceSquareValues[MIDGAME][TEAM_WHITE][PIECE_PAWN]);
 
 		ValueType whiteKnightsTable[SQUARE_MAX] = {
 			-50,-40,-30,-30,-30,-30,-40,-50,
@@ -269,10 +271,10 @@ namespace Boxfish
 			-40,  0,  0,  5,  5,  0,  0,-40,
 			-50,-40,-30,-30,-30,-30,-40,-50,
 		};
-		MirrorTable(s_PieceSquareTables[MIDGAME][TEAM_WHITE][PIECE_KNIGHT], whiteKnightsTable);
-		MirrorTable(s_PieceSquareTables[MIDGAME][TEAM_BLACK][PIECE_KNIGHT], s_PieceSquareTables[MIDGAME][TEAM_WHITE][PIECE_KNIGHT]);
-		MirrorTable(s_PieceSquareTables[ENDGAME][TEAM_WHITE][PIECE_KNIGHT], s_PieceSquareTables[MIDGAME][TEAM_BLACK][PIECE_KNIGHT]);
-		MirrorTable(s_PieceSquareTables[ENDGAME][TEAM_BLACK][PIECE_KNIGHT], s_PieceSquareTables[MIDGAME][TEAM_WHITE][PIECE_KNIGHT]);
+		MirrorTable(s_PieceSquareValues[MIDGAME][TEAM_WHITE][PIECE_KNIGHT], whiteKnightsTable);
+		MirrorTable(s_PieceSquareValues[MIDGAME][TEAM_BLACK][PIECE_KNIGHT], s_PieceSquareValues[MIDGAME][TEAM_WHITE][PIECE_KNIGHT]);
+		MirrorTable(s_PieceSquareValues[ENDGAME][TEAM_WHITE][PIECE_KNIGHT], s_PieceSquareValues[MIDGAME][TEAM_BLACK][PIECE_KNIGHT]);
+		MirrorTable(s_PieceSquareValues[ENDGAME][TEAM_BLACK][PIECE_KNIGHT], s_PieceSquareValues[MIDGAME][TEAM_WHITE][PIECE_KNIGHT]);
 
 		ValueType whiteBishopsTable[SQUARE_MAX] = {
 			-20,-10,-10,-10,-10,-10,-10,-20,
@@ -284,10 +286,10 @@ namespace Boxfish
 			-10, 15, 10,  5,  5, 10, 15,-10,
 			-20,-10,-10,-10,-10,-10,-10,-20,
 		};
-		MirrorTable(s_PieceSquareTables[MIDGAME][TEAM_WHITE][PIECE_BISHOP], whiteBishopsTable);
-		MirrorTable(s_PieceSquareTables[MIDGAME][TEAM_BLACK][PIECE_BISHOP], s_PieceSquareTables[MIDGAME][TEAM_WHITE][PIECE_BISHOP]);
-		MirrorTable(s_PieceSquareTables[ENDGAME][TEAM_WHITE][PIECE_BISHOP], s_PieceSquareTables[MIDGAME][TEAM_BLACK][PIECE_BISHOP]);
-		MirrorTable(s_PieceSquareTables[ENDGAME][TEAM_BLACK][PIECE_BISHOP], s_PieceSquareTables[MIDGAME][TEAM_WHITE][PIECE_BISHOP]);
+		MirrorTable(s_PieceSquareValues[MIDGAME][TEAM_WHITE][PIECE_BISHOP], whiteBishopsTable);
+		MirrorTable(s_PieceSquareValues[MIDGAME][TEAM_BLACK][PIECE_BISHOP], s_PieceSquareValues[MIDGAME][TEAM_WHITE][PIECE_BISHOP]);
+		MirrorTable(s_PieceSquareValues[ENDGAME][TEAM_WHITE][PIECE_BISHOP], s_PieceSquareValues[MIDGAME][TEAM_BLACK][PIECE_BISHOP]);
+		MirrorTable(s_PieceSquareValues[ENDGAME][TEAM_BLACK][PIECE_BISHOP], s_PieceSquareValues[MIDGAME][TEAM_WHITE][PIECE_BISHOP]);
 
 		ValueType whiteRooksTable[SQUARE_MAX] = {
 			  0,  0,  0,  0,  0,  0,  0,  0,
@@ -299,10 +301,10 @@ namespace Boxfish
 			 -5,  0,  0,  0,  0,  0,  0, -5,
 			  0,  0,  0,  5,  5,  0,  0,  0
 		};
-		MirrorTable(s_PieceSquareTables[MIDGAME][TEAM_WHITE][PIECE_ROOK], whiteRooksTable);
-		MirrorTable(s_PieceSquareTables[MIDGAME][TEAM_BLACK][PIECE_ROOK], s_PieceSquareTables[MIDGAME][TEAM_WHITE][PIECE_ROOK]);
-		MirrorTable(s_PieceSquareTables[ENDGAME][TEAM_WHITE][PIECE_ROOK], s_PieceSquareTables[MIDGAME][TEAM_BLACK][PIECE_ROOK]);
-		MirrorTable(s_PieceSquareTables[ENDGAME][TEAM_BLACK][PIECE_ROOK], s_PieceSquareTables[MIDGAME][TEAM_WHITE][PIECE_ROOK]);
+		MirrorTable(s_PieceSquareValues[MIDGAME][TEAM_WHITE][PIECE_ROOK], whiteRooksTable);
+		MirrorTable(s_PieceSquareValues[MIDGAME][TEAM_BLACK][PIECE_ROOK], s_PieceSquareValues[MIDGAME][TEAM_WHITE][PIECE_ROOK]);
+		MirrorTable(s_PieceSquareValues[ENDGAME][TEAM_WHITE][PIECE_ROOK], s_PieceSquareValues[MIDGAME][TEAM_BLACK][PIECE_ROOK]);
+		MirrorTable(s_PieceSquareValues[ENDGAME][TEAM_BLACK][PIECE_ROOK], s_PieceSquareValues[MIDGAME][TEAM_WHITE][PIECE_ROOK]);
 
 		ValueType whiteQueensTable[SQUARE_MAX] = {
 			-20,-10,-10, -5, -5,-10,-10,-20,
@@ -314,10 +316,10 @@ namespace Boxfish
 			-10,  0,  5,  0,  0,  0,  0,-10,
 			-20,-10,-10, -5, -5,-10,-10,-20
 		};
-		MirrorTable(s_PieceSquareTables[MIDGAME][TEAM_WHITE][PIECE_QUEEN], whiteQueensTable);
-		MirrorTable(s_PieceSquareTables[MIDGAME][TEAM_BLACK][PIECE_QUEEN], s_PieceSquareTables[MIDGAME][TEAM_WHITE][PIECE_QUEEN]);
-		MirrorTable(s_PieceSquareTables[ENDGAME][TEAM_WHITE][PIECE_QUEEN], s_PieceSquareTables[MIDGAME][TEAM_BLACK][PIECE_QUEEN]);
-		MirrorTable(s_PieceSquareTables[ENDGAME][TEAM_BLACK][PIECE_QUEEN], s_PieceSquareTables[MIDGAME][TEAM_WHITE][PIECE_QUEEN]);
+		MirrorTable(s_PieceSquareValues[MIDGAME][TEAM_WHITE][PIECE_QUEEN], whiteQueensTable);
+		MirrorTable(s_PieceSquareValues[MIDGAME][TEAM_BLACK][PIECE_QUEEN], s_PieceSquareValues[MIDGAME][TEAM_WHITE][PIECE_QUEEN]);
+		MirrorTable(s_PieceSquareValues[ENDGAME][TEAM_WHITE][PIECE_QUEEN], s_PieceSquareValues[MIDGAME][TEAM_BLACK][PIECE_QUEEN]);
+		MirrorTable(s_PieceSquareValues[ENDGAME][TEAM_BLACK][PIECE_QUEEN], s_PieceSquareValues[MIDGAME][TEAM_WHITE][PIECE_QUEEN]);
 
 		ValueType whiteKingsTableMidgame[SQUARE_MAX] = {
 			-30,-40,-40,-50,-50,-40,-40,-30,
@@ -329,8 +331,8 @@ namespace Boxfish
 			 20, 20,  0,  0,  0,  0, 20, 20,
 			 20, 30, 10,  0,  0, 10, 30, 20
 		};
-		MirrorTable(s_PieceSquareTables[MIDGAME][TEAM_WHITE][PIECE_KING], whiteKingsTableMidgame);
-		MirrorTable(s_PieceSquareTables[MIDGAME][TEAM_BLACK][PIECE_KING], s_PieceSquareTables[MIDGAME][TEAM_WHITE][PIECE_KING]);
+		MirrorTable(s_PieceSquareValues[MIDGAME][TEAM_WHITE][PIECE_KING], whiteKingsTableMidgame);
+		MirrorTable(s_PieceSquareValues[MIDGAME][TEAM_BLACK][PIECE_KING], s_PieceSquareValues[MIDGAME][TEAM_WHITE][PIECE_KING]);
 
 		ValueType whiteKingsTableEndgame[SQUARE_MAX] = {
 			-50,-40,-30,-20,-20,-30,-40,-50,
@@ -342,8 +344,25 @@ namespace Boxfish
 			-30,-30,  0,  0,  0,  0,-30,-30,
 			-50,-30,-30,-30,-30,-30,-30,-50
 		};
-		MirrorTable(s_PieceSquareTables[ENDGAME][TEAM_WHITE][PIECE_KING], whiteKingsTableEndgame);
-		MirrorTable(s_PieceSquareTables[ENDGAME][TEAM_BLACK][PIECE_KING], s_PieceSquareTables[ENDGAME][TEAM_WHITE][PIECE_KING]);
+		MirrorTable(s_PieceSquareValues[ENDGAME][TEAM_WHITE][PIECE_KING], whiteKingsTableEndgame);
+		MirrorTable(s_PieceSquareValues[ENDGAME][TEAM_BLACK][PIECE_KING], s_PieceSquareValues[ENDGAME][TEAM_WHITE][PIECE_KING]);
+	
+		for (Team team : { TEAM_WHITE, TEAM_BLACK })
+		{
+			for (Piece piece = PIECE_PAWN; piece < PIECE_MAX; piece++)
+			{
+				for (SquareIndex square = a1; square < SQUARE_MAX; square++)
+				{
+					s_PieceSquareTables[team][piece][square] = MakeScore(s_PieceSquareValues[MIDGAME][team][piece][square], s_PieceSquareValues[ENDGAME][team][piece][square]);
+					Score score = SCORE_ZERO;
+					if (UseMaterial && piece != PIECE_KING)
+						score += MakeScore(s_MaterialValues[MIDGAME][piece], s_MaterialValues[ENDGAME][piece]);
+					if (UsePieceSquares)
+						score += s_PieceSquareTables[team][piece][square];
+					s_PieceScores[team][piece][square] = score;
+				}
+			}
+		}
 	}
 
 	void InitDistanceTable()
@@ -390,17 +409,15 @@ namespace Boxfish
 
 	int CalculateGameStage(const Position& position)
 	{
-		int phase = 0;
-		// Pawns and kings aren't included
-		for (Piece piece = PIECE_KNIGHT; piece < PIECE_KING; piece++)
-		{
-			BitBoard pieceBoard = position.GetPieces(piece);
-			phase += pieceBoard.GetCount() * s_PhaseWeights[piece];
-		}
-		phase = std::min(s_MaxPhaseValue, phase);
+		int phase = std::min(s_MaxPhaseValue, position.GetPhase());
 		return s_MaxPhaseValue - phase;
 	}
 
+	inline ValueType GetEndgameMaterial(const Position& position, Team team)
+	{
+		return position.GetTeamPieces(team, PIECE_PAWN).GetCount() * s_MaterialValues[ENDGAME][PIECE_PAWN] + position.GetNonPawnMaterial(team);
+	}
+
 	template<Team TEAM>
 	BitBoard CalculateKingAttackRegion(const Position& position)
 	{
@@ -430,169 +447,148 @@ namespace Boxfish
 	// EVALUATION FUNCTIONS
 	// =================================================================================================================================
 
-	template<Team TEAM>
-	int EvaluateMaterial(EvaluationResult& result, const Position& position)
+	template<Team TEAM, bool TRACE>
+	void EvaluateMaterial(EvaluationResult& result, const Position& position)
 	{
 		if constexpr (UseMaterial)
 		{
 			int pawnCount = position.GetTeamPieces(TEAM, PIECE_PAWN).GetCount();
-			result.Material[MIDGAME][TEAM] = pawnCount * s_MaterialValues[MIDGAME][PIECE_PAWN] + position.GetNonPawnMaterial(TEAM);
-			result.Material[ENDGAME][TEAM] = pawnCount * s_MaterialValues[ENDGAME][PIECE_PAWN] + position.GetNonPawnMaterial(TEAM);
-			return pawnCount;
-		}
-		else
-		{
-			result.Material[MIDGAME][TEAM] = 0;
-			result.Material[ENDGAME][TEAM] = 0;
-			return 1;
+			ValueType mg = pawnCount * s_MaterialValues[MIDGAME][PIECE_PAWN] + position.GetNonPawnMaterial(TEAM);
+			ValueType eg = GetEndgameMaterial(position, TEAM);
+			result.AddTerm<TRACE>(TERM_MATERIAL, TEAM, MakeScore(mg, eg));
 		}
 	}
 
+	template<bool TRACE>
 	void EvaluateMaterial(EvaluationResult& result, const Position& position)
 	{
-		int whitePawnCount = EvaluateMaterial<TEAM_WHITE>(result, position);
-		int blackPawnCount = EvaluateMaterial<TEAM_BLACK>(result, position);
+		EvaluateMaterial<TEAM_WHITE, TRACE>(result, position);
+		EvaluateMaterial<TEAM_BLACK, TRACE>(result, position);
+	}
+
+	void EvaluateMaterialDraw(EvaluationResult& result, const Position& position)
+	{
+		ValueType whiteMaterial = GetEndgameMaterial(position, TEAM_WHITE);
+		ValueType blackMaterial = GetEndgameMaterial(position, TEAM_BLACK);
+		bool whiteHasPawns = position.GetTeamPieces(TEAM_WHITE, PIECE_PAWN) != ZERO_BB;
+		bool blackHasPawns = position.GetTeamPieces(TEAM_BLACK, PIECE_PAWN) != ZERO_BB;
 
 		// Draw if only 1 minor piece
-		if (result.Material[ENDGAME][TEAM_WHITE] > result.Material[ENDGAME][TEAM_BLACK] && whitePawnCount == 0)
+		if (whiteMaterial > blackMaterial && !whiteHasPawns)
 		{
 			result.IsDraw = position.GetNonPawnMaterial(TEAM_WHITE) < GetPieceValue(PIECE_ROOK, MIDGAME);
 		}
-		else if (result.Material[ENDGAME][TEAM_BLACK] > result.Material[ENDGAME][TEAM_WHITE] && blackPawnCount == 0)
+		else if (blackMaterial > whiteMaterial && !blackHasPawns)
 		{
 			result.IsDraw = position.GetNonPawnMaterial(TEAM_BLACK) < GetPieceValue(PIECE_ROOK, MIDGAME);
 		}
 		// King vs King
-		else if (result.Material[ENDGAME][TEAM_WHITE] == 0 && result.Material[ENDGAME][TEAM_BLACK] == 0)
+		else if (whiteMaterial == 0 && blackMaterial == 0)
 		{
 			result.IsDraw = true;
 		}
 	}
 
-	template<Team TEAM>
+	template<Team TEAM, bool TRACE>
 	void EvaluatePieceSquareTables(EvaluationResult& result, const Position& position)
 	{
 		if constexpr (UsePieceSquares)
 		{
-			ValueType mg = 0;
-			ValueType eg = 0;
-			// Other pieces handled by piece evaluation
-			for (Piece piece : { PIECE_PAWN, PIECE_KING })
+			Score score = SCORE_ZERO;
+			for (Piece piece = PIECE_PAWN; piece < PIECE_MAX; piece++)
 			{
 				BitBoard pieces = position.GetTeamPieces(TEAM, piece);
 				while (pieces)
 				{
 					SquareIndex square = PopLeastSignificantBit(pieces);
-					mg += s_PieceSquareTables[MIDGAME][TEAM][piece][square];
-					eg += s_PieceSquareTables[ENDGAME][TEAM][piece][square];
+					score += s_PieceSquareTables[TEAM][piece][square];
 				}
 			}
-			result.PieceSquares[MIDGAME][TEAM] = mg;
-			result.PieceSquares[ENDGAME][TEAM] = eg;
-		}
-		else
-		{
-			result.PieceSquares[MIDGAME][TEAM] = 0;
-			result.PieceSquares[ENDGAME][TEAM] = 0;
+			result.AddTerm<TRACE>(TERM_PIECE_SQUARES, TEAM, score);
 		}
 	}
 
+	template<bool TRACE>
 	void EvaluatePieceSquareTables(EvaluationResult& result, const Position& position)
 	{
-		EvaluatePieceSquareTables<TEAM_WHITE>(result, position);
-		EvaluatePieceSquareTables<TEAM_BLACK>(result, position);
+		EvaluatePieceSquareTables<TEAM_WHITE, TRACE>(result, position);
+		EvaluatePieceSquareTables<TEAM_BLACK, TRACE>(result, position);
 	}
 
-	template<Team TEAM>
+	template<Team TEAM, bool TRACE>
 	void EvaluateBlockedPieces(EvaluationResult& result, const Position& position)
 	{
 		if constexpr (UseBlockedPieces)
 		{
 			constexpr Team OTHER_TEAM = OtherTeam(TEAM);
-			ValueType mg = 0;
-			ValueType eg = 0;
+			Score score = SCORE_ZERO;
 
-			constexpr ValueType TRAPPED_BISHOP_A8[GAME_STAGE_MAX] = { -150, -50 };
-			constexpr ValueType TRAPPED_BISHOP_A7[GAME_STAGE_MAX] = { -100, -50 };
-			constexpr ValueType TRAPPED_BISHOP_A6[GAME_STAGE_MAX] = { -50, -50 };
-			constexpr ValueType TRAPPED_BISHOP_B8[GAME_STAGE_MAX] = { -150, -50 };
+			constexpr Score TRAPPED_BISHOP_A8 = MakeScore(-150, -50);
+			constexpr Score TRAPPED_BISHOP_A7 = MakeScore(-100, -50);
+			constexpr Score TRAPPED_BISHOP_A6 = MakeScore(-50, -50);
+			constexpr Score TRAPPED_BISHOP_B8 = MakeScore(-150, -50);
 
-			constexpr ValueType TRAPPED_ROOK[GAME_STAGE_MAX] = { -25, -25 };
+			constexpr Score TRAPPED_ROOK = MakeScore(-25, -25);
 
 			// Trapped Bishops
 			if (position.IsPieceOnSquare(TEAM, PIECE_BISHOP, RelativeSquare(TEAM, a7)) && position.IsPieceOnSquare(OTHER_TEAM, PIECE_PAWN, RelativeSquare(TEAM, b6)))
 			{
-				mg += TRAPPED_BISHOP_A7[MIDGAME];
-				eg += TRAPPED_BISHOP_A7[ENDGAME];
+				score += TRAPPED_BISHOP_A7;
 			}
 			if (position.IsPieceOnSquare(TEAM, PIECE_BISHOP, RelativeSquare(TEAM, h7)) && position.IsPieceOnSquare(OTHER_TEAM, PIECE_PAWN, RelativeSquare(TEAM, g6)))
 			{
-				mg += TRAPPED_BISHOP_A7[MIDGAME];
-				eg += TRAPPED_BISHOP_A7[ENDGAME];
+				score += TRAPPED_BISHOP_A7;
 			}
 			if (position.IsPieceOnSquare(TEAM, PIECE_BISHOP, RelativeSquare(TEAM, a6)) && position.IsPieceOnSquare(OTHER_TEAM, PIECE_PAWN, RelativeSquare(TEAM, b5)))
 			{
-				mg += TRAPPED_BISHOP_A6[MIDGAME];
-				eg += TRAPPED_BISHOP_A6[ENDGAME];
+				score += TRAPPED_BISHOP_A6;
 			}
 			if (position.IsPieceOnSquare(TEAM, PIECE_BISHOP, RelativeSquare(TEAM, h6)) && position.IsPieceOnSquare(OTHER_TEAM, PIECE_PAWN, RelativeSquare(TEAM, g5)))
 			{
-				mg += TRAPPED_BISHOP_A6[MIDGAME];
-				eg += TRAPPED_BISHOP_A6[ENDGAME];
+				score += TRAPPED_BISHOP_A6;
 			}
 			if (position.IsPieceOnSquare(TEAM, PIECE_BISHOP, RelativeSquare(TEAM, b8)) && position.IsPieceOnSquare(OTHER_TEAM, PIECE_PAWN, RelativeSquare(TEAM, c7)))
 			{
-				mg += TRAPPED_BISHOP_B8[MIDGAME];
-				eg += TRAPPED_BISHOP_B8[ENDGAME];
+				score += TRAPPED_BISHOP_B8;
 			}
 			if (position.IsPieceOnSquare(TEAM, PIECE_BISHOP, RelativeSquare(TEAM, g8)) && position.IsPieceOnSquare(OTHER_TEAM, PIECE_PAWN, RelativeSquare(TEAM, f7)))
 			{
-				mg += TRAPPED_BISHOP_B8[MIDGAME];
-				eg += TRAPPED_BISHOP_B8[ENDGAME];
+				score += TRAPPED_BISHOP_B8;
 			}
 			if (position.IsPieceOnSquare(TEAM, PIECE_BISHOP, RelativeSquare(TEAM, a8)) && position.IsPieceOnSquare(OTHER_TEAM, PIECE_PAWN, RelativeSquare(TEAM, b7)))
 			{
-				mg += TRAPPED_BISHOP_A8[MIDGAME];
-				eg += TRAPPED_BISHOP_A8[ENDGAME];
+				score += TRAPPED_BISHOP_A8;
 			}
 			if (position.IsPieceOnSquare(TEAM, PIECE_BISHOP, RelativeSquare(TEAM, h8)) && position.IsPieceOnSquare(OTHER_TEAM, PIECE_PAWN, RelativeSquare(TEAM, g7)))
 			{
-				mg += TRAPPED_BISHOP_A8[MIDGAME];
-				eg += TRAPPED_BISHOP_A8[ENDGAME];
+				score += TRAPPED_BISHOP_A8;
 			}
 
 			// Blocked Rook
 			if ((position.IsPieceOnSquare(TEAM, PIECE_ROOK, RelativeSquare(TEAM, g1)) || position.IsPieceOnSquare(TEAM, PIECE_ROOK, RelativeSquare(TEAM, h1)))
 				&& (position.IsPieceOnSquare(TEAM, PIECE_KING, RelativeSquare(TEAM, g1)) || position.IsPieceOnSquare(TEAM, PIECE_KING, RelativeSquare(TEAM, f1))))
 			{
-				mg += TRAPPED_ROOK[MIDGAME];
-				eg += TRAPPED_ROOK[ENDGAME];
+				score += TRAPPED_ROOK;
 			}
 			else if ((position.IsPieceOnSquare(TEAM, PIECE_ROOK, RelativeSquare(TEAM, a1)) || position.IsPieceOnSquare(TEAM, PIECE_ROOK, RelativeSquare(TEAM, b1)))
 				&& (position.IsPieceOnSquare(TEAM, PIECE_KING, RelativeSquare(TEAM, b1)) || position.IsPieceOnSquare(TEAM, PIECE_KING, RelativeSquare(TEAM, c1))))
 			{
-				mg += TRAPPED_ROOK[MIDGAME];
-				eg += TRAPPED_ROOK[ENDGAME];
+				score += TRAPPED_ROOK;
 			}
 
-			result.BlockedPieces[MIDGAME][TEAM] = mg;
-			result.BlockedPieces[ENDGAME][TEAM] = eg;
-		}
-		else
-		{
-			result.BlockedPieces[MIDGAME][TEAM] = 0;
-			result.BlockedPieces[ENDGAME][TEAM] = 0;
+			result.AddTerm<TRACE>(TERM_BLOCKED_PIECES, TEAM, score);
 		}
 	}
 
+	template<bool TRACE>
 	void EvaluateBlockedPieces(EvaluationResult& result, const Position& position)
 	{
-		EvaluateBlockedPieces<TEAM_WHITE>(result, position);
-		EvaluateBlockedPieces<TEAM_BLACK>(result, position);
+		EvaluateBlockedPieces<TEAM_WHITE, TRACE>(result, position);
+		EvaluateBlockedPieces<TEAM_BLACK, TRACE>(result, position);
 	}
 
 	template<Team TEAM>
-	void EvaluatePawns(EvaluationResult& result, const Position& position)
+	void EvaluatePawns(PawnHashEntry& entry, const Position& position)
 	{
 		constexpr Team OTHER_TEAM = OtherTeam(TEAM);
 		constexpr ValueType SupportedPassedPawn = 35;
@@ -631,17 +627,38 @@ namespace Boxfish
 		mg -= 5 * doubledCount;
 		eg -= 30 * doubledCount;
 
-		result.Pawns[MIDGAME][TEAM] = mg;
-		result.Pawns[ENDGAME][TEAM] = eg;
+		entry.Pawns[TEAM] = MakeScore(mg, eg);
 	}
 
-	void EvaluatePawns(EvaluationResult& result, const Position& position)
+	void EvaluatePawns(PawnHashEntry& entry, const Position& position)
 	{
-		EvaluatePawns<TEAM_WHITE>(result, position);
-		EvaluatePawns<TEAM_BLACK>(result, position);
+		BitBoard whitePawns = position.GetTeamPieces(TEAM_WHITE, PIECE_PAWN);
+		BitBoard blackPawns = position.GetTeamPieces(TEAM_BLACK, PIECE_PAWN);
+		BitBoard allPawns = whitePawns | blackPawns;
+
+		entry.Key = position.PawnHash.Hash;
+		entry.Attacks[TEAM_WHITE] = GetPawnAttacks<TEAM_WHITE>(whitePawns);
+		entry.Attacks[TEAM_BLACK] = GetPawnAttacks<TEAM_BLACK>(blackPawns);
+		entry.DoubleAttacks[TEAM_WHITE] = GetPawnDoubleAttacks<TEAM_WHITE>(whitePawns);
+		entry.DoubleAttacks[TEAM_BLACK] = GetPawnDoubleAttacks<TEAM_BLACK>(blackPawns);
+
+		entry.BlockedCount = 0;
+		entry.BlockedCount += (Shift<NORTH>(whitePawns) & (allPawns | entry.DoubleAttacks[TEAM_BLACK]));
+		entry.BlockedCount += (Shift<SOUTH>(blackPawns) & (allPawns | entry.DoubleAttacks[TEAM_WHITE]));
+
+		EvaluatePawns<TEAM_WHITE>(entry, position);
+		EvaluatePawns<TEAM_BLACK>(entry, position);
 	}
 
-	template<Team TEAM, Piece PIECE>
+	const PawnHashEntry& ProbePawns(const Position& position, PawnHashTable* pawnTable, PawnHashEntry& localEntry)
+	{
+		PawnHashEntry* entry = pawnTable ? pawnTable->GetEntry(position.PawnHash) : &localEntry;
+		if (!pawnTable || entry->Key != position.PawnHash.Hash)
+			EvaluatePawns(*entry, position);
+		return *entry;
+	}
+
+	template<Team TEAM, Piece PIECE, bool TRACE>
 	void EvaluatePieces(EvaluationResult& result, const Position& position)
 	{
 		static_assert(PIECE == PIECE_KNIGHT || PIECE == PIECE_BISHOP || PIECE == PIECE_ROOK || PIECE == PIECE_QUEEN);
@@ -676,12 +693,6 @@ namespace Boxfish
 		{
 			SquareIndex square = PopLeastSignificantBit(pieceSquares);
 
-			if constexpr (UsePieceSquares)
-			{
-				result.PieceSquares[MIDGAME][TEAM] += s_PieceSquareTables[MIDGAME][TEAM][PIECE][square];
-				result.PieceSquares[ENDGAME][TEAM] += s_PieceSquareTables[ENDGAME][TEAM][PIECE][square];
-			}
-
 			BitBoard attacks =
 				PIECE == PIECE_BISHOP	? GetSlidingAttacks<PIECE_BISHOP>(square, position.GetAllPieces() ^ position.GetPieces(PIECE_QUEEN)) :
 				PIECE == PIECE_ROOK		? GetSlidingAttacks<PIECE_ROOK>(square, position.GetAllPieces() ^ position.GetPieces(PIECE_QUEEN) ^ position.GetTeamPieces(TEAM, PIECE_ROOK)) :
@@ -761,17 +772,21 @@ namespace Boxfish
 			}
 		}
 
-		result.SetPieceEval<TEAM, PIECE>(mg, eg);
+		constexpr EvaluationTerm Term =
+			PIECE == PIECE_KNIGHT	? TERM_KNIGHTS :
+			PIECE == PIECE_BISHOP	? TERM_BISHOPS :
+			PIECE == PIECE_ROOK		? TERM_ROOKS : TERM_QUEENS;
+		result.AddTerm<TRACE>(Term, TEAM, MakeScore(mg, eg));
 	}
 
-	template<Piece PIECE>
+	template<Piece PIECE, bool TRACE>
 	void EvaluatePieces(EvaluationResult& result, const Position& position)
 	{
-		EvaluatePieces<TEAM_WHITE, PIECE>(result, position);
-		EvaluatePieces<TEAM_BLACK, PIECE>(result, position);
+		EvaluatePieces<TEAM_WHITE, PIECE, TRACE>(result, position);
+		EvaluatePieces<TEAM_BLACK, PIECE, TRACE>(result, position);
 	}
 
-	template<Team TEAM>
+	template<Team TEAM, bool TRACE>
 	void EvaluateKingSafety(EvaluationResult& result, const Position& position)
 	{
 		if constexpr (UseKingSafety)
@@ -837,23 +852,18 @@ namespace Boxfish
 
 			eg -= 8 * minDistance;
 
-			result.KingSafety[MIDGAME][TEAM] = mg;
-			result.KingSafety[ENDGAME][TEAM] = eg;
-		}
-		else
-		{
-			result.KingSafety[MIDGAME][TEAM] = 0;
-			result.KingSafety[ENDGAME][TEAM] = 0;
+			result.AddTerm<TRACE>(TERM_KING_SAFETY, TEAM, MakeScore(mg, eg));
 		}
 	}
 
+	template<bool TRACE>
 	void EvaluateKingSafety(EvaluationResult& result, const Position& position)
 	{
-		EvaluateKingSafety<TEAM_WHITE>(result, position);
-		EvaluateKingSafety<TEAM_BLACK>(result, position);
+		EvaluateKingSafety<TEAM_WHITE, TRACE>(result, position);
+		EvaluateKingSafety<TEAM_BLACK, TRACE>(result, position);
 	}
 
-	template<Team TEAM>
+	template<Team TEAM, bool TRACE>
 	void EvaluateThreats(EvaluationResult& result, const Position& position)
 	{
 		if constexpr (UseThreats)
@@ -904,33 +914,24 @@ namespace Boxfish
 			mg += 3 * moveCount;
 			eg += 3 * moveCount;
 
-			result.Threats[MIDGAME][TEAM] = mg;
-			result.Threats[ENDGAME][TEAM] = eg;
-		}
-		else
-		{
-			result.Threats[MIDGAME][TEAM] = 0;
-			result.Threats[ENDGAME][TEAM] = 0;
+			result.AddTerm<TRACE>(TERM_THREATS, TEAM, MakeScore(mg, eg));
 		}
 	}
 
+	template<bool TRACE>
 	void EvaluateThreats(EvaluationResult& result, const Position& position)
 	{
-		EvaluateThreats<TEAM_WHITE>(result, position);
-		EvaluateThreats<TEAM_BLACK>(result, position);
+		EvaluateThreats<TEAM_WHITE, TRACE>(result, position);
+		EvaluateThreats<TEAM_BLACK, TRACE>(result, position);
 	}
 
-	template<Team TEAM>
+	template<Team TEAM, bool TRACE>
 	void EvaluateSpace(EvaluationResult& result, const Position& position, int blockedPawns)
 	{
 		if constexpr (UseSpace)
 		{
 			if (position.GetNonPawnMaterial() < 6250)
-			{
-				result.Space[MIDGAME][TEAM] = 0;
-				result.Space[ENDGAME][TEAM] = 0;
 				return;
-			}
 
 			constexpr Team OTHER_TEAM = OtherTeam(TEAM);
 			constexpr Direction Down = (TEAM == TEAM_WHITE) ? SOUTH : NORTH;
@@ -947,47 +948,24 @@ namespace Boxfish
 			int count = safe.GetCount() + (behind & safe & ~result.Data.AttackedBy[OTHER_TEAM][PIECE_ALL]).GetCount();
 			int weight = position.GetTeamPieces(TEAM).GetCount() - 3 + std::min(blockedPawns, 9);
 
-			result.Space[MIDGAME][TEAM] = count * weight * weight / 30;
-			result.Space[ENDGAME][TEAM] = 0;
-		}
-		else
-		{
-			result.Space[MIDGAME][TEAM] = 0;
-			result.Space[ENDGAME][TEAM] = 0;
+			result.AddTerm<TRACE>(TERM_SPACE, TEAM, MakeScore(count * weight * weight / 30, 0));
 		}
 	}
 
-	void EvaluateSpace(EvaluationResult& result, const Position& position)
+	template<bool TRACE>
+	void EvaluateSpace(EvaluationResult& result, const Position& position, const PawnHashEntry& pawns)
 	{
-		BitBoard whitePawns = position.GetTeamPieces(TEAM_WHITE, PIECE_PAWN);
-		BitBoard blackPawns = position.GetTeamPieces(TEAM_BLACK, PIECE_PAWN);
-		BitBoard allPawns = whitePawns | blackPawns;
-
-		int blockedPawns = 0;
-		blockedPawns += (Shift<NORTH>(whitePawns) & (allPawns | GetPawnDoubleAttacks<TEAM_BLACK>(blackPawns)));
-		blockedPawns += (Shift<SOUTH>(blackPawns) & (allPawns | GetPawnDoubleAttacks<TEAM_WHITE>(whitePawns)));
-
-		EvaluateSpace<TEAM_WHITE>(result, position, blockedPawns);
-		EvaluateSpace<TEAM_BLACK>(result, position, blockedPawns);
+		EvaluateSpace<TEAM_WHITE, TRACE>(result, position, pawns.BlockedCount);
+		EvaluateSpace<TEAM_BLACK, TRACE>(result, position, pawns.BlockedCount);
 	}
 
+	template<bool TRACE>
 	void EvaluateTempo(EvaluationResult& result, const Position& position)
 	{
 		if constexpr (UseInitiative)
 		{
-			constexpr ValueType tempo = 12;
-			Team other = OtherTeam(position.TeamToPlay);
-			result.Tempo[MIDGAME][position.TeamToPlay] = tempo;
-			result.Tempo[ENDGAME][position.TeamToPlay] = tempo;
-			result.Tempo[MIDGAME][other] = 0;
-			result.Tempo[ENDGAME][other] = 0;
-		}
-		else
-		{
-			result.Tempo[MIDGAME][TEAM_WHITE] = 0;
-			result.Tempo[ENDGAME][TEAM_WHITE] = 0;
-			result.Tempo[MIDGAME][TEAM_BLACK] = 0;
-			result.Tempo[ENDGAME][TEAM_BLACK] = 0;
+			constexpr Score Tempo = MakeScore(12, 12);
+			result.AddTerm<TRACE>(TERM_TEMPO, position.TeamToPlay, Tempo);
 		}
 	}
 
@@ -1000,19 +978,61 @@ namespace Boxfish
 		memset(&result, 0, sizeof(EvaluationResult));
 	}
 
-	EvaluationResult EvaluateDetailed(const Position& position, Team team, ValueType alpha, ValueType beta)
+	// TRACE additionally records the per team breakdown of every term, which is only needed for display
+	// Returns false if the evaluation stopped early because the score was too far outside [alpha, beta]
+	template<bool TRACE>
+	bool EvaluatePosition(EvaluationResult& result, const Position& position, PawnHashTable* pawnTable, Team team, ValueType alpha, ValueType beta, ValueType lazyMargin)
 	{
-		EvaluationResult result;
+		result.Total = SCORE_ZERO;
 		result.GameStage = CalculateGameStage(position);
+		result.ScaleFactor = SCALE_FACTOR_NORMAL;
 		result.IsDraw = false;
-		EvaluateMaterial(result, position);
-		EvaluatePieceSquareTables(result, position);
-		
-		BitBoard whiteDoublePawnAttacks = GetPawnDoubleAttacks<TEAM_WHITE>(position.GetTeamPieces(TEAM_WHITE, PIECE_PAWN));
-		BitBoard blackDoublePawnAttacks = GetPawnDoubleAttacks<TEAM_BLACK>(position.GetTeamPieces(TEAM_BLACK, PIECE_PAWN));
 
-		result.Data.AttackedBy[TEAM_WHITE][PIECE_PAWN] = GetPawnAttacks<TEAM_WHITE>(position.GetTeamPieces(TEAM_WHITE, PIECE_PAWN));
-		result.Data.AttackedBy[TEAM_BLACK][PIECE_PAWN] = GetPawnAttacks<TEAM_BLACK>(position.GetTeamPieces(TEAM_BLACK, PIECE_PAWN));
+		const EndgameEntry* endgame = ProbeEndgame(position);
+		if (endgame)
+		{
+			if (endgame->Value)
+			{
+				ValueType value = endgame->Value(position, endgame->StrongTeam);
+				result.Total = (endgame->StrongTeam == TEAM_WHITE) ? MakeScore(value, value) : MakeScore(-value, -value);
+				return true;
+			}
+			result.ScaleFactor = endgame->Scale(position, endgame->StrongTeam);
+		}
+
+		EvaluateMaterialDraw(result, position);
+		if constexpr (TRACE)
+		{
+			EvaluateMaterial<TRACE>(result, position);
+			EvaluatePieceSquareTables<TRACE>(result, position);
+		}
+		else
+		{
+			// Kept up to date by Position, equal to the sum of the two terms above
+			result.Total += position.GetPieceScore(TEAM_WHITE) - position.GetPieceScore(TEAM_BLACK);
+		}
+
+		PawnHashEntry localPawnEntry;
+		const PawnHashEntry& pawns = ProbePawns(position, pawnTable, localPawnEntry);
+		result.AddTerm<TRACE>(TERM_PAWNS, TEAM_WHITE, pawns.Pawns[TEAM_WHITE]);
+		result.AddTerm<TRACE>(TERM_PAWNS, TEAM_BLACK, pawns.Pawns[TEAM_BLACK]);
+
+		// Lazy evaluation, the remaining terms are unlikely to bring the score back inside the window
+		if constexpr (!TRACE)
+		{
+			if (lazyMargin > 0)
+			{
+				ValueType partial = result.GetTotal(team);
+				if (partial + lazyMargin < alpha || partial - lazyMargin > beta)
+					return false;
+			}
+		}
+
+		BitBoard whiteDoublePawnAttacks = pawns.DoubleAttacks[TEAM_WHITE];
+		BitBoard blackDoublePawnAttacks = pawns.DoubleAttacks[TEAM_BLACK];
+
+		result.Data.AttackedBy[TEAM_WHITE][PIECE_PAWN] = pawns.Attacks[TEAM_WHITE];
+		result.Data.AttackedBy[TEAM_BLACK][PIECE_PAWN] = pawns.Attacks[TEAM_BLACK];
 		result.Data.AttackedBy[TEAM_WHITE][PIECE_KING] = GetNonSlidingAttacks<PIECE_KING>(position.GetKingSquare(TEAM_WHITE));
 		result.Data.AttackedBy[TEAM_BLACK][PIECE_KING] = GetNonSlidingAttacks<PIECE_KING>(position.GetKingSquare(TEAM_BLACK));
 		result.Data.AttackedByTwice[TEAM_WHITE] = whiteDoublePawnAttacks | (result.Data.AttackedBy[TEAM_WHITE][PIECE_PAWN] & result.Data.AttackedBy[TEAM_WHITE][PIECE_KING]);
@@ -1028,24 +1048,45 @@ namespace Boxfish
 		result.Data.KingAttackZone[TEAM_BLACK] &= ~blackDoublePawnAttacks;
 
 		// Do these first as they set AttackedBy data
-		EvaluatePieces<PIECE_KNIGHT>(result, position);
-		EvaluatePieces<PIECE_BISHOP>(result, position);
-		EvaluatePieces<PIECE_ROOK>(result, position);
-		EvaluatePieces<PIECE_QUEEN>(result, position);
-
-		EvaluatePawns(result, position);
-		EvaluateBlockedPieces(result, position);
-		EvaluateSpace(result, position);
-		EvaluateKingSafety(result, position);
-		EvaluateThreats(result, position);
-		EvaluateTempo(result, position);
+		EvaluatePieces<PIECE_KNIGHT, TRACE>(result, position);
+		EvaluatePieces<PIECE_BISHOP, TRACE>(result, position);
+		EvaluatePieces<PIECE_ROOK, TRACE>(result, position);
+		EvaluatePieces<PIECE_QUEEN, TRACE>(result, position);
+
+		EvaluateBlockedPieces<TRACE>(result, position);
+		EvaluateSpace<TRACE>(result, position, pawns);
+		EvaluateKingSafety<TRACE>(result, position);
+		EvaluateThreats<TRACE>(result, position);
+		EvaluateTempo<TRACE>(result, position);
+		return true;
+	}
 
+	EvaluationResult EvaluateDetailed(const Position& position, Team team, ValueType alpha, ValueType beta, PawnHashTable* pawnTable)
+	{
+		EvaluationResult result;
+		ClearResult(result);
+		EvaluatePosition<true>(result, position, pawnTable, team, alpha, beta, 0);
 		return result;
 	}
 
+	ValueType Evaluate(const Position& position, Team team, ValueType alpha, ValueType beta, PawnHashTable* pawnTable, ValueType lazyMargin, bool* outLazy)
+	{
+		if (outLazy)
+			*outLazy = false;
+		EvaluationResult result;
+		if (!EvaluatePosition<false>(result, position, pawnTable, team, alpha, beta, lazyMargin) && outLazy)
+			*outLazy = true;
+		return result.GetTotal(team);
+	}
+
+	EvaluationResult EvaluateDetailed(const Position& position, Team team, ValueType alpha, ValueType beta)
+	{
+		return EvaluateDetailed(position, team, alpha, beta, nullptr);
+	}
+
 	ValueType Evaluate(const Position& position, Team team, ValueType alpha, ValueType beta)
 	{
-		return EvaluateDetailed(position, team, alpha, beta).GetTotal(team);
+		return Evaluate(position, team, alpha, beta, nullptr);
 	}
 
 	EvaluationResult EvaluateDetailed(const Position& position)
@@ -1106,45 +1147,30 @@ namespace Boxfish
 	{
 		constexpr int SCORE_LENGTH = 6;
 
-		ValueType totals[GAME_STAGE_MAX][TEAM_MAX];
-
-		for (GameStage stage : { MIDGAME, ENDGAME })
+		Score totals[TEAM_MAX] = { SCORE_ZERO, SCORE_ZERO };
+		for (int term = 0; term < TERM_MAX; term++)
 		{
-			for (Team team : { TEAM_WHITE, TEAM_BLACK })
-			{
-				totals[stage][team] =
-					evaluation.Material[stage][team] +
-					evaluation.PieceSquares[stage][team] +
-					evaluation.BlockedPieces[stage][team] +
-					evaluation.Pawns[stage][team] +
-					evaluation.Knights[stage][team] +
-					evaluation.Bishops[stage][team] +
-					evaluation.Rooks[stage][team] +
-					evaluation.Queens[stage][team] +
-					evaluation.Space[stage][team] +
-					evaluation.KingSafety[stage][team] +
-					evaluation.Threats[stage][team] +
-					evaluation.Tempo[stage][team];
-			}
+			totals[TEAM_WHITE] += evaluation.Terms[term][TEAM_WHITE];
+			totals[TEAM_BLACK] += evaluation.Terms[term][TEAM_BLACK];
 		}
 
-#define FORMAT_TABLE_ROW(Score, Length) (FormatScore(Score[MIDGAME][TEAM_WHITE], Length) + " " + FormatScore(Score[ENDGAME][TEAM_WHITE], Length) + " | " + FormatScore(Score[MIDGAME][TEAM_BLACK], Length) + " " + FormatScore(Score[ENDGAME][TEAM_BLACK], Length) + " | " + FormatScore(Score[MIDGAME][TEAM_WHITE] - Score[MIDGAME][TEAM_BLACK], Length) + " " + FormatScore(Score[ENDGAME][TEAM_WHITE] - Score[ENDGAME][TEAM_BLACK], Length))
+#define FORMAT_TABLE_ROW(Scores, Length) (FormatScore(MgValue(Scores[TEAM_WHITE]), Length) + " " + FormatScore(EgValue(Scores[TEAM_WHITE]), Length) + " | " + FormatScore(MgValue(Scores[TEAM_BLACK]), Length) + " " + FormatScore(EgValue(Scores[TEAM_BLACK]), Length) + " | " + FormatScore(MgValue(Scores[TEAM_WHITE]) - MgValue(Scores[TEAM_BLACK]), Length) + " " + FormatScore(EgValue(Scores[TEAM_WHITE]) - EgValue(Scores[TEAM_BLACK]), Length))
 		std::string result = "";
 		result += "       Term     |     White     |     Black     |     Total     \n";
 		result += "                |   MG     EG   |   MG     EG   |   MG     EG   \n";
 		result += " ---------------+---------------+---------------+---------------\n";
-		result += "       Material | " + FORMAT_TABLE_ROW(evaluation.Material, SCORE_LENGTH)		+ '\n';
-		result += "  Piece Squares | " + FORMAT_TABLE_ROW(evaluation.PieceSquares, SCORE_LENGTH)	+ '\n';
-		result += " Blocked Pieces | " + FORMAT_TABLE_ROW(evaluation.BlockedPieces, SCORE_LENGTH)	+ '\n';
-		result += "          Pawns | " + FORMAT_TABLE_ROW(evaluation.Pawns, SCORE_LENGTH)			+ '\n';
-		result += "        Knights | " + FORMAT_TABLE_ROW(evaluation.Knights, SCORE_LENGTH)			+ '\n';
-		result += "        Bishops | " + FORMAT_TABLE_ROW(evaluation.Bishops, SCORE_LENGTH)			+ '\n';
-		result += "          Rooks | " + FORMAT_TABLE_ROW(evaluation.Rooks, SCORE_LENGTH)			+ '\n';
-		result += "         Queens | " + FORMAT_TABLE_ROW(evaluation.Queens, SCORE_LENGTH)			+ '\n';
-		result += "          Space | " + FORMAT_TABLE_ROW(evaluation.Space, SCORE_LENGTH)			+ '\n';
-		result += "    King Safety | " + FORMAT_TABLE_ROW(evaluation.KingSafety, SCORE_LENGTH)		+ '\n';
-		result += "        Threats | " + FORMAT_TABLE_ROW(evaluation.Threats, SCORE_LENGTH)			+ '\n';
-		result += "          Tempo | " + FORMAT_TABLE_ROW(evaluation.Tempo, SCORE_LENGTH)			+ '\n';
+		result += "       Material | " + FORMAT_TABLE_ROW(evaluation.Terms[TERM_MATERIAL], SCORE_LENGTH)		+ '\n';
+		result += "  Piece Squares | " + FORMAT_TABLE_ROW(evaluation.Terms[TERM_PIECE_SQUARES], SCORE_LENGTH)	+ '\n';
+		result += " Blocked Pieces | " + FORMAT_TABLE_ROW(evaluation.Terms[TERM_BLOCKED_PIECES], SCORE_LENGTH)	+ '\n';
+		result += "          Pawns | " + FORMAT_TABLE_ROW(evaluation.Terms[TERM_PAWNS], SCORE_LENGTH)			+ '\n';
+		result += "        Knights | " + FORMAT_TABLE_ROW(evaluation.Terms[TERM_KNIGHTS], SCORE_LENGTH)			+ '\n';
+		result += "        Bishops | " + FORMAT_TABLE_ROW(evaluation.Terms[TERM_BISHOPS], SCORE_LENGTH)			+ '\n';
+		result += "          Rooks | " + FORMAT_TABLE_ROW(evaluation.Terms[TERM_ROOKS], SCORE_LENGTH)			+ '\n';
+		result += "         Queens | " + FORMAT_TABLE_ROW(evaluation.Terms[TERM_QUEENS], SCORE_LENGTH)			+ '\n';
+		result += "          Space | " + FORMAT_TABLE_ROW(evaluation.Terms[TERM_SPACE], SCORE_LENGTH)			+ '\n';
+		result += "    King Safety | " + FORMAT_TABLE_ROW(evaluation.Terms[TERM_KING_SAFETY], SCORE_LENGTH)		+ '\n';
+		result += "        Threats | " + FORMAT_TABLE_ROW(evaluation.Terms[TERM_THREATS], SCORE_LENGTH)			+ '\n';
+		result += "          Tempo | " + FORMAT_TABLE_ROW(evaluation.Terms[TERM_TEMPO], SCORE_LENGTH)			+ '\n';
 		result += " ---------------+---------------+---------------+--------------\n";
 		result += "          Total | " + FORMAT_TABLE_ROW(totals, SCORE_LENGTH)						+ "\n";
 		result += "\n";
@@ -1,6 +1,8 @@
 #pragma once
 #include "Bitboard.h"
 #include "Position.h"
+#include "PawnHashTable.h"
+#include "Endgame.h"
 #include <limits>
 
 #ifdef SWIG
@@ -10,7 +12,9 @@
 namespace Boxfish
 {
 
+	extern int s_PhaseWeights[PIECE_MAX];
 	extern int s_MaxPhaseValue;
+	extern Score s_PieceScores[TEAM_MAX][PIECE_MAX][SQUARE_MAX];
 
 	constexpr ValueType SCORE_MATE = 200000;
 	constexpr ValueType SCORE_DRAW = 0;
@@ -22,6 +26,17 @@ namespace Boxfish
 		return ((midgame * mgWeight) + (endgame * stage)) / s_MaxPhaseValue;
 	}
 
+	// Material plus piece square value of a single piece, accumulated incrementally in Position::InfoCache.PieceScore
+	inline Score GetPieceScore(Team team, Piece piece, SquareIndex square)
+	{
+		return s_PieceScores[team][piece][square];
+	}
+
+	inline int GetPhaseWeight(Piece piece)
+	{
+		return s_PhaseWeights[piece];
+	}
+
 	struct BOX_API EvaluationMeta
 	{
 	public:
@@ -32,84 +47,52 @@ namespace Boxfish
 		BitBoard AttackedByTwice[TEAM_MAX];
 	};
 
+	enum EvaluationTerm : int8_t
+	{
+		TERM_MATERIAL,
+		TERM_PIECE_SQUARES,
+		TERM_BLOCKED_PIECES,
+		TERM_PAWNS,
+		TERM_KNIGHTS,
+		TERM_BISHOPS,
+		TERM_ROOKS,
+		TERM_QUEENS,
+		TERM_SPACE,
+		TERM_KING_SAFETY,
+		TERM_THREATS,
+		TERM_TEMPO,
+		TERM_MAX
+	};
+
 	struct BOX_API EvaluationResult
 	{
 	public:
 		EvaluationMeta Data;
 
-		ValueType Material[GAME_STAGE_MAX][TEAM_MAX];
-		ValueType PieceSquares[GAME_STAGE_MAX][TEAM_MAX];
-		ValueType BlockedPieces[GAME_STAGE_MAX][TEAM_MAX];
-		ValueType Pawns[GAME_STAGE_MAX][TEAM_MAX];
-		ValueType Knights[GAME_STAGE_MAX][TEAM_MAX];
-		ValueType Bishops[GAME_STAGE_MAX][TEAM_MAX];
-		ValueType Rooks[GAME_STAGE_MAX][TEAM_MAX];
-		ValueType Queens[GAME_STAGE_MAX][TEAM_MAX];
-		ValueType Space[GAME_STAGE_MAX][TEAM_MAX];
-		ValueType KingSafety[GAME_STAGE_MAX][TEAM_MAX];
-		ValueType Threats[GAME_STAGE_MAX][TEAM_MAX];
-		ValueType Tempo[GAME_STAGE_MAX][TEAM_MAX];
+		// Sum of all terms from white's perspective
+		Score Total;
+		// Per team breakdown of Total, only filled in by EvaluateDetailed
+		Score Terms[TERM_MAX][TEAM_MAX];
 		int GameStage;
+		// Out of SCALE_FACTOR_NORMAL, applied to the endgame value
+		int ScaleFactor;
 		bool IsDraw;
 
 	public:
-		template<Team TEAM, Piece PIECE>
-		inline void SetPieceEval(ValueType mg, ValueType eg)
+		template<bool TRACE>
+		inline void AddTerm(EvaluationTerm term, Team team, Score score)
 		{
-			if constexpr (PIECE == PIECE_KNIGHT)
-			{
-				Knights[MIDGAME][TEAM] = mg;
-				Knights[ENDGAME][TEAM] = eg;
-			}
-			if constexpr (PIECE == PIECE_BISHOP)
-			{
-				Bishops[MIDGAME][TEAM] = mg;
-				Bishops[ENDGAME][TEAM] = eg;
-			}
-			if constexpr (PIECE == PIECE_ROOK)
-			{
-				Rooks[MIDGAME][TEAM] = mg;
-				Rooks[ENDGAME][TEAM] = eg;
-			}
-			if constexpr (PIECE == PIECE_QUEEN)
-			{
-				Queens[MIDGAME][TEAM] = mg;
-				Queens[ENDGAME][TEAM] = eg;
-			}
+			Total += (team == TEAM_WHITE) ? score : -score;
+			if constexpr (TRACE)
+				Terms[term][team] += score;
 		}
 
 		inline ValueType GetTotal(Team team) const
 		{
 			if (IsDraw)
 				return SCORE_DRAW;
-			Team other = OtherTeam(team);
-			ValueType midgame =
-				(Material[MIDGAME][team] - Material[MIDGAME][other]) +
-				(PieceSquares[MIDGAME][team] - PieceSquares[MIDGAME][other]) +
-				(BlockedPieces[MIDGAME][team] - BlockedPieces[MIDGAME][other]) +
-				(Pawns[MIDGAME][team] - Pawns[MIDGAME][other]) +
-				(Knights[MIDGAME][team] - Knights[MIDGAME][other]) +
-				(Bishops[MIDGAME][team] - Bishops[MIDGAME][other]) +
-				(Rooks[MIDGAME][team] - Rooks[MIDGAME][other]) +
-				(Queens[MIDGAME][team] - Queens[MIDGAME][other]) +
-				(Space[MIDGAME][team] - Space[MIDGAME][other]) +
-				(KingSafety[MIDGAME][team] - KingSafety[MIDGAME][other]) +
-				(Threats[MIDGAME][team] - Threats[MIDGAME][other]) +
-				(Tempo[MIDGAME][team] - Tempo[MIDGAME][other]);
-			ValueType endgame = 
-				(Material[ENDGAME][team] - Material[ENDGAME][other]) +
-				(PieceSquares[ENDGAME][team] - PieceSquares[ENDGAME][other]) +
-				(BlockedPieces[ENDGAME][team] - BlockedPieces[ENDGAME][other]) +
-				(Pawns[ENDGAME][team] - Pawns[ENDGAME][other]) +
-				(Knights[ENDGAME][team] - Knights[ENDGAME][other]) +
-				(Bishops[ENDGAME][team] - Bishops[ENDGAME][other]) +
-				(Rooks[ENDGAME][team] - Rooks[ENDGAME][other]) +
-				(Queens[ENDGAME][team] - Queens[ENDGAME][other]) +
-				(Space[ENDGAME][team] - Space[ENDGAME][other]) +
-				(KingSafety[ENDGAME][team] - KingSafety[ENDGAME][other]) +
-				(Threats[ENDGAME][team] - Threats[ENDGAME][other]) +
-				(Tempo[ENDGAME][team] - Tempo[ENDGAME][other]);
-			return InterpolateGameStage(GameStage, midgame, endgame);
+			ValueType total = InterpolateGameStage(GameStage, MgValue(Total), EgValue(Total) * ScaleFactor / SCALE_FACTOR_NORMAL);
+			return (team == TEAM_WHITE) ? total : -total;
 		}
 	};
 
@@ -117,6 +100,11 @@ namespace Boxfish
 
 	EvaluationResult EvaluateDetailed(const Position& position, Team team, ValueType alpha, ValueType beta);
 	ValueType Evaluate(const Position& position, Team team, ValueType alpha, ValueType beta);
+	// pawnTable may be null, in which case the pawn terms are always recomputed
+	EvaluationResult EvaluateDetailed(const Position& position, Team team, ValueType alpha, ValueType beta, PawnHashTable* pawnTable);
+	// Only material, piece squares and pawns are evaluated if they are already further than lazyMargin outside [alpha, beta],
+	// outLazy is set when that happens. A margin of 0 disables lazy evaluation
+	ValueType Evaluate(const Position& position, Team team, ValueType alpha, ValueType beta, PawnHashTable* pawnTable, ValueType lazyMargin = 0, bool* outLazy = nullptr);
 	EvaluationResult EvaluateDetailed(const Position& position);
 	ValueType Evaluate(const Position& position, Team team);
 	bool IsEndgame(const Position& position);
@@ -197,8 +197,7 @@ namespace Boxfish
 			Move buffer[MAX_MOVES];
 			MoveGenerator generator(pos);
 			MoveList moves(buffer);
-			generator.GetPseudoLegalMoves(moves);
-			generator.FilterLegalMoves(moves);
+			generator.GetLegalMoves(moves);
 			moveString += moves.MoveCount == 0 ? '#' : '+';
 		}
 		return moveString;
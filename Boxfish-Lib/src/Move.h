@@ -55,6 +55,7 @@ namespace Boxfish
 		inline SquareIndex GetToSquareIndex() const { return (SquareIndex)((m_Move >> 15) & 0x3F); }
 		inline Piece GetMovingPiece() const { return (Piece)(m_Move & 0x7); }
 		inline MoveFlag GetFlags() const { return (MoveFlag)((m_Move >> 21) & 0x7F); }
+		inline uint32_t GetPacked() const { return m_Move; }
 		inline uint64_t GetKey() const { return (uint64_t)m_Move * 89812459128486124ULL + 9182461895918651269ULL; }
 
 		inline Piece GetCapturedPiece() const { return (Piece)((m_Move >> 6) & 0x7); }
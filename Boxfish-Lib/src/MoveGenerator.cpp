@@ -54,29 +54,70 @@ namespace Boxfish
 		BOX_ASSERT(list->Index == m_CurrentIndex, "Invalid");
 	}
 
-	MoveGenerator::MoveGenerator()
-		: m_Position()
-	{
-	}
-
 	MoveGenerator::MoveGenerator(const Position& position)
-		: m_Position(position)
+		: m_Position(&position)
 	{
 	}
 
 	const Position& MoveGenerator::GetPosition() const
 	{
-		return m_Position;
+		return *m_Position;
 	}
 
 	void MoveGenerator::SetPosition(const Position& position)
 	{
-		m_Position = position;
+		m_Position = &position;
 	}
 
-	void MoveGenerator::SetPosition(Position&& position)
+	void MoveGenerator::GetLegalMoves(MoveList& moveList)
 	{
-		m_Position = std::move(position);
+		const Position& position = *m_Position;
+		const Team team = position.TeamToPlay;
+		const Team otherTeam = OtherTeam(team);
+		const SquareIndex kingSquare = position.GetKingSquare(team);
+		const BitBoard& checkers = position.InfoCache.CheckedBy[team];
+		const BitBoard& occupied = position.GetAllPieces();
+		const BitBoard& ownPieces = position.GetTeamPieces(team);
+		const BitBoard& attackablePieces = position.GetTeamPieces(otherTeam);
+
+		// The king is removed from the blockers so that it cannot step back along the ray of a checking slider
+		BitBoard kingMoves = GetNonSlidingAttacks<PIECE_KING>(kingSquare) & ~ownPieces & ~GetAttackedSquares(position, otherTeam, occupied ^ kingSquare);
+		AddMoves(moveList, position, team, kingSquare, PIECE_KING, kingMoves, attackablePieces);
+
+		// Only the king can escape double check
+		if (MoreThanOne(checkers))
+			return;
+
+		// Every other move must capture the checker or block the check
+		const BitBoard targets = checkers ? (GetBitBoardBetween(BackwardBitScan(checkers), kingSquare) | checkers) : ~ownPieces;
+		// Pinned pieces stay on the line through the king
+		const BitBoard pinned = position.GetBlockersForKing(team) & ownPieces;
+
+		BitBoard pawns = position.GetTeamPieces(team, PIECE_PAWN);
+		GeneratePawnMoves(moveList, team, position, pawns & ~pinned, targets);
+		BitBoard pinnedPawns = pawns & pinned;
+		while (pinnedPawns)
+		{
+			SquareIndex square = PopLeastSignificantBit(pinnedPawns);
+			GeneratePawnMoves(moveList, team, position, SQUARE_BITBOARDS[square], targets & GetLineBetween(kingSquare, square));
+		}
+		GenerateLegalEnPassant(moveList, team, position, targets);
+
+		for (Piece piece = PIECE_KNIGHT; piece < PIECE_KING; piece++)
+		{
+			BitBoard pieces = position.GetTeamPieces(team, piece);
+			while (pieces)
+			{
+				SquareIndex square = PopLeastSignificantBit(pieces);
+				BitBoard moves = GetAttacksBy(piece, square, team, occupied) & targets;
+				if (pinned & square)
+					moves &= GetLineBetween(kingSquare, square);
+				AddMoves(moveList, position, team, square, piece, moves, attackablePieces);
+			}
+		}
+
+		if (!checkers)
+			GenerateCastles(moveList, team, position);
 	}
 
 	void MoveGenerator::GetPseudoLegalMoves(MoveList& moveList)
@@ -84,11 +125,42 @@ namespace Boxfish
 		GeneratePseudoLegalMoves(moveList);
 	}
 
+	template<GenerationType Type>
+	void MoveGenerator::Generate(MoveList& moveList)
+	{
+		const Team team = m_Position->TeamToPlay;
+		BOX_ASSERT((Type == EVASIONS) == m_Position->InCheck() || Type == CAPTURES || Type == QUIETS, "Invalid generation type for position");
+		if constexpr (Type == CAPTURES || Type == NON_EVASIONS)
+		{
+			GeneratePawnLeftAttacks(moveList, team, *m_Position);
+			GeneratePawnRightAttacks(moveList, team, *m_Position);
+			GeneratePawnPushPromotions(moveList, team, *m_Position);
+			GeneratePieceMoves(moveList, team, *m_Position, m_Position->GetTeamPieces(OtherTeam(team)));
+		}
+		if constexpr (Type == QUIETS || Type == NON_EVASIONS)
+		{
+			GeneratePawnDoublePushes(moveList, team, *m_Position);
+			GeneratePawnQuietPushes(moveList, team, *m_Position);
+			GeneratePieceMoves(moveList, team, *m_Position, m_Position->GetNotOccupied());
+			GenerateCastles(moveList, team, *m_Position);
+		}
+		if constexpr (Type == QUIET_CHECKS)
+			GenerateQuietChecks(moveList, team, *m_Position);
+		if constexpr (Type == EVASIONS)
+			GetLegalMoves(moveList);
+	}
+
+	template void MoveGenerator::Generate<CAPTURES>(MoveList&);
+	template void MoveGenerator::Generate<QUIETS>(MoveList&);
+	template void MoveGenerator::Generate<QUIET_CHECKS>(MoveList&);
+	template void MoveGenerator::Generate<EVASIONS>(MoveList&);
+	template void MoveGenerator::Generate<NON_EVASIONS>(MoveList&);
+
 	void MoveGenerator::FilterLegalMoves(MoveList& pseudoLegalMoves)
 	{
 		if (pseudoLegalMoves.MoveCount <= 0)
 			return;
-		const BitBoard& checkers = m_Position.InfoCache.CheckedBy[m_Position.TeamToPlay];
+		const BitBoard& checkers = m_Position->InfoCache.CheckedBy[m_Position->TeamToPlay];
 		bool multipleCheckers = MoreThanOne(checkers);
 
 		int index = 0;
@@ -108,48 +180,83 @@ namespace Boxfish
 
 	bool MoveGenerator::IsLegal(const Move& move) const
 	{
-		const BitBoard& checkers = m_Position.InfoCache.CheckedBy[m_Position.TeamToPlay];
+		const BitBoard& checkers = m_Position->InfoCache.CheckedBy[m_Position->TeamToPlay];
 		bool multipleCheckers = MoreThanOne(checkers);
 		return IsMoveLegal(move, checkers, multipleCheckers);
 	}
 
+	bool MoveGenerator::IsPseudoLegal(const Move& move)
+	{
+		const Team team = m_Position->TeamToPlay;
+		const Piece piece = move.GetMovingPiece();
+		const SquareIndex from = move.GetFromSquareIndex();
+		if (move == MOVE_NONE || piece >= PIECE_MAX || !m_Position->IsPieceOnSquare(team, piece, from))
+			return false;
+
+		// Regenerate the moves of the piece and look for an exact match, moves are rarely validated so this is fast enough
+		Move buffer[MAX_MOVES];
+		MoveList moves(buffer);
+		if (piece == PIECE_PAWN)
+		{
+			GeneratePawnSinglePushes(moves, team, *m_Position);
+			GeneratePawnDoublePushes(moves, team, *m_Position);
+			GeneratePawnLeftAttacks(moves, team, *m_Position);
+			GeneratePawnRightAttacks(moves, team, *m_Position);
+		}
+		else if (piece == PIECE_KING)
+		{
+			GenerateKingMoves(moves, team, *m_Position);
+		}
+		else
+		{
+			BitBoard attacks = GetAttacksBy(piece, from, team, m_Position->GetAllPieces()) & ~m_Position->GetTeamPieces(team);
+			AddMoves(moves, *m_Position, team, from, piece, attacks, m_Position->GetTeamPieces(OtherTeam(team)));
+		}
+		for (int i = 0; i < moves.MoveCount; i++)
+		{
+			if (moves.Moves[i] == move)
+				return true;
+		}
+		return false;
+	}
+
 	bool MoveGenerator::HasAtLeastOneLegalMove(MoveList& moveList)
 	{
 		moveList.MoveCount = 0;
-		Team team = m_Position.TeamToPlay;
-		GeneratePawnSinglePushes(moveList, team, m_Position);
+		Team team = m_Position->TeamToPlay;
+		GeneratePawnSinglePushes(moveList, team, *m_Position);
 		FilterLegalMoves(moveList);
 		if (moveList.MoveCount > 0)
 			return true;
-		GeneratePawnDoublePushes(moveList, team, m_Position);
+		GeneratePawnDoublePushes(moveList, team, *m_Position);
 		FilterLegalMoves(moveList);
 		if (moveList.MoveCount > 0)
 			return true;
-		GeneratePawnLeftAttacks(moveList, team, m_Position);
+		GeneratePawnLeftAttacks(moveList, team, *m_Position);
 		FilterLegalMoves(moveList);
 		if (moveList.MoveCount > 0)
 			return true;
-		GeneratePawnRightAttacks(moveList, team, m_Position);
+		GeneratePawnRightAttacks(moveList, team, *m_Position);
 		FilterLegalMoves(moveList);
 		if (moveList.MoveCount > 0)
 			return true;
-		GenerateKingMoves(moveList, team, m_Position);
+		GenerateKingMoves(moveList, team, *m_Position);
 		FilterLegalMoves(moveList);
 		if (moveList.MoveCount > 0)
 			return true;
-		GenerateQueenMoves(moveList, team, m_Position);
+		GenerateQueenMoves(moveList, team, *m_Position);
 		FilterLegalMoves(moveList);
 		if (moveList.MoveCount > 0)
 			return true;
-		GenerateKnightMoves(moveList, team, m_Position);
+		GenerateKnightMoves(moveList, team, *m_Position);
 		FilterLegalMoves(moveList);
 		if (moveList.MoveCount > 0)
 			return true;
-		GenerateBishopMoves(moveList, team, m_Position);
+		GenerateBishopMoves(moveList, team, *m_Position);
 		FilterLegalMoves(moveList);
 		if (moveList.MoveCount > 0)
 			return true;
-		GenerateRookMoves(moveList, team, m_Position);
+		GenerateRookMoves(moveList, team, *m_Position);
 		FilterLegalMoves(moveList);
 		if (moveList.MoveCount > 0)
 			return true;
@@ -165,13 +272,13 @@ namespace Boxfish
 	{
 		for (Piece piece = PIECE_PAWN; piece < PIECE_MAX; piece++)
 		{
-			GenerateMoves(moves, m_Position.TeamToPlay, piece, m_Position);
+			GenerateMoves(moves, m_Position->TeamToPlay, piece, *m_Position);
 		}
 	}
 
 	void MoveGenerator::GenerateLegalMoves(MoveList& moveList, const MoveList& pseudoLegalMoves)
 	{
-		const BitBoard& checkers = m_Position.InfoCache.CheckedBy[m_Position.TeamToPlay];
+		const BitBoard& checkers = m_Position->InfoCache.CheckedBy[m_Position->TeamToPlay];
 		bool multipleCheckers = MoreThanOne(checkers);
 		for (int i = 0; i < pseudoLegalMoves.MoveCount; i++)
 		{
@@ -185,13 +292,16 @@ namespace Boxfish
 
 	bool MoveGenerator::IsMoveLegal(const Move& move, const BitBoard& checkers, bool multipleCheckers) const
 	{
-		SquareIndex kingSquare = m_Position.GetKingSquare(m_Position.TeamToPlay);
+		SquareIndex kingSquare = m_Position->GetKingSquare(m_Position->TeamToPlay);
 		if (move.GetFlags() & MOVE_EN_PASSANT)
 		{
-			SquareIndex captureSquare = (SquareIndex)(move.GetToSquareIndex() - GetForwardShift(m_Position.TeamToPlay));
-			BitBoard occupied = (m_Position.GetAllPieces() ^ move.GetFromSquareIndex() ^ captureSquare) | move.GetToSquareIndex();
-			return !(GetSlidingAttacks<PIECE_ROOK>(kingSquare, occupied) & m_Position.GetTeamPieces(OtherTeam(m_Position.TeamToPlay), PIECE_QUEEN, PIECE_ROOK))
-				&& !(GetSlidingAttacks<PIECE_BISHOP>(kingSquare, occupied) & m_Position.GetTeamPieces(OtherTeam(m_Position.TeamToPlay), PIECE_QUEEN, PIECE_BISHOP));
+			SquareIndex captureSquare = (SquareIndex)(move.GetToSquareIndex() - GetForwardShift(m_Position->TeamToPlay));
+			// A check by a knight or a pawn other than the captured one is not resolved by the discovered sliders test below
+			if (checkers && (multipleCheckers || !((GetBitBoardBetween(BackwardBitScan(checkers), kingSquare) | checkers) & move.GetToSquareIndex())) && !(checkers & captureSquare))
+				return false;
+			BitBoard occupied = (m_Position->GetAllPieces() ^ move.GetFromSquareIndex() ^ captureSquare) | move.GetToSquareIndex();
+			return !(GetSlidingAttacks<PIECE_ROOK>(kingSquare, occupied) & m_Position->GetTeamPieces(OtherTeam(m_Position->TeamToPlay), PIECE_QUEEN, PIECE_ROOK))
+				&& !(GetSlidingAttacks<PIECE_BISHOP>(kingSquare, occupied) & m_Position->GetTeamPieces(OtherTeam(m_Position->TeamToPlay), PIECE_QUEEN, PIECE_BISHOP));
 		}
 		if (checkers)
 		{
@@ -206,16 +316,16 @@ namespace Boxfish
 					return false;
 				}
 			}
-			else if (GetAttackers(m_Position, OtherTeam(m_Position.TeamToPlay), move.GetToSquareIndex(), m_Position.GetAllPieces() ^ move.GetFromSquareIndex()))
+			else if (GetAttackers(*m_Position, OtherTeam(m_Position->TeamToPlay), move.GetToSquareIndex(), m_Position->GetAllPieces() ^ move.GetFromSquareIndex()))
 			{
 				return false;
 			}
 		}
 		if (move.GetMovingPiece() == PIECE_KING)
 		{
-			return !IsSquareUnderAttack(m_Position, OtherTeam(m_Position.TeamToPlay), move.GetToSquareIndex());
+			return !IsSquareUnderAttack(*m_Position, OtherTeam(m_Position->TeamToPlay), move.GetToSquareIndex());
 		}
-		return !(m_Position.GetBlockersForKing(m_Position.TeamToPlay) & move.GetFromSquareIndex())
+		return !(m_Position->GetBlockersForKing(m_Position->TeamToPlay) & move.GetFromSquareIndex())
 					|| IsAligned(move.GetFromSquareIndex(), move.GetToSquareIndex(), kingSquare);
 	}
 
@@ -274,18 +384,87 @@ namespace Boxfish
 		moveList.Moves[moveList.MoveCount++] = bishopPromotion;
 	}
 
+	void MoveGenerator::GeneratePawnMoves(MoveList& moveList, Team team, const Position& position, const BitBoard& pawns, const BitBoard& targets)
+	{
+		const int forward = GetForwardShift(team);
+		const BitBoard empty = position.GetNotOccupied();
+		const BitBoard enemies = position.GetTeamPieces(OtherTeam(team)) & targets;
+		const BitBoard doublePushRank = (team == TEAM_WHITE) ? RANK_4_MASK : RANK_5_MASK;
+
+		BitBoard singlePushes = ((team == TEAM_WHITE) ? Shift<NORTH>(pawns) : Shift<SOUTH>(pawns)) & empty;
+		BitBoard doublePushes = ((team == TEAM_WHITE) ? Shift<NORTH>(singlePushes) : Shift<SOUTH>(singlePushes)) & empty & doublePushRank;
+		AddPawnMoves(moveList, position, singlePushes & targets, forward, MOVE_NORMAL);
+		AddPawnMoves(moveList, position, doublePushes & targets, 2 * forward, MOVE_DOUBLE_PAWN_PUSH);
+
+		BitBoard leftAttacks = ((team == TEAM_WHITE) ? Shift<NORTH_WEST>(pawns) : Shift<SOUTH_EAST>(pawns)) & enemies;
+		BitBoard rightAttacks = ((team == TEAM_WHITE) ? Shift<NORTH_EAST>(pawns) : Shift<SOUTH_WEST>(pawns)) & enemies;
+		AddPawnMoves(moveList, position, leftAttacks, (team == TEAM_WHITE) ? 7 : -7, MOVE_CAPTURE);
+		AddPawnMoves(moveList, position, rightAttacks, (team == TEAM_WHITE) ? 9 : -9, MOVE_CAPTURE);
+	}
+
+	void MoveGenerator::GenerateLegalEnPassant(MoveList& moveList, Team team, const Position& position, const BitBoard& targets)
+	{
+		if (position.EnpassantSquare == INVALID_SQUARE)
+			return;
+		const SquareIndex toSquare = BitBoard::SquareToBitIndex(position.EnpassantSquare);
+		// When in check the capture has to either take the checking pawn or block the check
+		if (!(targets & toSquare) && !(targets & (SquareIndex)(toSquare - GetForwardShift(team))))
+			return;
+		BitBoard pawns = GetNonSlidingAttacks<PIECE_PAWN>(toSquare, OtherTeam(team)) & position.GetTeamPieces(team, PIECE_PAWN);
+		while (pawns)
+		{
+			Move move(PopLeastSignificantBit(pawns), toSquare, PIECE_PAWN, MOVE_EN_PASSANT);
+			// Two pawns leave the rank at once so the pin information does not apply, the only possible checks are by sliders
+			if (IsMoveLegal(move, ZERO_BB, false))
+				moveList.Moves[moveList.MoveCount++] = move;
+		}
+	}
+
+	void MoveGenerator::AddPawnMoves(MoveList& moveList, const Position& position, BitBoard targets, int shift, MoveFlag flags)
+	{
+		const BitBoard promotionRanks = RANK_1_MASK | RANK_8_MASK;
+		while (targets)
+		{
+			SquareIndex toSquare = PopLeastSignificantBit(targets);
+			SquareIndex fromSquare = (SquareIndex)(toSquare - shift);
+			Piece capturedPiece = (flags & MOVE_CAPTURE) ? position.GetPieceOnSquare(toSquare) : PIECE_MAX;
+			if (promotionRanks & toSquare)
+			{
+				GeneratePawnPromotions(moveList, fromSquare, toSquare, flags, capturedPiece);
+				continue;
+			}
+			Move move(fromSquare, toSquare, PIECE_PAWN, flags);
+			if (flags & MOVE_CAPTURE)
+			{
+				move.SetCapturedPiece(capturedPiece);
+				BOX_ASSERT(move.GetCapturedPiece() != PIECE_KING, "Cannot capture king");
+			}
+			moveList.Moves[moveList.MoveCount++] = move;
+		}
+	}
+
 	void MoveGenerator::GeneratePawnSinglePushes(MoveList& moveList, Team team, const Position& position)
+	{
+		GeneratePawnQuietPushes(moveList, team, position);
+		GeneratePawnPushPromotions(moveList, team, position);
+	}
+
+	void MoveGenerator::GeneratePawnQuietPushes(MoveList& moveList, Team team, const Position& position)
 	{
 		BitBoard pawns = position.GetTeamPieces(team, PIECE_PAWN);
 		BitBoard movedPawns = ((team == TEAM_WHITE) ? (pawns << GetForwardShift(team)) : (pawns >> -GetForwardShift(team))) & position.GetNotOccupied();
-		BitBoard promotionMask = ((team == TEAM_WHITE) ? RANK_8_MASK : RANK_1_MASK);
-		BitBoard promotions = movedPawns & promotionMask;
-		movedPawns &= ~promotionMask;
+		movedPawns &= ~((team == TEAM_WHITE) ? RANK_8_MASK : RANK_1_MASK);
 		while (movedPawns)
 		{
 			SquareIndex index = PopLeastSignificantBit(movedPawns);
 			moveList.Moves[moveList.MoveCount++] = Move((SquareIndex)(index - GetForwardShift(team)), index, PIECE_PAWN, MOVE_NORMAL);
 		}
+	}
+
+	void MoveGenerator::GeneratePawnPushPromotions(MoveList& moveList, Team team, const Position& position)
+	{
+		BitBoard pawns = position.GetTeamPieces(team, PIECE_PAWN) & ((team == TEAM_WHITE) ? RANK_7_MASK : RANK_2_MASK);
+		BitBoard promotions = ((team == TEAM_WHITE) ? (pawns << GetForwardShift(team)) : (pawns >> -GetForwardShift(team))) & position.GetNotOccupied();
 		while (promotions)
 		{
 			SquareIndex index = PopLeastSignificantBit(promotions);
@@ -421,6 +600,11 @@ namespace Boxfish
 		SquareIndex square = position.GetKingSquare(team);
 		BitBoard moves = GetNonSlidingAttacks<PIECE_KING>(square) & ~position.GetTeamPieces(team);
 		AddMoves(moveList, position, team, square, PIECE_KING, moves, position.GetTeamPieces(OtherTeam(team)));
+		GenerateCastles(moveList, team, position);
+	}
+
+	void MoveGenerator::GenerateCastles(MoveList& moveList, Team team, const Position& position)
+	{
 		BitBoard occupied = position.GetAllPieces();
 		const bool inCheck = position.InCheck();
 		if (team == TEAM_WHITE && !inCheck)
@@ -471,6 +655,73 @@ namespace Boxfish
 		}
 	}
 
+	void MoveGenerator::GenerateQuietChecks(MoveList& moveList, Team team, const Position& position)
+	{
+		const Team otherTeam = OtherTeam(team);
+		const SquareIndex enemyKing = position.GetKingSquare(otherTeam);
+		const BitBoard& occupied = position.GetAllPieces();
+		const BitBoard empty = position.GetNotOccupied();
+		// Pieces that discover a check from a slider behind them when they leave the line to the enemy king
+		const BitBoard discoverers = position.GetBlockersForKing(otherTeam) & position.GetTeamPieces(team);
+
+		// Promotions are generated as captures
+		const BitBoard pawnTargets = empty & ~(RANK_1_MASK | RANK_8_MASK);
+		const BitBoard pawnChecks = GetNonSlidingAttacks<PIECE_PAWN>(enemyKing, otherTeam);
+		BitBoard pawns = position.GetTeamPieces(team, PIECE_PAWN);
+		GeneratePawnMoves(moveList, team, position, pawns & ~discoverers, pawnTargets & pawnChecks);
+		pawns &= discoverers;
+		while (pawns)
+		{
+			SquareIndex square = PopLeastSignificantBit(pawns);
+			GeneratePawnMoves(moveList, team, position, SQUARE_BITBOARDS[square], pawnTargets & (pawnChecks | ~GetLineBetween(enemyKing, square)));
+		}
+
+		for (Piece piece = PIECE_KNIGHT; piece < PIECE_KING; piece++)
+		{
+			const BitBoard checkSquares = GetAttacksBy(piece, enemyKing, otherTeam, occupied);
+			BitBoard pieces = position.GetTeamPieces(team, piece);
+			while (pieces)
+			{
+				SquareIndex square = PopLeastSignificantBit(pieces);
+				BitBoard targets = (discoverers & square) ? (checkSquares | ~GetLineBetween(enemyKing, square)) : checkSquares;
+				AddMoves(moveList, position, team, square, piece, GetAttacksBy(piece, square, team, occupied) & empty & targets, ZERO_BB);
+			}
+		}
+
+		// The king can only give a discovered check
+		const SquareIndex kingSquare = position.GetKingSquare(team);
+		if (discoverers & kingSquare)
+			AddMoves(moveList, position, team, kingSquare, PIECE_KING, GetNonSlidingAttacks<PIECE_KING>(kingSquare) & empty & ~GetLineBetween(enemyKing, kingSquare), ZERO_BB);
+
+		// Castling checks through the rook which is rare enough to test after generation
+		const int castlesStart = moveList.MoveCount;
+		GenerateCastles(moveList, team, position);
+		int index = castlesStart;
+		for (int i = castlesStart; i < moveList.MoveCount; i++)
+		{
+			if (GivesCheck(position, moveList.Moves[i]))
+				moveList.Moves[index++] = moveList.Moves[i];
+		}
+		moveList.MoveCount = index;
+	}
+
+	void MoveGenerator::GeneratePieceMoves(MoveList& moveList, Team team, const Position& position, const BitBoard& targets)
+	{
+		const BitBoard& occupied = position.GetAllPieces();
+		const BitBoard& attackablePieces = position.GetTeamPieces(OtherTeam(team));
+		for (Piece piece = PIECE_KNIGHT; piece < PIECE_KING; piece++)
+		{
+			BitBoard pieces = position.GetTeamPieces(team, piece);
+			while (pieces)
+			{
+				SquareIndex index = PopLeastSignificantBit(pieces);
+				AddMoves(moveList, position, team, index, piece, GetAttacksBy(piece, index, team, occupied) & targets, attackablePieces);
+			}
+		}
+		SquareIndex kingSquare = position.GetKingSquare(team);
+		AddMoves(moveList, position, team, kingSquare, PIECE_KING, GetNonSlidingAttacks<PIECE_KING>(kingSquare) & targets, attackablePieces);
+	}
+
 	void MoveGenerator::AddMoves(MoveList& moveList, const Position& position, Team team, SquareIndex fromSquare, Piece pieceType, const BitBoard& moves, const BitBoard& attackablePieces)
 	{
 		BitBoard nonAttacks = moves & ~attackablePieces;
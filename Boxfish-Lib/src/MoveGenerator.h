@@ -15,6 +15,21 @@ namespace Boxfish
 	constexpr int MAX_MOVES = 218;
 	constexpr int MOVE_POOL_SIZE = MAX_MOVES * 2 * (MAX_PLY + 1);
 
+	// Evasions are legal, every other type is pseudo legal
+	enum GenerationType
+	{
+		// Captures, en passant and all promotions
+		CAPTURES,
+		// Everything not generated by CAPTURES
+		QUIETS,
+		// Quiet moves that give check, only valid when not in check
+		QUIET_CHECKS,
+		// Only valid when in check
+		EVASIONS,
+		// Only valid when not in check
+		NON_EVASIONS
+	};
+
 	class MovePool;
 
 	class BOX_API MoveList
@@ -53,22 +68,27 @@ namespace Boxfish
 		void FreeList(const MoveList* list);
 	};
 
+	// Generates moves for a position it does not own, the position must outlive the generator
 	class BOX_API MoveGenerator
 	{
 	private:
-		Position m_Position;
+		const Position* m_Position;
 
 	public:
-		MoveGenerator();
 		MoveGenerator(const Position& position);
 
 		const Position& GetPosition() const;
 		void SetPosition(const Position& position);
-		void SetPosition(Position&& position);
 
+		// Generates only legal moves using the check and pin information in Position::InfoCache
+		void GetLegalMoves(MoveList& moveList);
 		void GetPseudoLegalMoves(MoveList& moveList);
+		template<GenerationType Type>
+		void Generate(MoveList& moveList);
 		void FilterLegalMoves(MoveList& pseudoLegalMoves);
 		bool IsLegal(const Move& move) const;
+		// Used to validate moves that were not generated for this position (eg. from the transposition table)
+		bool IsPseudoLegal(const Move& move);
 
 		bool HasAtLeastOneLegalMove(MoveList& list);
 
@@ -82,7 +102,13 @@ namespace Boxfish
 		void GenerateMoves(MoveList& moveList, Team team, Piece pieceType, const Position& position);
 
 		void GeneratePawnPromotions(MoveList& moveList, SquareIndex fromSquare, SquareIndex toSquare, MoveFlag flags, Piece capturedPiece);
+		// Pushes and captures (excluding en passant) by the given pawns that land on the target squares
+		void GeneratePawnMoves(MoveList& moveList, Team team, const Position& position, const BitBoard& pawns, const BitBoard& targets);
+		void GenerateLegalEnPassant(MoveList& moveList, Team team, const Position& position, const BitBoard& targets);
+		void AddPawnMoves(MoveList& moveList, const Position& position, BitBoard targets, int shift, MoveFlag flags);
 		void GeneratePawnSinglePushes(MoveList& moveList, Team team, const Position& position);
+		void GeneratePawnQuietPushes(MoveList& moveList, Team team, const Position& position);
+		void GeneratePawnPushPromotions(MoveList& moveList, Team team, const Position& position);
 		void GeneratePawnDoublePushes(MoveList& moveList, Team team, const Position& position);
 		void GeneratePawnLeftAttacks(MoveList& moveList, Team team, const Position& position);
 		void GeneratePawnRightAttacks(MoveList& moveList, Team team, const Position& position);
@@ -92,6 +118,10 @@ namespace Boxfish
 		void GenerateRookMoves(MoveList& moveList, Team team, const Position& position);
 		void GenerateQueenMoves(MoveList& moveList, Team team, const Position& position);
 		void GenerateKingMoves(MoveList& moveList, Team team, const Position& position);
+		void GenerateCastles(MoveList& moveList, Team team, const Position& position);
+		void GenerateQuietChecks(MoveList& moveList, Team team, const Position& position);
+		// Non pawn moves to the target squares, excluding castling
+		void GeneratePieceMoves(MoveList& moveList, Team team, const Position& position, const BitBoard& targets);
 
 		void AddMoves(MoveList& moveList, const Position& position, Team team, SquareIndex fromSquare, Piece pieceType, const BitBoard& moves, const BitBoard& attackablePieces);
 	};
@@ -10,106 +10,219 @@ namespace Boxfish
 	constexpr ValueType SCORE_KILLER = 2000;
 	constexpr ValueType SCORE_BAD_CAPTURE = -1000;
 
+	ValueType ScoreCapture(const Move& move, const Move& prevMove)
+	{
+		if (move.IsCapture())
+		{
+			ValueType score = SCORE_GOOD_CAPTURE + GetPieceValue(move.GetCapturedPiece()) - GetPieceValue(move.GetMovingPiece());
+			if (prevMove != MOVE_NONE && move.GetToSquareIndex() == prevMove.GetToSquareIndex())
+				score += 250; // Recapture
+			return score;
+		}
+		BOX_ASSERT(move.IsPromotion(), "Invalid capture");
+		Piece promotion = move.GetPromotionPiece();
+		if (promotion == PIECE_QUEEN || promotion == PIECE_KNIGHT)
+			return SCORE_PROMOTION + GetPieceValue(promotion);
+		return SCORE_BAD_PROMOTION + GetPieceValue(promotion);
+	}
+
+	ValueType ScoreQuiet(const Position& position, const OrderingTables& tables, const Move& move)
+	{
+		ValueType score = 0;
+		if (move.IsAdvancedPawnPush(position.TeamToPlay) || (move.GetFlags() & (MOVE_DOUBLE_PAWN_PUSH | MOVE_KINGSIDE_CASTLE | MOVE_QUEENSIDE_CASTLE)))
+		{
+			score += 250;
+			if (move.GetMovingPiece() == PIECE_PAWN && BitBoard::FileOfIndex(move.GetToSquareIndex()) == FILE_H)
+				score += 45;
+		}
+
+		// Central pawn push
+		constexpr BitBoard Center = (RANK_4_MASK | RANK_5_MASK) & (FILE_C_MASK | FILE_D_MASK | FILE_E_MASK | FILE_F_MASK);
+		if (move.GetMovingPiece() == PIECE_PAWN && (Center & move.GetToSquareIndex()))
+			score += 50;
+
+		// History Heuristic
+		ValueType history = tables.History[position.TeamToPlay][move.GetFromSquareIndex()][move.GetToSquareIndex()];
+		ValueType butterfly = tables.Butterfly[position.TeamToPlay][move.GetFromSquareIndex()][move.GetToSquareIndex()];
+		if (butterfly != 0 && history > butterfly)
+		{
+			score += history * 50 / butterfly;
+		}
+		return score;
+	}
+
 	MoveSelector::MoveSelector(MoveList* moves, const Position* currentPosition, Move ttMove, Move counterMove, Move prevMove, const OrderingTables* tables, const Move* killers)
-		: m_Moves(moves), m_CurrentPosition(currentPosition), m_ttMove(ttMove), m_CounterMove(counterMove), m_Tables(tables), m_Killers(killers), m_CurrentIndex(0), m_CurrentStage(TTMove)
+		: m_Moves(moves), m_CurrentPosition(currentPosition), m_Generator(*currentPosition), m_ttMove(ttMove), m_CounterMove(counterMove), m_PrevMove(prevMove), m_Tables(tables),
+		m_CurrentIndex(0), m_EndIndex(0), m_BadCapturesEnd(0), m_CurrentStage(currentPosition->InCheck() ? EvasionTTMove : TTMove)
 	{
+		m_Killers[0] = killers ? killers[0] : MOVE_NONE;
+		m_Killers[1] = killers ? killers[1] : MOVE_NONE;
+		m_Moves->MoveCount = 0;
 		if (ttMove == MOVE_NONE)
 			m_CurrentStage++;
-		for (int index = m_CurrentIndex; index < m_Moves->MoveCount; ++index)
+	}
+
+	Move MoveSelector::GetNextMove(bool skipQuiets)
+	{
+		switch (m_CurrentStage)
 		{
-			ValueType score = 0;
-			Move& move = m_Moves->Moves[index];
-			if (move.IsCapture())
+		case TTMove:
+		case EvasionTTMove:
+			m_CurrentStage++;
+			return m_ttMove;
+
+		case GenerateCaptures:
+			m_Generator.Generate<CAPTURES>(*m_Moves);
+			m_CurrentIndex = 0;
+			m_EndIndex = m_Moves->MoveCount;
+			ScoreCaptures();
+			m_CurrentStage++;
+			[[fallthrough]];
+
+		case GoodCaptures:
+			while (m_CurrentIndex < m_EndIndex)
 			{
-				if (SeeGE(*currentPosition, move, -30))
+				Move move = SelectBest();
+				if (move == m_ttMove)
+					continue;
+				// Defer losing captures and under promotions until after the quiet moves
+				if (!move.IsCapture() && move.GetValue() < SCORE_PROMOTION)
 				{
-					score = SCORE_GOOD_CAPTURE + GetPieceValue(move.GetCapturedPiece()) - GetPieceValue(move.GetMovingPiece());
+					m_Moves->Moves[m_BadCapturesEnd++] = move;
+					continue;
 				}
-				else
+				if (move.IsCapture() && !SeeGE(*m_CurrentPosition, move, -30))
 				{
-					score = SCORE_BAD_CAPTURE + GetPieceValue(move.GetCapturedPiece()) - GetPieceValue(move.GetMovingPiece());
+					move.SetValue(move.GetValue() - SCORE_GOOD_CAPTURE + SCORE_BAD_CAPTURE);
+					m_Moves->Moves[m_BadCapturesEnd++] = move;
+					continue;
 				}
-				if (prevMove != MOVE_NONE && move.GetToSquareIndex() == prevMove.GetToSquareIndex())
-					score += 250; // Recapture
+				return move;
 			}
-			else if (move.IsPromotion())
+			m_CurrentStage++;
+			[[fallthrough]];
+
+		case FirstKiller:
+		case SecondKiller:
+		case CounterMove:
+			while (m_CurrentStage <= CounterMove)
 			{
-				Piece promotion = move.GetPromotionPiece();
-				if (promotion == PIECE_QUEEN || promotion == PIECE_KNIGHT)
-					score = SCORE_PROMOTION + GetPieceValue(promotion);
-				else
-					score = SCORE_BAD_PROMOTION + GetPieceValue(promotion);
+				Move move = (m_CurrentStage == CounterMove) ? m_CounterMove : m_Killers[m_CurrentStage - FirstKiller];
+				m_CurrentStage++;
+				if (!skipQuiets && IsValidRefutation(move))
+					return move;
 			}
-			else
+			[[fallthrough]];
+
+		case GenerateQuiets:
+			if (!skipQuiets)
 			{
-				if (killers)
-				{
-					if (move == killers[0])
-						score = SCORE_KILLER;
-					else if (move == killers[1])
-						score = SCORE_KILLER - 200;
-				}
+				m_Generator.Generate<QUIETS>(*m_Moves);
+				m_CurrentIndex = m_EndIndex;
+				m_EndIndex = m_Moves->MoveCount;
+				ScoreQuiets();
+			}
+			m_CurrentStage++;
+			[[fallthrough]];
 
-				if (move.IsAdvancedPawnPush(currentPosition->TeamToPlay) || (move.GetFlags() & (MOVE_DOUBLE_PAWN_PUSH | MOVE_KINGSIDE_CASTLE | MOVE_QUEENSIDE_CASTLE)))
-				{
-					score += 250;
-					if (move.GetMovingPiece() == PIECE_PAWN && BitBoard::FileOfIndex(move.GetToSquareIndex()) == FILE_H)
-						score += 45;
-				}
+		case Quiets:
+			while (!skipQuiets && m_CurrentIndex < m_EndIndex)
+			{
+				Move move = SelectBest();
+				if (move != m_ttMove && !IsRefutation(move))
+					return move;
+			}
+			m_CurrentIndex = 0;
+			m_EndIndex = m_BadCapturesEnd;
+			m_CurrentStage++;
+			[[fallthrough]];
 
-				// Central pawn push
-				constexpr BitBoard Center = (RANK_4_MASK | RANK_5_MASK) & (FILE_C_MASK | FILE_D_MASK | FILE_E_MASK | FILE_F_MASK);
-				if (move.GetMovingPiece() == PIECE_PAWN && (Center & move.GetToSquareIndex()))
-					score += 50;
+		case BadCaptures:
+			if (m_CurrentIndex < m_EndIndex)
+				return SelectBest();
+			m_CurrentStage = Done;
+			return MOVE_NONE;
 
-				// Counter move
-				if (move == counterMove)
-				{
-					score += 1500;
-				}
-				// History Heuristic
-				ValueType history = m_Tables->History[currentPosition->TeamToPlay][move.GetFromSquareIndex()][move.GetToSquareIndex()];
-				ValueType butterfly = m_Tables->Butterfly[currentPosition->TeamToPlay][move.GetFromSquareIndex()][move.GetToSquareIndex()];
-				if (butterfly != 0 && history > butterfly)
-				{
-					score += history * 50 / butterfly;
-				}
+		case GenerateEvasions:
+			m_Generator.Generate<EVASIONS>(*m_Moves);
+			m_CurrentIndex = 0;
+			m_EndIndex = m_Moves->MoveCount;
+			ScoreEvasions();
+			m_CurrentStage++;
+			[[fallthrough]];
+
+		case Evasions:
+			while (m_CurrentIndex < m_EndIndex)
+			{
+				Move move = SelectBest();
+				if (move != m_ttMove)
+					return move;
 			}
+			m_CurrentStage = Done;
+			return MOVE_NONE;
 
-			move.SetValue(score);
+		case Done:
+			break;
 		}
+		return MOVE_NONE;
 	}
 
-	Move MoveSelector::GetNextMove(bool skipQuiets)
+	void MoveSelector::ScoreCaptures()
 	{
-		if (m_CurrentStage == TTMove && m_ttMove != MOVE_NONE)
+		for (int index = m_CurrentIndex; index < m_EndIndex; index++)
 		{
-			m_CurrentStage++;
-			return m_ttMove;
+			Move& move = m_Moves->Moves[index];
+			move.SetValue(ScoreCapture(move, m_PrevMove));
 		}
-		if (m_CurrentIndex >= m_Moves->MoveCount)
-			return MOVE_NONE;
+	}
+
+	void MoveSelector::ScoreQuiets()
+	{
+		for (int index = m_CurrentIndex; index < m_EndIndex; index++)
+		{
+			Move& move = m_Moves->Moves[index];
+			move.SetValue(ScoreQuiet(*m_CurrentPosition, *m_Tables, move));
+		}
+	}
+
+	void MoveSelector::ScoreEvasions()
+	{
+		for (int index = m_CurrentIndex; index < m_EndIndex; index++)
+		{
+			Move& move = m_Moves->Moves[index];
+			move.SetValue(move.IsCaptureOrPromotion() ? ScoreCapture(move, m_PrevMove) : ScoreQuiet(*m_CurrentPosition, *m_Tables, move));
+		}
+	}
+
+	Move MoveSelector::SelectBest()
+	{
+		BOX_ASSERT(m_CurrentIndex < m_EndIndex, "No moves to select");
 		int bestIndex = m_CurrentIndex;
-		ValueType bestScore = -SCORE_MATE;
-		ValueType value;
-		for (int index = m_CurrentIndex; index < m_Moves->MoveCount; ++index)
+		for (int index = m_CurrentIndex + 1; index < m_EndIndex; ++index)
 		{
-			const Move& move = m_Moves->Moves[index];
-			value = move.GetValue();
-			if (value > bestScore)
-			{
+			if (m_Moves->Moves[index].GetValue() > m_Moves->Moves[bestIndex].GetValue())
 				bestIndex = index;
-				bestScore = value;
-			}
 		}
 		if (m_CurrentIndex != bestIndex)
 		{
 			std::swap(m_Moves->Moves[m_CurrentIndex], m_Moves->Moves[bestIndex]);
 		}
-		Move mv = m_Moves->Moves[m_CurrentIndex++];
-		if (mv == m_ttMove)
-			return GetNextMove(skipQuiets);
-		return mv;
+		return m_Moves->Moves[m_CurrentIndex++];
+	}
+
+	bool MoveSelector::IsRefutation(const Move& move) const
+	{
+		return move == m_Killers[0] || move == m_Killers[1] || move == m_CounterMove;
+	}
+
+	bool MoveSelector::IsValidRefutation(const Move& move)
+	{
+		if (move == MOVE_NONE || move == m_ttMove || move.IsCaptureOrPromotion())
+			return false;
+		// Don't return the same move twice
+		if ((m_CurrentStage > SecondKiller && move == m_Killers[0]) || (m_CurrentStage > CounterMove && move == m_Killers[1]))
+			return false;
+		return m_Generator.IsPseudoLegal(move);
 	}
 
 	void ScoreMoveQuiescence(const Position& position, Move& move)
@@ -140,19 +253,19 @@ namespace Boxfish
 		}
 	}
 
-	QuiescenceMoveSelector::QuiescenceMoveSelector(const Position& position, MoveList& legalMoves, bool generateChecks)
-		: m_LegalMoves(legalMoves), m_CurrentIndex(0), m_NumberOfCaptures(0), m_InCheck(generateChecks)
+	QuiescenceMoveSelector::QuiescenceMoveSelector(const Position& position, MoveList& moves, bool generateChecks)
+		: m_Moves(moves), m_CurrentIndex(0), m_NumberOfCaptures(0), m_InCheck(generateChecks)
 	{
-		ScoreMovesQuiescence(position, m_LegalMoves);
+		ScoreMovesQuiescence(position, m_Moves);
 		if (m_InCheck)
 		{
-			m_NumberOfCaptures = m_LegalMoves.MoveCount;
+			m_NumberOfCaptures = m_Moves.MoveCount;
 		}
 		else
 		{
-			for (int i = 0; i < m_LegalMoves.MoveCount; ++i)
+			for (int i = 0; i < m_Moves.MoveCount; ++i)
 			{
-				const Move& m = m_LegalMoves.Moves[i];
+				const Move& m = m_Moves.Moves[i];
 				if (m.GetValue() > SCORE_NONE)
 					m_NumberOfCaptures++;
 			}
@@ -170,9 +283,9 @@ namespace Boxfish
 		size_t bestIndex = 0;
 		ValueType bestScore = SCORE_NONE - 1;
 		ValueType value;
-		for (int index = m_CurrentIndex; index < m_LegalMoves.MoveCount; ++index)
+		for (int index = m_CurrentIndex; index < m_Moves.MoveCount; ++index)
 		{
-			const Move& move = m_LegalMoves.Moves[index];
+			const Move& move = m_Moves.Moves[index];
 			value = move.GetValue();
 			if (value > bestScore)
 			{
@@ -180,8 +293,8 @@ namespace Boxfish
 				bestIndex = index;
 			}
 		}
-		std::swap(m_LegalMoves.Moves[m_CurrentIndex], m_LegalMoves.Moves[bestIndex]);
-		return m_LegalMoves.Moves[m_CurrentIndex++];
+		std::swap(m_Moves.Moves[m_CurrentIndex], m_Moves.Moves[bestIndex]);
+		return m_Moves.Moves[m_CurrentIndex++];
 	}
 
 }
@@ -34,29 +34,55 @@ namespace Boxfish
 		}
 	};
 
+	// Staged move picker, moves are generated lazily so that a cutoff by an early move saves generating and scoring the rest
+	// Returned moves are pseudo legal, legality is left to the caller. Evasions are always legal
 	class BOX_API MoveSelector
 	{
 	public:
 		enum SelectorStage
 		{
 			TTMove,
-			Any
+			GenerateCaptures,
+			GoodCaptures,
+			FirstKiller,
+			SecondKiller,
+			CounterMove,
+			GenerateQuiets,
+			Quiets,
+			BadCaptures,
+			EvasionTTMove,
+			GenerateEvasions,
+			Evasions,
+			Done
 		};
 
 	private:
 		MoveList* m_Moves;
 		const Position* m_CurrentPosition;
+		MoveGenerator m_Generator;
 		Move m_ttMove;
 		Move m_CounterMove;
+		Move m_PrevMove;
 		const OrderingTables* m_Tables;
-		const Move* m_Killers;
+		Move m_Killers[2];
 
 		int m_CurrentIndex;
+		int m_EndIndex;
+		int m_BadCapturesEnd;
 		SelectorStage m_CurrentStage;
 
 	public:
+		// ttMove must be legal in the position or MOVE_NONE, moves is used as storage for the generated moves
 		MoveSelector(MoveList* moves, const Position* currentPosition, Move ttMove, Move counterMove, Move prevMove, const OrderingTables* tables, const Move* killers);
 		Move GetNextMove(bool skipQuiets);
+
+	private:
+		void ScoreCaptures();
+		void ScoreQuiets();
+		void ScoreEvasions();
+		Move SelectBest();
+		bool IsRefutation(const Move& move) const;
+		bool IsValidRefutation(const Move& move);
 	};
 
 	inline MoveSelector::SelectorStage operator++(MoveSelector::SelectorStage& stage, int)
@@ -66,16 +92,17 @@ namespace Boxfish
 		return result;
 	}
 
+	// Orders moves generated with CAPTURES, or EVASIONS when in check in which case every move is returned
 	class BOX_API QuiescenceMoveSelector
 	{
 	private:
-		MoveList& m_LegalMoves;
+		MoveList& m_Moves;
 		size_t m_CurrentIndex;
 		size_t m_NumberOfCaptures;
 		bool m_InCheck;
 
 	public:
-		QuiescenceMoveSelector(const Position& position, MoveList& legalMoves, bool generateChecks);
+		QuiescenceMoveSelector(const Position& position, MoveList& moves, bool generateChecks);
 
 		bool Empty() const;
 		Move GetNextMove();
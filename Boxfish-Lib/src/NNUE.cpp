@@ -0,0 +1,278 @@
+#include "NNUE.h"
+#include "Evaluation.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BOX_NNUE_AVX2
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#define BOX_NNUE_SSE4
+#endif
+
+namespace Boxfish
+{
+
+	static constexpr char NETWORK_MAGIC[4] = { 'B', 'X', 'N', 'N' };
+	static constexpr uint32_t NETWORK_VERSION = 1;
+
+	// Quantization of the clipped first layer and of the output weights
+	static constexpr int ACTIVATION_MAX = 127;
+	static constexpr int OUTPUT_WEIGHT_SCALE = 64;
+	// Centipawns per unit of the unquantized network output
+	static constexpr int OUTPUT_SCALE = 400;
+
+	struct NetworkFileHeader
+	{
+	public:
+		char Magic[4];
+		uint32_t Version;
+		uint32_t InputDimensions;
+		uint32_t HalfDimensions;
+	};
+
+	struct Network
+	{
+	public:
+		alignas(32) int16_t FeatureBiases[NNUE_HALF_DIMENSIONS];
+		alignas(32) int16_t OutputWeights[2 * NNUE_HALF_DIMENSIONS];
+		int32_t OutputBias;
+		std::vector<int16_t> FeatureWeights;
+	};
+
+	static std::unique_ptr<Network> s_Network;
+
+	bool LoadNetwork(const std::string& filename)
+	{
+		std::ifstream file(filename, std::ios::binary | std::ios::ate);
+		if (!file.good())
+			return false;
+		size_t fileSize = (size_t)file.tellg();
+		file.seekg(0);
+
+		constexpr size_t expectedSize = sizeof(NetworkFileHeader) +
+			sizeof(int16_t) * (NNUE_HALF_DIMENSIONS + (size_t)NNUE_INPUT_DIMENSIONS * NNUE_HALF_DIMENSIONS + 2 * NNUE_HALF_DIMENSIONS) + sizeof(int32_t);
+
+		NetworkFileHeader header;
+		if (fileSize != expectedSize || !file.read((char*)&header, sizeof(header)))
+			return false;
+		if (memcmp(header.Magic, NETWORK_MAGIC, sizeof(header.Magic)) != 0 || header.Version != NETWORK_VERSION ||
+			header.InputDimensions != NNUE_INPUT_DIMENSIONS || header.HalfDimensions != NNUE_HALF_DIMENSIONS)
+			return false;
+
+		std::unique_ptr<Network> network = std::make_unique<Network>();
+		network->FeatureWeights.resize((size_t)NNUE_INPUT_DIMENSIONS * NNUE_HALF_DIMENSIONS);
+		file.read((char*)network->FeatureBiases, sizeof(network->FeatureBiases));
+		file.read((char*)network->FeatureWeights.data(), network->FeatureWeights.size() * sizeof(int16_t));
+		file.read((char*)network->OutputWeights, sizeof(network->OutputWeights));
+		file.read((char*)&network->OutputBias, sizeof(network->OutputBias));
+		if (!file)
+			return false;
+		s_Network = std::move(network);
+		return true;
+	}
+
+	bool IsNetworkLoaded()
+	{
+		return s_Network != nullptr;
+	}
+
+	// =================================================================================================================================
+	// KERNELS
+	// =================================================================================================================================
+
+	inline void AddFeatureWeights(int16_t* accumulator, const int16_t* weights)
+	{
+#if defined(BOX_NNUE_AVX2)
+		for (int i = 0; i < NNUE_HALF_DIMENSIONS; i += 16)
+		{
+			__m256i* values = (__m256i*)(accumulator + i);
+			_mm256_store_si256(values, _mm256_add_epi16(_mm256_load_si256(values), _mm256_loadu_si256((const __m256i*)(weights + i))));
+		}
+#elif defined(BOX_NNUE_SSE4)
+		for (int i = 0; i < NNUE_HALF_DIMENSIONS; i += 8)
+		{
+			__m128i* values = (__m128i*)(accumulator + i);
+			_mm_store_si128(values, _mm_add_epi16(_mm_load_si128(values), _mm_loadu_si128((const __m128i*)(weights + i))));
+		}
+#else
+		for (int i = 0; i < NNUE_HALF_DIMENSIONS; i++)
+			accumulator[i] += weights[i];
+#endif
+	}
+
+	inline void SubtractFeatureWeights(int16_t* accumulator, const int16_t* weights)
+	{
+#if defined(BOX_NNUE_AVX2)
+		for (int i = 0; i < NNUE_HALF_DIMENSIONS; i += 16)
+		{
+			__m256i* values = (__m256i*)(accumulator + i);
+			_mm256_store_si256(values, _mm256_sub_epi16(_mm256_load_si256(values), _mm256_loadu_si256((const __m256i*)(weights + i))));
+		}
+#elif defined(BOX_NNUE_SSE4)
+		for (int i = 0; i < NNUE_HALF_DIMENSIONS; i += 8)
+		{
+			__m128i* values = (__m128i*)(accumulator + i);
+			_mm_store_si128(values, _mm_sub_epi16(_mm_load_si128(values), _mm_loadu_si128((const __m128i*)(weights + i))));
+		}
+#else
+		for (int i = 0; i < NNUE_HALF_DIMENSIONS; i++)
+			accumulator[i] -= weights[i];
+#endif
+	}
+
+	// Dot product of clamp(accumulator, 0, ACTIVATION_MAX) with the output weights
+	inline int32_t ClippedDotProduct(const int16_t* accumulator, const int16_t* weights)
+	{
+#if defined(BOX_NNUE_AVX2)
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i activationMax = _mm256_set1_epi16(ACTIVATION_MAX);
+		__m256i sum = _mm256_setzero_si256();
+		for (int i = 0; i < NNUE_HALF_DIMENSIONS; i += 16)
+		{
+			__m256i values = _mm256_min_epi16(_mm256_max_epi16(_mm256_load_si256((const __m256i*)(accumulator + i)), zero), activationMax);
+			sum = _mm256_add_epi32(sum, _mm256_madd_epi16(values, _mm256_loadu_si256((const __m256i*)(weights + i))));
+		}
+		__m128i sum128 = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+		sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(1, 0, 3, 2)));
+		sum128 = _mm_add_epi32(sum128, _mm_shuffle_epi32(sum128, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtsi128_si32(sum128);
+#elif defined(BOX_NNUE_SSE4)
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i activationMax = _mm_set1_epi16(ACTIVATION_MAX);
+		__m128i sum = _mm_setzero_si128();
+		for (int i = 0; i < NNUE_HALF_DIMENSIONS; i += 8)
+		{
+			__m128i values = _mm_min_epi16(_mm_max_epi16(_mm_load_si128((const __m128i*)(accumulator + i)), zero), activationMax);
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(values, _mm_loadu_si128((const __m128i*)(weights + i))));
+		}
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtsi128_si32(sum);
+#else
+		int32_t sum = 0;
+		for (int i = 0; i < NNUE_HALF_DIMENSIONS; i++)
+			sum += std::clamp<int32_t>(accumulator[i], 0, ACTIVATION_MAX) * weights[i];
+		return sum;
+#endif
+	}
+
+	// =================================================================================================================================
+	// ACCUMULATOR
+	// =================================================================================================================================
+
+	// Squares are mirrored vertically for black so that both perspectives share the same weights
+	inline const int16_t* GetFeatureWeights(Team perspective, SquareIndex kingSquare, Team team, Piece piece, SquareIndex square)
+	{
+		const int flip = (perspective == TEAM_WHITE) ? 0 : 56;
+		const int pieceIndex = 2 * piece + ((team == perspective) ? 0 : 1);
+		const size_t index = ((size_t)((kingSquare ^ flip) * NNUE_PIECE_FEATURES + pieceIndex) * SQUARE_MAX + (square ^ flip));
+		return &s_Network->FeatureWeights[index * NNUE_HALF_DIMENSIONS];
+	}
+
+	static void RefreshAccumulator(const Position& position, Team perspective, NNUEAccumulator& accumulator)
+	{
+		int16_t* values = accumulator.Values[perspective];
+		memcpy(values, s_Network->FeatureBiases, sizeof(s_Network->FeatureBiases));
+		const SquareIndex kingSquare = position.GetKingSquare(perspective);
+		for (Team team : { TEAM_WHITE, TEAM_BLACK })
+		{
+			for (Piece piece = PIECE_PAWN; piece < PIECE_KING; piece++)
+			{
+				BitBoard pieces = position.GetTeamPieces(team, piece);
+				while (pieces)
+				{
+					SquareIndex square = PopLeastSignificantBit(pieces);
+					AddFeatureWeights(values, GetFeatureWeights(perspective, kingSquare, team, piece, square));
+				}
+			}
+		}
+		accumulator.Computed[perspective] = true;
+	}
+
+	// Applies the features changed by a move of team to one perspective, that perspective's king must not be the moving piece
+	static void UpdateAccumulator(const NNUEAccumulator& previous, NNUEAccumulator& accumulator, Team perspective, SquareIndex kingSquare, Team team, Move move)
+	{
+		int16_t* values = accumulator.Values[perspective];
+		memcpy(values, previous.Values[perspective], sizeof(accumulator.Values[perspective]));
+		accumulator.Computed[perspective] = true;
+		if (move == MOVE_NONE)
+			return;
+
+		const MoveFlag flags = move.GetFlags();
+		const Piece piece = move.GetMovingPiece();
+		const SquareIndex to = move.GetToSquareIndex();
+		if (piece != PIECE_KING)
+		{
+			SubtractFeatureWeights(values, GetFeatureWeights(perspective, kingSquare, team, piece, move.GetFromSquareIndex()));
+			AddFeatureWeights(values, GetFeatureWeights(perspective, kingSquare, team, (flags & MOVE_PROMOTION) ? move.GetPromotionPiece() : piece, to));
+		}
+		if (flags & MOVE_CAPTURE)
+		{
+			SubtractFeatureWeights(values, GetFeatureWeights(perspective, kingSquare, OtherTeam(team), move.GetCapturedPiece(), to));
+		}
+		else if (flags & MOVE_EN_PASSANT)
+		{
+			SubtractFeatureWeights(values, GetFeatureWeights(perspective, kingSquare, OtherTeam(team), PIECE_PAWN, (SquareIndex)(to - GetForwardShift(team))));
+		}
+		else if (flags & (MOVE_KINGSIDE_CASTLE | MOVE_QUEENSIDE_CASTLE))
+		{
+			const bool kingSide = flags & MOVE_KINGSIDE_CASTLE;
+			const SquareIndex rookFrom = (team == TEAM_WHITE) ? (kingSide ? h1 : a1) : (kingSide ? h8 : a8);
+			const SquareIndex rookTo = (team == TEAM_WHITE) ? (kingSide ? f1 : d1) : (kingSide ? f8 : d8);
+			SubtractFeatureWeights(values, GetFeatureWeights(perspective, kingSquare, team, PIECE_ROOK, rookFrom));
+			AddFeatureWeights(values, GetFeatureWeights(perspective, kingSquare, team, PIECE_ROOK, rookTo));
+		}
+	}
+
+	static ValueType EvaluateAccumulator(const NNUEAccumulator& accumulator, Team team)
+	{
+		int32_t output = s_Network->OutputBias;
+		output += ClippedDotProduct(accumulator.Values[team], s_Network->OutputWeights);
+		output += ClippedDotProduct(accumulator.Values[OtherTeam(team)], s_Network->OutputWeights + NNUE_HALF_DIMENSIONS);
+		ValueType score = (ValueType)((int64_t)output * OUTPUT_SCALE / (ACTIVATION_MAX * OUTPUT_WEIGHT_SCALE));
+		return std::clamp(score, -SCORE_MATE / 2, SCORE_MATE / 2);
+	}
+
+	ValueType EvaluateNNUE(const Position& position, Team team)
+	{
+		BOX_ASSERT(s_Network, "No network loaded");
+		NNUEAccumulator accumulator;
+		RefreshAccumulator(position, TEAM_WHITE, accumulator);
+		RefreshAccumulator(position, TEAM_BLACK, accumulator);
+		return EvaluateAccumulator(accumulator, team);
+	}
+
+	ValueType EvaluateNNUE(const Position& position, Team team, NNUEAccumulator* accumulators, int ply)
+	{
+		BOX_ASSERT(s_Network, "No network loaded");
+		for (Team perspective : { TEAM_WHITE, TEAM_BLACK })
+		{
+			// Every feature depends on the king square so the walk stops at a move of this perspective's king
+			int index = ply;
+			Team mover = OtherTeam(position.TeamToPlay);
+			while (!accumulators[index].Computed[perspective] && index > 0 && !(mover == perspective && accumulators[index].LastMove.GetMovingPiece() == PIECE_KING))
+			{
+				index--;
+				mover = OtherTeam(mover);
+			}
+			if (!accumulators[index].Computed[perspective])
+			{
+				RefreshAccumulator(position, perspective, accumulators[ply]);
+				continue;
+			}
+			const SquareIndex kingSquare = position.GetKingSquare(perspective);
+			for (; index < ply; index++)
+			{
+				mover = OtherTeam(mover);
+				UpdateAccumulator(accumulators[index], accumulators[index + 1], perspective, kingSquare, mover, accumulators[index + 1].LastMove);
+			}
+		}
+		return EvaluateAccumulator(accumulators[ply], team);
+	}
+
+}
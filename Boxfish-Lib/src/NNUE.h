@@ -0,0 +1,51 @@
+#pragma once
+#include "Position.h"
+#include "Move.h"
+#include <string>
+
+#ifdef SWIG
+#define BOX_API
+#endif
+
+namespace Boxfish
+{
+
+	// HalfKP network: each perspective has one input for every (own king square, non king piece, square) triple,
+	// transformed into NNUE_HALF_DIMENSIONS values that are updated incrementally as pieces move.
+	// The two halves (team to play first) are clipped to [0, 127] and fed into a single output neuron.
+	//
+	// Network file layout (little endian):
+	//   char     Magic[4] = "BXNN"
+	//   uint32_t Version = 1
+	//   uint32_t InputDimensions = NNUE_INPUT_DIMENSIONS
+	//   uint32_t HalfDimensions = NNUE_HALF_DIMENSIONS
+	//   int16_t  FeatureBiases[NNUE_HALF_DIMENSIONS]
+	//   int16_t  FeatureWeights[NNUE_INPUT_DIMENSIONS][NNUE_HALF_DIMENSIONS]
+	//   int16_t  OutputWeights[2 * NNUE_HALF_DIMENSIONS]
+	//   int32_t  OutputBias
+	constexpr int NNUE_PIECE_FEATURES = 2 * PIECE_KING;
+	constexpr int NNUE_INPUT_DIMENSIONS = SQUARE_MAX * NNUE_PIECE_FEATURES * SQUARE_MAX;
+	constexpr int NNUE_HALF_DIMENSIONS = 256;
+
+	// First layer of the NNUE for each perspective of one position in the search.
+	// LastMove is the move that reached the position, MOVE_NONE for a null move or the root
+	struct BOX_API NNUEAccumulator
+	{
+	public:
+		alignas(32) int16_t Values[TEAM_MAX][NNUE_HALF_DIMENSIONS];
+		bool Computed[TEAM_MAX] = { false, false };
+		Move LastMove = MOVE_NONE;
+	};
+
+	// Returns false and leaves the current network untouched if the file is missing or malformed
+	bool LoadNetwork(const std::string& filename);
+	bool IsNetworkLoaded();
+
+	// Computes the first layer from scratch
+	ValueType EvaluateNNUE(const Position& position, Team team);
+	// Used by Search instead of Evaluate() when BoxfishSettings::UseNNUE is set and a network has been loaded.
+	// accumulators[ply] belongs to position and accumulators[0] to the root, each perspective is updated from the closest
+	// computed ancestor using the moves in between and only recomputed when that perspective's king has moved
+	ValueType EvaluateNNUE(const Position& position, Team team, NNUEAccumulator* accumulators, int ply);
+
+}
@@ -0,0 +1,18 @@
+#include "PawnHashTable.h"
+#include <cstring>
+
+namespace Boxfish
+{
+
+	PawnHashTable::PawnHashTable()
+		: m_Entries(std::make_unique<PawnHashEntry[]>(ENTRY_COUNT))
+	{
+		Clear();
+	}
+
+	void PawnHashTable::Clear()
+	{
+		std::memset(m_Entries.get(), 0, ENTRY_COUNT * sizeof(PawnHashEntry));
+	}
+
+}
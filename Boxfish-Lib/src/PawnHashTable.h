@@ -0,0 +1,43 @@
+#pragma once
+#include "Position.h"
+#include <memory>
+
+#ifdef SWIG
+#define BOX_API
+#endif
+
+namespace Boxfish
+{
+
+	// Evaluation terms that only depend on the pawn structure
+	struct BOX_API PawnHashEntry
+	{
+	public:
+		uint64_t Key;
+		Score Pawns[TEAM_MAX];
+		BitBoard Attacks[TEAM_MAX];
+		BitBoard DoubleAttacks[TEAM_MAX];
+		int BlockedCount;
+	};
+
+	// Small per thread cache indexed by Position::PawnHash, entries are always replaced
+	class BOX_API PawnHashTable
+	{
+	public:
+		static constexpr size_t ENTRY_COUNT = 1 << 14;
+
+	private:
+		std::unique_ptr<PawnHashEntry[]> m_Entries;
+
+	public:
+		PawnHashTable();
+
+		inline PawnHashEntry* GetEntry(const ZobristHash& pawnHash) const
+		{
+			return &m_Entries[pawnHash.Hash & (ENTRY_COUNT - 1)];
+		}
+
+		void Clear();
+	};
+
+}
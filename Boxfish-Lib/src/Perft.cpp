@@ -0,0 +1,118 @@
+#include "Perft.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace Boxfish
+{
+
+	PerftHashTable::PerftHashTable(size_t sizeBytes)
+		: m_Entries(), m_EntryCount(0)
+	{
+		Resize(sizeBytes);
+	}
+
+	void PerftHashTable::Resize(size_t sizeBytes)
+	{
+		// Round down to a power of 2 so the index is a mask
+		size_t count = sizeBytes / sizeof(Entry);
+		m_EntryCount = 0;
+		if (count > 0)
+		{
+			m_EntryCount = 1;
+			while (m_EntryCount * 2 <= count)
+				m_EntryCount *= 2;
+		}
+		m_Entries = (m_EntryCount > 0) ? std::make_unique<Entry[]>(m_EntryCount) : nullptr;
+		Clear();
+	}
+
+	void PerftHashTable::Clear()
+	{
+		if (m_EntryCount > 0)
+			std::memset((void*)m_Entries.get(), 0, m_EntryCount * sizeof(Entry));
+	}
+
+	template<bool UseHash>
+	static size_t PerftPosition(Position& position, int depth, PerftHashTable* table)
+	{
+		size_t nodes = 0;
+		if (UseHash && depth > 1 && table->Probe(position.Hash, depth, nodes))
+			return nodes;
+
+		Move moves[MAX_MOVES];
+		MoveList list(moves);
+		MoveGenerator generator(position);
+		generator.GetLegalMoves(list);
+
+		// Bulk counting, the legal moves are the leaves
+		if (depth == 1)
+			return list.MoveCount;
+
+		UndoInfo undo;
+		for (int i = 0; i < list.MoveCount; i++)
+		{
+			ApplyMove(position, list.Moves[i], &undo);
+			nodes += PerftPosition<UseHash>(position, depth - 1, table);
+			UndoMove(position, list.Moves[i], undo);
+		}
+
+		if (UseHash)
+			table->Store(position.Hash, depth, nodes);
+		return nodes;
+	}
+
+	PerftResult RunPerft(const Position& position, int depth, int threads, PerftHashTable* table)
+	{
+		auto startTime = std::chrono::high_resolution_clock::now();
+		PerftResult result;
+
+		Move moves[MAX_MOVES];
+		MoveList list(moves);
+		MoveGenerator generator(position);
+		generator.GetLegalMoves(list);
+
+		if (depth <= 0)
+		{
+			result.Nodes = 1;
+			return result;
+		}
+
+		for (int i = 0; i < list.MoveCount; i++)
+			result.Divide.push_back({ list.Moves[i], 1 });
+
+		if (depth > 1)
+		{
+			const bool useHash = table != nullptr && table->IsEnabled();
+
+			// Threads take root moves in order until none are left
+			std::atomic<int> nextMove(0);
+			auto worker = [&]()
+			{
+				Position threadPosition = position;
+				UndoInfo undo;
+				int index;
+				while ((index = nextMove.fetch_add(1)) < (int)result.Divide.size())
+				{
+					PerftMove& move = result.Divide[index];
+					ApplyMove(threadPosition, move.RootMove, &undo);
+					move.Nodes = useHash ? PerftPosition<true>(threadPosition, depth - 1, table) : PerftPosition<false>(threadPosition, depth - 1, nullptr);
+					UndoMove(threadPosition, move.RootMove, undo);
+				}
+			};
+
+			std::vector<std::thread> helpers;
+			for (int i = 1; i < std::min(threads, (int)list.MoveCount); i++)
+				helpers.emplace_back(worker);
+			worker();
+			for (std::thread& helper : helpers)
+				helper.join();
+		}
+
+		for (const PerftMove& move : result.Divide)
+			result.Nodes += move.Nodes;
+		result.Elapsed = std::chrono::high_resolution_clock::now() - startTime;
+		return result;
+	}
+
+}
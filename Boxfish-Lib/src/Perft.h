@@ -0,0 +1,84 @@
+#pragma once
+#include "MoveGenerator.h"
+#include "PositionUtils.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#ifdef SWIG
+#define BOX_API
+#endif
+
+namespace Boxfish
+{
+
+	struct BOX_API PerftMove
+	{
+	public:
+		Move RootMove;
+		size_t Nodes;
+	};
+
+	struct BOX_API PerftResult
+	{
+	public:
+		size_t Nodes = 0;
+		// Leaf count below every legal root move in generation order
+		std::vector<PerftMove> Divide = {};
+		std::chrono::nanoseconds Elapsed = std::chrono::nanoseconds(0);
+	};
+
+	// Leaf counts keyed by Position::Hash and depth, shared between perft threads without locking.
+	// Like the transposition table the key is stored XORed with the data so torn entries read as a miss.
+	class BOX_API PerftHashTable
+	{
+	private:
+		struct Entry
+		{
+		public:
+			std::atomic<uint64_t> Key;
+			// Nodes (56 bits) | Depth (8 bits)
+			std::atomic<uint64_t> Data;
+		};
+
+	private:
+		std::unique_ptr<Entry[]> m_Entries;
+		size_t m_EntryCount;
+
+	public:
+		PerftHashTable(size_t sizeBytes = 0);
+
+		// Reallocates the table, 0 disables it. Must not be called during a perft
+		void Resize(size_t sizeBytes);
+		void Clear();
+
+		inline bool IsEnabled() const { return m_EntryCount > 0; }
+		inline size_t GetSizeBytes() const { return m_EntryCount * sizeof(Entry); }
+
+		inline bool Probe(const ZobristHash& hash, int depth, size_t& nodes) const
+		{
+			const Entry& entry = m_Entries[hash.Hash & (m_EntryCount - 1)];
+			uint64_t data = entry.Data.load(std::memory_order_relaxed);
+			uint64_t key = entry.Key.load(std::memory_order_relaxed);
+			if ((key ^ data) != hash.Hash || (int)(data & 0xFF) != depth)
+				return false;
+			nodes = (size_t)(data >> 8);
+			return true;
+		}
+
+		// Entries are always replaced
+		inline void Store(const ZobristHash& hash, int depth, size_t nodes)
+		{
+			Entry& entry = m_Entries[hash.Hash & (m_EntryCount - 1)];
+			uint64_t data = ((uint64_t)nodes << 8) | (uint64_t)depth;
+			entry.Data.store(data, std::memory_order_relaxed);
+			entry.Key.store(hash.Hash ^ data, std::memory_order_relaxed);
+		}
+	};
+
+	// Counts the leaves of the legal move tree to the given depth. Root moves are split between threads,
+	// the last ply is bulk counted from the legal move count and subtrees are cached in table if it is enabled.
+	PerftResult RunPerft(const Position& position, int depth, int threads = 1, PerftHashTable* table = nullptr);
+
+}
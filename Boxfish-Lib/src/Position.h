@@ -11,6 +11,42 @@ namespace Boxfish
 
 	using ValueType = int;
 
+	// Midgame and endgame values packed into one integer (endgame in the upper 16 bits)
+	// so that an evaluation term is accumulated with a single add
+	enum Score : int
+	{
+		SCORE_ZERO = 0
+	};
+
+	constexpr Score MakeScore(int mg, int eg)
+	{
+		return Score((int)((unsigned int)eg << 16) + mg);
+	}
+
+	constexpr ValueType MgValue(Score score)
+	{
+		return (int16_t)(uint16_t)(unsigned int)score;
+	}
+
+	constexpr ValueType EgValue(Score score)
+	{
+		// Rounds away the borrow from a negative midgame value
+		return (int16_t)(uint16_t)((unsigned int)(score + 0x8000) >> 16);
+	}
+
+	constexpr Score operator+(Score left, Score right) { return Score((int)left + (int)right); }
+	constexpr Score operator-(Score left, Score right) { return Score((int)left - (int)right); }
+	constexpr Score operator-(Score score) { return Score(-(int)score); }
+	constexpr Score operator*(Score score, int multiplier) { return Score((int)score * multiplier); }
+	inline Score& operator+=(Score& left, Score right) { return left = left + right; }
+	inline Score& operator-=(Score& left, Score right) { return left = left - right; }
+
+	// The material key holds a 4 bit count for every piece type of each team
+	constexpr uint64_t GetMaterialKeyIncrement(Team team, Piece piece)
+	{
+		return uint64_t(1) << (4 * (team * PIECE_MAX + piece));
+	}
+
 	struct BOX_API Position
 	{
 	public:
@@ -30,6 +66,11 @@ namespace Boxfish
 			Piece PieceOnSquare[SQUARE_MAX];
 
 			ValueType NonPawnMaterial[TEAM_MAX];
+			// Sum of GetPieceScore() over every piece of the team
+			Score PieceScore[TEAM_MAX];
+			// Sum of GetPhaseWeight() over every piece on the board
+			int Phase;
+			uint64_t MaterialKey;
 		};
 
 		struct BOX_API TeamPosition
@@ -47,6 +88,7 @@ namespace Boxfish
 		int TotalTurns = 0;
 		Square EnpassantSquare = INVALID_SQUARE;
 		ZobristHash Hash;
+		ZobristHash PawnHash;
 
 		PositionInfo InfoCache;
 
@@ -72,6 +114,9 @@ namespace Boxfish
 		inline BitBoard GetPieces(Piece piece, Piece piece2, Piece piece3) const { return GetPieces(piece, piece2) | GetPieces(piece3); }
 		inline ValueType GetNonPawnMaterial(Team team) const { return InfoCache.NonPawnMaterial[team]; }
 		inline ValueType GetNonPawnMaterial() const { return GetNonPawnMaterial(TEAM_WHITE) + GetNonPawnMaterial(TEAM_BLACK); }
+		inline Score GetPieceScore(Team team) const { return InfoCache.PieceScore[team]; }
+		inline int GetPhase() const { return InfoCache.Phase; }
+		inline uint64_t GetMaterialKey() const { return InfoCache.MaterialKey; }
 
 		inline int GetTotalHalfMoves() const { return 2 * TotalTurns + ((TeamToPlay == TEAM_BLACK) ? 1 : 0); }
 
@@ -13,6 +13,10 @@ namespace Boxfish
 
 		position.InfoCache.NonPawnMaterial[TEAM_WHITE] = 0;
 		position.InfoCache.NonPawnMaterial[TEAM_BLACK] = 0;
+		position.InfoCache.PieceScore[TEAM_WHITE] = SCORE_ZERO;
+		position.InfoCache.PieceScore[TEAM_BLACK] = SCORE_ZERO;
+		position.InfoCache.Phase = 0;
+		position.InfoCache.MaterialKey = 0;
 
 		for (SquareIndex square = a1; square < SQUARE_MAX; square++)
 		{
@@ -27,11 +31,17 @@ namespace Boxfish
 				position.InfoCache.NonPawnMaterial[TEAM_WHITE] += position.GetTeamPieces(TEAM_WHITE, piece).GetCount() * GetPieceValue(piece, MIDGAME);
 				position.InfoCache.NonPawnMaterial[TEAM_BLACK] += position.GetTeamPieces(TEAM_BLACK, piece).GetCount() * GetPieceValue(piece, MIDGAME);
 			}
-			BitBoard pieces = position.GetPieces(piece);
-			while (pieces)
+			position.InfoCache.Phase += position.GetPieces(piece).GetCount() * GetPhaseWeight(piece);
+			for (Team team : { TEAM_WHITE, TEAM_BLACK })
 			{
-				SquareIndex square = PopLeastSignificantBit(pieces);
-				position.InfoCache.PieceOnSquare[square] = piece;
+				BitBoard pieces = position.GetTeamPieces(team, piece);
+				while (pieces)
+				{
+					SquareIndex square = PopLeastSignificantBit(pieces);
+					position.InfoCache.PieceOnSquare[square] = piece;
+					position.InfoCache.PieceScore[team] += GetPieceScore(team, piece, square);
+					position.InfoCache.MaterialKey += GetMaterialKeyIncrement(team, piece);
+				}
 			}
 		}
 
@@ -42,6 +52,7 @@ namespace Boxfish
 		CalculateCheckers(position, TEAM_WHITE);
 		CalculateCheckers(position, TEAM_BLACK);
 		position.Hash.SetFromPosition(position);
+		position.PawnHash.SetPawnsFromPosition(position);
 	}
 
 	static char PieceToFEN(Piece piece, bool isWhite)
@@ -373,6 +384,23 @@ namespace Boxfish
 		position.InfoCache.InCheck[team] = (bool)position.InfoCache.CheckedBy[team];
 	}
 
+	BitBoard GetAttackedSquares(const Position& position, Team team, const BitBoard& blockers)
+	{
+		BitBoard pawns = position.GetTeamPieces(team, PIECE_PAWN);
+		BitBoard attacks = (team == TEAM_WHITE) ? GetPawnAttacks<TEAM_WHITE>(pawns) : GetPawnAttacks<TEAM_BLACK>(pawns);
+		attacks |= GetNonSlidingAttacks<PIECE_KING>(position.GetKingSquare(team));
+		BitBoard knights = position.GetTeamPieces(team, PIECE_KNIGHT);
+		while (knights)
+			attacks |= GetNonSlidingAttacks<PIECE_KNIGHT>(PopLeastSignificantBit(knights));
+		BitBoard diagonalSliders = position.GetTeamPieces(team, PIECE_BISHOP, PIECE_QUEEN);
+		while (diagonalSliders)
+			attacks |= GetSlidingAttacks<PIECE_BISHOP>(PopLeastSignificantBit(diagonalSliders), blockers);
+		BitBoard straightSliders = position.GetTeamPieces(team, PIECE_ROOK, PIECE_QUEEN);
+		while (straightSliders)
+			attacks |= GetSlidingAttacks<PIECE_ROOK>(PopLeastSignificantBit(straightSliders), blockers);
+		return attacks;
+	}
+
 	bool IsSquareUnderAttack(const Position& position, Team byTeam, const Square& square)
 	{
 		return IsSquareUnderAttack(position, byTeam, BitBoard::SquareToBitIndex(square));
@@ -466,6 +494,42 @@ namespace Boxfish
 		return threshold <= 0;
 	}
 
+	bool GivesCheck(const Position& position, const Move& move)
+	{
+		const Team team = position.TeamToPlay;
+		const Team otherTeam = OtherTeam(team);
+		const SquareIndex from = move.GetFromSquareIndex();
+		const SquareIndex to = move.GetToSquareIndex();
+		const SquareIndex kingSquare = position.GetKingSquare(otherTeam);
+		const MoveFlag flags = move.GetFlags();
+		const Piece piece = (flags & MOVE_PROMOTION) ? move.GetPromotionPiece() : move.GetMovingPiece();
+		BitBoard occupied = (position.GetAllPieces() ^ from) | to;
+
+		// Direct check
+		if (piece != PIECE_KING && (GetAttacksBy(piece, to, team, occupied) & kingSquare))
+			return true;
+
+		// Discovered check
+		if ((position.InfoCache.BlockersForKing[otherTeam] & from) && !IsAligned(from, to, kingSquare))
+			return true;
+
+		if (flags & MOVE_EN_PASSANT)
+		{
+			occupied ^= (SquareIndex)(to - GetForwardShift(team));
+			return (GetSlidingAttacks<PIECE_ROOK>(kingSquare, occupied) & position.GetTeamPieces(team, PIECE_ROOK, PIECE_QUEEN))
+				|| (GetSlidingAttacks<PIECE_BISHOP>(kingSquare, occupied) & position.GetTeamPieces(team, PIECE_BISHOP, PIECE_QUEEN));
+		}
+		if (flags & (MOVE_KINGSIDE_CASTLE | MOVE_QUEENSIDE_CASTLE))
+		{
+			const bool kingside = flags & MOVE_KINGSIDE_CASTLE;
+			const SquareIndex rookFrom = team == TEAM_WHITE ? (kingside ? h1 : a1) : (kingside ? h8 : a8);
+			const SquareIndex rookTo = team == TEAM_WHITE ? (kingside ? f1 : d1) : (kingside ? f8 : d8);
+			occupied = (position.GetAllPieces() ^ from ^ rookFrom) | to | rookTo;
+			return GetSlidingAttacks<PIECE_ROOK>(rookTo, occupied) & kingSquare;
+		}
+		return false;
+	}
+
 	void MovePiece(Position& position, Team team, Piece piece, SquareIndex from, SquareIndex to)
 	{
 		BitBoard mask = from | to;
@@ -475,9 +539,15 @@ namespace Boxfish
 		position.InfoCache.PiecesByType[piece] ^= mask;
 		position.InfoCache.PieceOnSquare[from] = PIECE_INVALID;
 		position.InfoCache.PieceOnSquare[to] = piece;
+		position.InfoCache.PieceScore[team] += GetPieceScore(team, piece, to) - GetPieceScore(team, piece, from);
 
 		position.Hash.RemovePieceAt(team, piece, from);
 		position.Hash.AddPieceAt(team, piece, to);
+		if (piece == PIECE_PAWN)
+		{
+			position.PawnHash.RemovePieceAt(team, piece, from);
+			position.PawnHash.AddPieceAt(team, piece, to);
+		}
 	}
 
 	void RemovePiece(Position& position, Team team, Piece piece, SquareIndex square)
@@ -491,7 +561,12 @@ namespace Boxfish
 		{
 			position.InfoCache.NonPawnMaterial[team] -= GetPieceValue(piece, MIDGAME);
 		}
+		position.InfoCache.PieceScore[team] -= GetPieceScore(team, piece, square);
+		position.InfoCache.Phase -= GetPhaseWeight(piece);
+		position.InfoCache.MaterialKey -= GetMaterialKeyIncrement(team, piece);
 		position.Hash.RemovePieceAt(team, piece, square);
+		if (piece == PIECE_PAWN)
+			position.PawnHash.RemovePieceAt(team, piece, square);
 	}
 
 	void AddPiece(Position& position, Team team, Piece piece, SquareIndex square)
@@ -505,7 +580,12 @@ namespace Boxfish
 		{
 			position.InfoCache.NonPawnMaterial[team] += GetPieceValue(piece, MIDGAME);
 		}
+		position.InfoCache.PieceScore[team] += GetPieceScore(team, piece, square);
+		position.InfoCache.Phase += GetPhaseWeight(piece);
+		position.InfoCache.MaterialKey += GetMaterialKeyIncrement(team, piece);
 		position.Hash.AddPieceAt(team, piece, square);
+		if (piece == PIECE_PAWN)
+			position.PawnHash.AddPieceAt(team, piece, square);
 	}
 
 	void UpdateCastleInfoFromMove(Position& position, Team team, const Move& move)
@@ -641,6 +721,7 @@ namespace Boxfish
 			if (move.GetMovingPiece() == PIECE_KING)
 				position.InfoCache.KingSquare[currentTeam] = move.GetToSquareIndex();
 
+			CalculateKingBlockers(position, currentTeam);
 			CalculateKingBlockers(position, otherTeam);
 			CalculateCheckers(position, otherTeam);
 		}
@@ -664,6 +745,10 @@ namespace Boxfish
 			outUndoInfo->CheckedBy[TEAM_BLACK] = position.InfoCache.CheckedBy[TEAM_BLACK];
 			outUndoInfo->InCheck[TEAM_WHITE] = position.InfoCache.InCheck[TEAM_WHITE];
 			outUndoInfo->InCheck[TEAM_BLACK] = position.InfoCache.InCheck[TEAM_BLACK];
+			outUndoInfo->BlockersForKing[TEAM_WHITE] = position.InfoCache.BlockersForKing[TEAM_WHITE];
+			outUndoInfo->BlockersForKing[TEAM_BLACK] = position.InfoCache.BlockersForKing[TEAM_BLACK];
+			outUndoInfo->Pinners[TEAM_WHITE] = position.InfoCache.Pinners[TEAM_WHITE];
+			outUndoInfo->Pinners[TEAM_BLACK] = position.InfoCache.Pinners[TEAM_BLACK];
 			outUndoInfo->EnpassantSquare = position.EnpassantSquare;
 			outUndoInfo->HalfTurnsSinceCaptureOrPush = position.HalfTurnsSinceCaptureOrPush;
 			outUndoInfo->CastleKingSide[TEAM_WHITE] = position.Teams[TEAM_WHITE].CastleKingSide;
@@ -771,9 +856,10 @@ namespace Boxfish
 		position.InfoCache.CheckedBy[TEAM_BLACK] = undo.CheckedBy[TEAM_BLACK];
 		position.InfoCache.InCheck[TEAM_WHITE] = undo.InCheck[TEAM_WHITE];
 		position.InfoCache.InCheck[TEAM_BLACK] = undo.InCheck[TEAM_BLACK];
-
-		CalculateKingBlockers(position, TEAM_WHITE);
-		CalculateKingBlockers(position, TEAM_BLACK);
+		position.InfoCache.BlockersForKing[TEAM_WHITE] = undo.BlockersForKing[TEAM_WHITE];
+		position.InfoCache.BlockersForKing[TEAM_BLACK] = undo.BlockersForKing[TEAM_BLACK];
+		position.InfoCache.Pinners[TEAM_WHITE] = undo.Pinners[TEAM_WHITE];
+		position.InfoCache.Pinners[TEAM_BLACK] = undo.Pinners[TEAM_BLACK];
 	}
 
 	void ApplyNullMove(Position& position, UndoInfo* outUndoInfo)
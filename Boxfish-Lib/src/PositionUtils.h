@@ -22,6 +22,8 @@ namespace Boxfish
 		
 		BitBoard CheckedBy[TEAM_MAX];
 		bool InCheck[TEAM_MAX];
+		BitBoard BlockersForKing[TEAM_MAX];
+		BitBoard Pinners[TEAM_MAX];
 	};
 
 	Position CreateStartingPosition();
@@ -38,10 +40,15 @@ namespace Boxfish
 	void CalculateKingBlockers(Position& position, Team team);
 	void CalculateCheckers(Position& position, Team team);
 
+	// Every square attacked by team, sliders see through pieces missing from blockers
+	BitBoard GetAttackedSquares(const Position& position, Team team, const BitBoard& blockers);
+
 	bool IsSquareUnderAttack(const Position& position, Team byTeam, const Square& square);
 	bool IsSquareUnderAttack(const Position& position, Team byTeam, SquareIndex square);
 
 	bool SeeGE(const Position& position, const Move& move, ValueType threshold = 0);
+	// Returns true if the pseudo legal move will put the opponent in check, without applying it
+	bool GivesCheck(const Position& position, const Move& move);
 
 	void ApplyMove(Position& position, Move move);
 	void ApplyMove(Position& position, Move move, UndoInfo* outUndoInfo);
@@ -10,6 +10,13 @@ namespace Boxfish
 	static int DepthReductions[2][2][32][64];
 	static int FutilityMoveCounts[2][16];
 
+	// Below mate scores so tablebase wins are never reported as mates
+	static constexpr ValueType SCORE_TABLEBASE_WIN = SCORE_MATE - 2 * MAX_PLY;
+
+	// Helper threads skip iterations in these patterns so that they do not all search the same depth
+	static constexpr int HelperSkipSize[20] = { 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4 };
+	static constexpr int HelperSkipPhase[20] = { 0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7 };
+
 	void InitSearch()
 	{
 		for (int improving = 0; improving <= 1; improving++)
@@ -55,8 +62,7 @@ namespace Boxfish
 		Move moves[MAX_MOVES];
 		MoveList list(nullptr, moves);
 		MoveGenerator generator(position);
-		generator.GetPseudoLegalMoves(list);
-		generator.FilterLegalMoves(list);
+		generator.GetLegalMoves(list);
 
 		for (int i = 0; i < list.MoveCount; i++)
 		{
@@ -70,11 +76,18 @@ namespace Boxfish
 		return false;
 	}
 
+	Search::ThreadData::ThreadData(int index)
+		: Index(index), Pool(MOVE_POOL_SIZE), Tables(), PawnTable(), EvalTable(), Nodes(0), TablebaseHits(0), Stats(), CompletedDepth(0), WasStopped(false), RootMoves(), Accumulators()
+	{
+		Tables.Clear();
+	}
+
 	Search::Search(size_t transpositionTableSize, bool log)
-		: m_TranspositionTable(transpositionTableSize), m_Settings(), m_Limits(), m_PositionHistory(), m_OpeningBook(nullptr), m_MovePool(MOVE_POOL_SIZE), m_Nodes(0), m_SearchRootStartTime(), m_StartTime(),
-		m_WasStopped(false), m_ShouldStop(false), m_Log(log), m_OrderingTables()
+		: m_TranspositionTable(transpositionTableSize), m_PerftTable(), m_Settings(), m_Limits(), m_TimeManager(), m_PositionHistory(), m_OpeningBook(nullptr), m_Threads(), m_TablebaseLimit(0), m_StartTime(),
+		m_ShouldStop(false), m_StopThreads(false), m_Log(log)
 	{
-		m_OrderingTables.Clear();
+		m_Settings.HashTableBytes = transpositionTableSize;
+		SetThreadCount(m_Settings.Threads);
 	}
 
 	const BoxfishSettings& Search::GetSettings() const
@@ -84,7 +97,23 @@ namespace Boxfish
 
 	void Search::SetSettings(const BoxfishSettings& settings)
 	{
+		bool resizeTable = settings.HashTableBytes != m_Settings.HashTableBytes;
+		bool evaluatorChanged = settings.UseNNUE != m_Settings.UseNNUE;
+		bool tablebasesChanged = settings.SyzygyPath != m_Settings.SyzygyPath;
+		bool resizePerftTable = settings.PerftHashBytes != m_Settings.PerftHashBytes;
 		m_Settings = settings;
+		SetThreadCount(settings.Threads);
+		// Keep reporting the previous size if the new table can't be allocated
+		if (resizeTable && !m_TranspositionTable.Resize(settings.HashTableBytes, settings.Threads))
+			m_Settings.HashTableBytes = m_TranspositionTable.GetSizeBytes();
+		if (evaluatorChanged)
+		{
+			ClearEvaluationCache();
+		}
+		if (tablebasesChanged)
+			InitTablebases(settings.SyzygyPath);
+		if (resizePerftTable)
+			m_PerftTable.Resize(settings.PerftHashBytes);
 	}
 
 	void Search::SetLimits(const SearchLimits& limits)
@@ -102,60 +131,55 @@ namespace Boxfish
 		m_PositionHistory.clear();
 	}
 
+	void Search::ClearTranspositionTable()
+	{
+		m_TranspositionTable.Clear(m_Settings.Threads);
+	}
+
+	void Search::ClearEvaluationCache()
+	{
+		for (std::unique_ptr<ThreadData>& thread : m_Threads)
+			thread->EvalTable.Clear();
+	}
+
+	bool Search::SaveTranspositionTable(const std::string& filename) const
+	{
+		return m_TranspositionTable.SaveToFile(filename);
+	}
+
+	bool Search::LoadTranspositionTable(const std::string& filename)
+	{
+		bool loaded = m_TranspositionTable.LoadFromFile(filename, m_Settings.Threads);
+		m_Settings.HashTableBytes = m_TranspositionTable.GetSizeBytes();
+		return loaded;
+	}
+
 	void Search::SetOpeningBook(const OpeningBook* book)
 	{
 		m_OpeningBook = book;
 	}
 
-	const TranspositionTableEntry* Search::ProbeTranspostionTable(const Position& position) const
+	bool Search::ProbeTranspostionTable(const Position& position, TranspositionTableData& data) const
 	{
 		bool found;
-		const TranspositionTableEntry* entry = m_TranspositionTable.GetEntry(position.Hash, found);
-		if (found)
-			return entry;
-		return nullptr;
+		m_TranspositionTable.GetEntry(position.Hash, found, data);
+		return found;
 	}
 
-#define BOX_UNDO_MOVES 0
+	size_t Search::Perft(const Position& position, int depth)
+	{
+		PerftResult result = RunPerft(position, depth, m_Settings.Threads, &m_PerftTable);
+		if (m_Log)
+			LogPerft(result, false);
+		return result.Nodes;
+	}
 
-	size_t Search::Perft(const Position& pos, int depth)
+	PerftResult Search::Divide(const Position& position, int depth)
 	{
-		Position position = pos;
-		size_t total = 0;
-		MoveGenerator movegen(position);
-		MoveList moves = m_MovePool.GetList();
-		movegen.GetPseudoLegalMoves(moves);
-		movegen.FilterLegalMoves(moves);
-
-		auto startTime = std::chrono::high_resolution_clock::now();
-#if BOX_UNDO_MOVES
-		UndoInfo undo;
-#endif
-		for (int i = 0; i < moves.MoveCount; i++)
-		{
-#if BOX_UNDO_MOVES
-			ApplyMove(position, moves.Moves[i], &undo);
-			size_t perft = PerftPosition(position, depth - 1);
-			UndoMove(position, moves.Moves[i], undo);
-#else
-			Position movedPosition = position;
-			ApplyMove(movedPosition, moves.Moves[i]);
-			size_t perft = PerftPosition(movedPosition, depth - 1);
-#endif
-			total += perft;
-			if (m_Log)
-				std::cout << UCI::FormatMove(moves.Moves[i]) << ": " << perft << std::endl;
-		}
-		auto endTime = std::chrono::high_resolution_clock::now();
-		auto elapsed = endTime - startTime;
+		PerftResult result = RunPerft(position, depth, m_Settings.Threads, &m_PerftTable);
 		if (m_Log)
-		{
-			std::cout << "====================================" << std::endl;
-			std::cout << "Total Time: " << std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() << "ms" << std::endl;
-			std::cout << "Total Nodes: " << total << std::endl;
-			std::cout << "Nodes per Second: " << (size_t)(total / (double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() * 1e9) << std::endl;
-		}
-		return total;
+			LogPerft(result, true);
+		return result;
 	}
 
 	Move Search::SearchBestMove(const Position& position, SearchLimits limits)
@@ -178,14 +202,70 @@ namespace Boxfish
 		}
 
 		SetLimits(limits);
-		m_OrderingTables.Clear();
-		m_WasStopped = false;
+		// The tablebases are shared by every search, only probe them if this search has a SyzygyPath set
+		m_TablebaseLimit = m_Settings.SyzygyPath.empty() ? 0 : GetTablebaseCardinality();
+		const Team team = position.TeamToPlay;
+		m_TimeManager.Init(limits.Time[team], limits.Increment[team], limits.MovesToGo, position.GetTotalHalfMoves(), m_Settings.MoveOverhead);
+		for (std::unique_ptr<ThreadData>& thread : m_Threads)
+		{
+			thread->Tables.Clear();
+			thread->Nodes = 0;
+			thread->TablebaseHits = 0;
+			thread->Stats.Clear();
+			thread->CompletedDepth = 0;
+			thread->WasStopped = false;
+			thread->RootMoves.clear();
+			thread->Accumulators.resize((m_Settings.UseNNUE && IsNetworkLoaded()) ? MAX_PLY + 1 : 0);
+		}
+		m_TranspositionTable.NewSearch();
 		m_ShouldStop = false;
+		m_StopThreads = false;
 		m_StartTime = std::chrono::high_resolution_clock::now();
 
+		const int maxDepth = (limits.Depth <= 0) ? MAX_PLY : limits.Depth;
+
+		// Lazy SMP: helpers search the same root sharing only the transposition table
+		std::vector<std::thread> helpers;
+		for (size_t i = 1; i < m_Threads.size(); i++)
+		{
+			helpers.emplace_back([this, &position, maxDepth, i]()
+			{
+				Position helperPosition = position;
+				SearchRoot(*m_Threads[i], helperPosition, maxDepth, {});
+			});
+		}
+
 		Position searchPosition = position;
+		RootMove rootMove = SearchRoot(*m_Threads[0], searchPosition, maxDepth, callback);
+
+		m_StopThreads = true;
+		for (std::thread& helper : helpers)
+			helper.join();
+
+		// MultiPV and skill level rely on the main thread's ordering of its root moves
+		if (m_Threads.size() > 1 && m_Settings.MultiPV == 1 && m_Settings.SkillLevel >= 20)
+		{
+			const ThreadData& bestThread = SelectBestThread();
+			if (bestThread.Index != 0)
+			{
+				rootMove = bestThread.RootMoves[0];
+				// Only the main thread reports its iterations, so make sure the last PV matches the move played
+				if (m_Log)
+					LogSearchInfo(rootMove, bestThread.CompletedDepth, 0);
+				if (callback)
+				{
+					SearchResult result;
+					result.BestMove = rootMove.PV[0];
+					result.PV = rootMove.PV;
+					result.Score = rootMove.Score;
+					result.PVIndex = 0;
+					result.Depth = bestThread.CompletedDepth;
+					result.SelDepth = rootMove.SelDepth;
+					callback(result);
+				}
+			}
+		}
 
-		RootMove rootMove = SearchRoot(searchPosition, (limits.Depth <= 0) ? MAX_PLY : limits.Depth, callback);
 		if (rootMove.PV.empty())
 			return MOVE_NONE;
 		return rootMove.PV[0];
@@ -207,49 +287,61 @@ namespace Boxfish
 		m_ShouldStop = true;
 	}
 
-	size_t Search::PerftPosition(Position& position, int depth)
+	void Search::LogSearchInfo(const RootMove& rootMove, int depth, int pvIndex) const
 	{
-		if (depth <= 0)
-			return 1;
-		if (depth == 1)
+		auto elapsed = std::chrono::high_resolution_clock::now() - m_StartTime;
+		size_t nodes = GetTotalNodes();
+		int hashFull = m_TranspositionTable.GetFullProportion();
+
+		std::cout << "info depth " << depth << " seldepth " << rootMove.SelDepth << " score ";
+		if (!IsMateScore(rootMove.Score))
+		{
+			std::cout << "cp " << rootMove.Score;
+		}
+		else
+		{
+			if (rootMove.Score > 0)
+				std::cout << "mate " << (GetPliesFromMateScore(rootMove.Score) / 2 + 1);
+			else
+				std::cout << "mate " << -(GetPliesFromMateScore(rootMove.Score) / 2 - 1);
+		}
+		std::cout << " nodes " << nodes;
+		std::cout << " nps " << (size_t)(nodes / (elapsed.count() / 1e9f));
+		std::cout << " time " << (size_t)(elapsed.count() / 1e6f);
+		std::cout << " tbhits " << GetTotalTablebaseHits();
+		std::cout << " multipv " << (pvIndex + 1);
+		if (hashFull >= 500)
+			std::cout << " hashfull " << hashFull;
+		if (m_Limits.Only.size() == 1)
+			std::cout << " bookmove";
+		std::cout << " pv";
+		for (const Move& move : rootMove.PV)
 		{
-			MoveGenerator movegen(position);
-			MoveList moves = m_MovePool.GetList();
-			movegen.GetPseudoLegalMoves(moves);
-			movegen.FilterLegalMoves(moves);
-			return moves.MoveCount;
+			std::cout << " " << UCI::FormatMove(move);
 		}
+		std::cout << std::endl;
+	}
 
-#if BOX_UNDO_MOVES
-		UndoInfo undo;
-#endif
-		MoveGenerator movegen(position);
-		size_t nodes = 0;
-		MoveList legalMoves = m_MovePool.GetList();
-		movegen.GetPseudoLegalMoves(legalMoves);
-		movegen.FilterLegalMoves(legalMoves);
-		for (int i = 0; i < legalMoves.MoveCount; i++)
+	void Search::LogPerft(const PerftResult& result, bool divide) const
+	{
+		if (divide)
 		{
-#if BOX_UNDO_MOVES
-			ApplyMove(position, legalMoves.Moves[i], &undo);
-			nodes += PerftPosition(position, depth - 1);
-			UndoMove(position, legalMoves.Moves[i], undo);
-#else
-			Position movedPosition = position;
-			ApplyMove(movedPosition, legalMoves.Moves[i]);
-			nodes += PerftPosition(movedPosition, depth - 1);
-#endif
+			for (const PerftMove& move : result.Divide)
+				std::cout << UCI::FormatMove(move.RootMove) << ": " << move.Nodes << std::endl;
 		}
-		return nodes;
+		const auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(result.Elapsed).count();
+		std::cout << "====================================" << std::endl;
+		std::cout << "Total Time: " << milliseconds << "ms" << std::endl;
+		std::cout << "Total Nodes: " << result.Nodes << std::endl;
+		std::cout << "Nodes per Second: " << (size_t)(result.Nodes / std::max(result.Elapsed.count() / 1e9, 1e-9)) << std::endl;
 	}
 
-	Search::RootMove Search::SearchRoot(Position& position, int depth, const std::function<void(SearchResult)>& callback)
+	Search::RootMove Search::SearchRoot(ThreadData& thread, Position& position, int depth, const std::function<void(SearchResult)>& callback)
 	{
 		SearchStack stack[MAX_PLY + 5];
 		Move pv[MAX_PLY + 1];
 		// 50 move rule => 100 plies + MAX_PLY potential search
 		std::unique_ptr<ZobristHash[]> positionHistory = std::make_unique<ZobristHash[]>(m_PositionHistory.size() + MAX_PLY + 1);
-		m_Nodes = 0;
 		ValueType alpha = -SCORE_MATE;
 		ValueType beta = SCORE_MATE;
 		ValueType delta = -SCORE_MATE;
@@ -304,7 +396,7 @@ namespace Boxfish
 		stackPtr->TTHit = false;
 		stackPtr->KillerMoves[1] = stackPtr->KillerMoves[0] = MOVE_NONE;
 
-		std::vector<RootMove> rootMoveCache = GenerateRootMoves(position, stackPtr);
+		std::vector<RootMove> rootMoveCache = GenerateRootMoves(thread, position, stackPtr);
 		std::vector<RootMove> result;
 
 		int rootDepth = 0;
@@ -316,10 +408,19 @@ namespace Boxfish
 
 		std::vector<RootMove> rootMoves = rootMoveCache;
 
+		Move previousBestMove = MOVE_NONE;
+		ValueType previousScore = SCORE_NONE;
+
 		while ((++rootDepth) < MAX_PLY)
 		{
-			m_Nodes = 0;
-			m_SearchRootStartTime = std::chrono::high_resolution_clock::now();
+			if (thread.Index > 0)
+			{
+				int skipIndex = (thread.Index - 1) % 20;
+				if (((rootDepth + HelperSkipPhase[skipIndex]) / HelperSkipSize[skipIndex]) % 2)
+					continue;
+			}
+
+			const auto iterationStartTime = std::chrono::high_resolution_clock::now();
 
 			RootMove selectedMove;
 
@@ -339,7 +440,7 @@ namespace Boxfish
 				while (true)
 				{
 					int adjustedDepth = std::max(1, rootDepth - betaCutoffs);
-					ValueType newBestScore = SearchPosition<PV>(position, stackPtr, adjustedDepth, alpha, beta, selDepth, false, RootInfo{ rootMoves, pvIndex, (int)rootMoves.size() });
+					ValueType newBestScore = SearchPosition<PV>(thread, position, stackPtr, adjustedDepth, alpha, beta, selDepth, false, RootInfo{ rootMoves, pvIndex, (int)rootMoves.size() });
 
 					std::stable_sort(rootMoves.begin() + pvIndex, rootMoves.end());
 
@@ -359,17 +460,17 @@ namespace Boxfish
 					{
 						break;
 					}
-					if (CheckLimits())
+					if (CheckLimits(thread))
 					{
-						m_WasStopped = true;
+						thread.WasStopped = true;
 						break;
 					}
 					delta += delta / 4 + 5;
 				}
 
-				if (CheckLimits())
+				if (CheckLimits(thread))
 				{
-					m_WasStopped = true;
+					thread.WasStopped = true;
 					break;
 				}
 
@@ -377,38 +478,8 @@ namespace Boxfish
 				std::vector<Move>& rootPV = rootMove.PV;
 
 				// MultiPV may be set by skill level -> don't log other PVs in that case
-				if (m_Log && pvIndex < m_Settings.MultiPV)
-				{
-					auto elapsed = std::chrono::high_resolution_clock::now() - m_SearchRootStartTime;
-					int hashFull = m_TranspositionTable.GetFullProportion();
-
-					std::cout << "info depth " << rootDepth << " seldepth " << rootMove.SelDepth << " score ";
-					if (!IsMateScore(rootMove.Score))
-					{
-						std::cout << "cp " << rootMove.Score;
-					}
-					else
-					{
-						if (rootMove.Score > 0)
-							std::cout << "mate " << (GetPliesFromMateScore(rootMove.Score) / 2 + 1);
-						else
-							std::cout << "mate " << -(GetPliesFromMateScore(rootMove.Score) / 2 - 1);
-					}
-					std::cout << " nodes " << m_Nodes;
-					std::cout << " nps " << (size_t)(m_Nodes / (elapsed.count() / 1e9f));
-					std::cout << " time " << (size_t)(elapsed.count() / 1e6f);
-					std::cout << " multipv " << (pvIndex + 1);
-					if (hashFull >= 500)
-						std::cout << " hashfull " << hashFull;
-					if (m_Limits.Only.size() == 1)
-						std::cout << " bookmove";
-					std::cout << " pv";
-					for (const Move& move : rootPV)
-					{
-						std::cout << " " << UCI::FormatMove(move);
-					}
-					std::cout << std::endl;
-				}
+				if (m_Log && thread.Index == 0 && pvIndex < m_Settings.MultiPV)
+					LogSearchInfo(rootMove, rootDepth, pvIndex);
 
 				if (callback)
 				{
@@ -423,9 +494,9 @@ namespace Boxfish
 				}
 			}
 
-			if (CheckLimits())
+			if (CheckLimits(thread))
 			{
-				m_WasStopped = true;
+				thread.WasStopped = true;
 				if (result.empty())
 				{
 					RootMove mv;
@@ -444,10 +515,27 @@ namespace Boxfish
 				mv.PV = { MOVE_NONE };
 				result.push_back(mv);
 			}
+			thread.CompletedDepth = rootDepth;
+			thread.RootMoves = result;
 
 			RootMove& rootMove = result[0];
 			std::vector<Move>& rootPV = rootMove.PV;
 
+			// Only the main thread manages time, helpers are stopped when it returns
+			if (thread.Index == 0 && m_TimeManager.IsEnabled() && !m_Limits.Infinite)
+			{
+				auto now = std::chrono::high_resolution_clock::now();
+				int elapsed = (int)std::chrono::duration_cast<std::chrono::milliseconds>(now - m_StartTime).count();
+				int iterationTime = (int)std::chrono::duration_cast<std::chrono::milliseconds>(now - iterationStartTime).count();
+				bool bestMoveChanged = previousBestMove != MOVE_NONE && rootPV[0] != previousBestMove;
+				ValueType scoreDrop = (previousScore == SCORE_NONE) ? 0 : previousScore - rootMove.Score;
+				previousBestMove = rootPV[0];
+				previousScore = rootMove.Score;
+
+				if (m_TimeManager.ShouldStop(elapsed, iterationTime, bestMoveChanged, scoreDrop) || result.size() == 1)
+					break;
+			}
+
 			if (IsMateScore(rootMove.Score) && !m_Limits.Infinite)
 				break;
 
@@ -456,11 +544,14 @@ namespace Boxfish
 		}
 
 		// Don't return if pondering (exceeded max ply)
-		while (m_Limits.Infinite && !m_ShouldStop)
+		while (thread.Index == 0 && m_Limits.Infinite && !m_ShouldStop)
 			std::this_thread::yield();
 
 		if (result.size() > 0)
 		{
+			// Skill level picks use the global random engine and only the main thread's move is played
+			if (thread.Index != 0)
+				return result[0];
 			int chosenIndex = ChooseBestMove(result, m_Settings.SkillLevel, 4);
 			return result[chosenIndex];
 		}
@@ -472,7 +563,7 @@ namespace Boxfish
 	}
 
 	template<Search::NodeType NT>
-	ValueType Search::SearchPosition(Position& position, SearchStack* stack, int depth, ValueType alpha, ValueType beta, int& selDepth, bool cutNode, const Search::RootInfo& rootInfo)
+	ValueType Search::SearchPosition(ThreadData& thread, Position& position, SearchStack* stack, int depth, ValueType alpha, ValueType beta, int& selDepth, bool cutNode, const Search::RootInfo& rootInfo)
 	{
 		BOX_ASSERT(alpha < beta && beta >= -SCORE_MATE && beta <= SCORE_MATE && alpha >= -SCORE_MATE && alpha <= SCORE_MATE, "Invalid bounds");
 		constexpr int FirstMoveIndex = 1;
@@ -484,9 +575,12 @@ namespace Boxfish
 		BOX_ASSERT(!(IsPvNode && cutNode), "Invalid");
 		BOX_ASSERT(IsPvNode || (alpha == beta - 1), "Invalid alpha/beta");
 
-		MoveList pvMoveList = m_MovePool.GetList();
+		MoveList pvMoveList = thread.Pool.GetList();
 		Move* pv = pvMoveList.Moves;
 
+		if (!thread.Accumulators.empty())
+			ResetAccumulator(thread, stack);
+
 		stack->MoveCount = 0;
 		stack->StaticEvaluation = SCORE_NONE;
 		(stack + 1)->TTIsPv = false;
@@ -502,8 +596,9 @@ namespace Boxfish
 			return EvaluateDraw(position, stack->Contempt);
 
 		if (depth <= 0)
-			return QuiescenceSearch<NT>(position, stack, 0, alpha, beta);
+			return QuiescenceSearch<NT>(thread, position, stack, 0, alpha, beta);
 
+		BOX_STAT(thread, STAT_MAIN_NODES);
 		stack->PositionHistory[0] = position.Hash;
 
 		// Check for draw
@@ -529,32 +624,69 @@ namespace Boxfish
 		ZobristHash ttHash = position.Hash;
 		if (stack->ExcludedMove != MOVE_NONE)
 			ttHash ^= stack->ExcludedMove.GetKey();
-		TranspositionTableEntry* ttEntry = m_TranspositionTable.GetEntry(ttHash, stack->TTHit);
+		TranspositionTableData ttData;
+		TranspositionTableEntry* ttEntry = m_TranspositionTable.GetEntry(ttHash, stack->TTHit, ttData);
 
 		if (stack->ExcludedMove == MOVE_NONE)
-			stack->TTIsPv = IsPvNode || (stack->TTHit && ttEntry->IsPv());
+			stack->TTIsPv = IsPvNode || (stack->TTHit && ttData.IsPv());
 		bool formerPv = stack->TTIsPv && !IsPvNode;
 
-		stack->TTHit = stack->TTHit && SanityCheckMove(position, ttEntry->GetMove());
+		stack->TTHit = stack->TTHit && SanityCheckMove(position, ttData.GetMove());
+		BOX_STAT(thread, STAT_TT_PROBES);
+		if (stack->TTHit)
+			BOX_STAT(thread, STAT_TT_HITS);
 
 		Move ttMove =
 			IsRoot ? rootInfo.Moves[rootInfo.PVIndex].PV[0] :
-			stack->TTHit ? ttEntry->GetMove() : MOVE_NONE;
+			stack->TTHit ? ttData.GetMove() : MOVE_NONE;
 		ValueType ttValue =
-			stack->TTHit ? GetValueFromTT(ttEntry->GetScore(), stack->Ply) : SCORE_NONE;
+			stack->TTHit ? GetValueFromTT(ttData.GetScore(), stack->Ply) : SCORE_NONE;
 
-		if (!IsPvNode && stack->TTHit && ttEntry->GetDepth() >= depth && (ttValue >= beta ? (ttEntry->GetFlag() & LOWER_BOUND) : (ttEntry->GetFlag() & UPPER_BOUND)))
+		if (!IsPvNode && stack->TTHit && ttData.GetDepth() >= depth && (ttValue >= beta ? (ttData.GetFlag() & LOWER_BOUND) : (ttData.GetFlag() & UPPER_BOUND)))
 		{
 			if (ttMove != MOVE_NONE)
 			{
 				if (ttValue >= beta && !ttMove.IsCaptureOrPromotion())
-					UpdateQuietStats(position, stack, depth, ttMove);
+					UpdateQuietStats(thread, position, stack, depth, ttMove);
 				else if (!ttMove.IsCaptureOrPromotion())
-					m_OrderingTables.History[position.TeamToPlay][ttMove.GetFromSquareIndex()][ttMove.GetToSquareIndex()] += depth * depth;
+					thread.Tables.History[position.TeamToPlay][ttMove.GetFromSquareIndex()][ttMove.GetToSquareIndex()] += depth * depth;
 			}
+			BOX_STAT(thread, STAT_TT_CUTOFFS);
 			return ttValue;
 		}
 
+		// Tablebase probe, tables only cover positions right after a zeroing move without castling rights
+		const int tablebaseCardinality = m_TablebaseLimit;
+		if (!IsRoot && stack->ExcludedMove == MOVE_NONE && tablebaseCardinality > 0 && position.HalfTurnsSinceCaptureOrPush == 0 && !HasCastlingRights(position))
+		{
+			const int pieceCount = position.GetAllPieces().GetCount();
+			if (pieceCount < tablebaseCardinality || (pieceCount == tablebaseCardinality && depth >= m_Settings.SyzygyProbeDepth))
+			{
+				ProbeState state;
+				const WDLScore wdl = ProbeWDL(position, &state);
+				if (state != PROBE_FAIL)
+				{
+					thread.TablebaseHits.fetch_add(1, std::memory_order_relaxed);
+
+					// Cursed wins and blessed losses are scored close to a draw
+					ValueType value =
+						wdl < WDL_BLESSED_LOSS ? -SCORE_TABLEBASE_WIN + stack->Ply :
+						wdl > WDL_CURSED_WIN ? SCORE_TABLEBASE_WIN - stack->Ply :
+						SCORE_DRAW + 2 * wdl;
+					EntryFlag flag =
+						wdl < WDL_BLESSED_LOSS ? UPPER_BOUND :
+						wdl > WDL_CURSED_WIN ? LOWER_BOUND :
+						EXACT;
+
+					if (flag == EXACT || (flag == LOWER_BOUND ? value >= beta : value <= alpha))
+					{
+						ttEntry->Update(ttHash, MOVE_NONE, std::min(MAX_PLY - 1, depth + 6), GetValueForTT(value, stack->Ply), flag, m_TranspositionTable.GetAge(), stack->TTIsPv);
+						return value;
+					}
+				}
+			}
+		}
+
 		if (!inCheck)
 		{
 			if (stack->TTHit)
@@ -566,14 +698,15 @@ namespace Boxfish
 				if ((stack - 1)->CurrentMove == MOVE_NONE && !IsRoot)
 					stack->StaticEvaluation = -(stack - 1)->StaticEvaluation + 20;
 				else
-					stack->StaticEvaluation = StaticEvalPosition(position, alpha, beta, stack->Ply);
+					stack->StaticEvaluation = StaticEvalPosition(thread, position, alpha, beta, stack->Ply);
 			}
 		}
 
 		// Razoring
 		if (!IsRoot && depth == 1 && !inCheck && stack->StaticEvaluation <= alpha - 250)
 		{
-			return QuiescenceSearch<NT>(position, stack, 0, alpha, beta);
+			BOX_STAT(thread, STAT_RAZORING);
+			return QuiescenceSearch<NT>(thread, position, stack, 0, alpha, beta);
 		}
 
 		const bool improving = !inCheck &&
@@ -583,12 +716,16 @@ namespace Boxfish
 			
 		// Futility pruning
 		if (!IsPvNode && !inCheck && depth < 8 && stack->StaticEvaluation - 110 * (depth - improving) >= beta && !IsMateScore(stack->StaticEvaluation))
+		{
+			BOX_STAT(thread, STAT_FUTILITY_PRUNES);
 			return stack->StaticEvaluation;
+		}
 
 		// Null move pruning
 		if (!IsPvNode && !inCheck && (stack - 1)->CurrentMove != MOVE_NONE && stack->ExcludedMove == MOVE_NONE && stack->StaticEvaluation >= (beta + 90 - 15 * depth - 14 * improving + 40 * stack->TTIsPv) && !IsEndgame(position))
 		{
 			int depthReduction = std::max((stack->StaticEvaluation - beta) * depth / 300, 3);
+			BOX_STAT(thread, STAT_NULL_MOVE_TRIES);
 
 			UndoInfo undo;
 			ApplyNullMove(position, &undo);
@@ -596,12 +733,15 @@ namespace Boxfish
 			stack->MoveCount = FirstMoveIndex;
 			stack->CurrentMove = MOVE_NONE;
 
-			ValueType value = -SearchPosition<NonPV>(position, stack + 1, depth - depthReduction, -beta, -beta + 1, selDepth, !cutNode, rootInfo);
+			ValueType value = -SearchPosition<NonPV>(thread, position, stack + 1, depth - depthReduction, -beta, -beta + 1, selDepth, !cutNode, rootInfo);
 
 			UndoNullMove(position, undo);
 
 			if (value >= beta)
+			{
+				BOX_STAT(thread, STAT_NULL_MOVE_CUTOFFS);
 				return IsMateScore(value) ? beta : value;
+			}
 		}
 
 		if (IsPvNode && depth >= 6 && ttMove == MOVE_NONE && !inCheck)
@@ -611,20 +751,15 @@ namespace Boxfish
 
 		Move bestMove = MOVE_NONE;
 		MoveGenerator movegen(position);
-		MoveList legalMoves = m_MovePool.GetList();
-		movegen.GetPseudoLegalMoves(legalMoves);
-		movegen.FilterLegalMoves(legalMoves);
-		if (legalMoves.Empty())
-		{
-			if (inCheck)
-				return MatedIn(stack->Ply);
-			return EvaluateDraw(position, stack->Contempt);
-		}
+		if (!IsRoot && ttMove != MOVE_NONE && !(movegen.IsPseudoLegal(ttMove) && movegen.IsLegal(ttMove)))
+			ttMove = MOVE_NONE;
+
+		MoveList moves = thread.Pool.GetList();
 		Move previousMove = (stack - 1)->CurrentMove;
-		Move counterMove = m_OrderingTables.CounterMoves[previousMove.GetFromSquareIndex()][previousMove.GetToSquareIndex()];
+		Move counterMove = thread.Tables.CounterMoves[previousMove.GetFromSquareIndex()][previousMove.GetToSquareIndex()];
 		Move move = MOVE_NONE;
 
-		MoveSelector selector(&legalMoves, &position, ttMove, counterMove, previousMove, &m_OrderingTables, stack->KillerMoves);
+		MoveSelector selector(&moves, &position, ttMove, counterMove, previousMove, &thread.Tables, stack->KillerMoves);
 
 		const bool ttMoveIsCapture = ttMove != MOVE_NONE && ttMove.IsCapture();
 		int moveIndex = 0;
@@ -632,8 +767,10 @@ namespace Boxfish
 
 		bool moveCountPruning = false;
 		bool singularExtension = false;
+		BOX_STAT(thread, STAT_EXPANDED_NODES);
 
-		while ((move = selector.GetNextMove(moveCountPruning)) != MOVE_NONE)
+		// Skipping quiets once moveCountPruning is set loses tactics until the margins are tuned
+		while ((move = selector.GetNextMove(false)) != MOVE_NONE)
 		{
 			const bool isCaptureOrPromotion = move.IsCaptureOrPromotion();
 
@@ -641,18 +778,17 @@ namespace Boxfish
 				continue;
 			if (IsRoot && std::count(rootInfo.Moves.begin() + rootInfo.PVIndex, rootInfo.Moves.begin() + rootInfo.PVLast, move) == 0)
 				continue;
+			// Evasions are generated legal and the TT move has already been validated
+			if (!inCheck && !movegen.IsLegal(move))
+				continue;
 
 			moveIndex++;
 			BOX_ASSERT(moveIndex > FirstMoveIndex || move == ttMove || ttMove == MOVE_NONE || ttMove == stack->ExcludedMove, "Invalid move ordering");
 			int depthExtension = 0;
 
-			Position movedPosition = position;
-			ApplyMove(movedPosition, move);
-			m_Nodes++;
-
 			stack->MoveCount = moveIndex;
 
-			const bool givesCheck = movedPosition.InCheck();
+			const bool givesCheck = GivesCheck(position, move);
 			const bool givesGoodCheck = givesCheck && SeeGE(position, move);
 
 			if (!IsRoot && position.GetNonPawnMaterial(position.TeamToPlay) > 0 && !IsMateScore(bestValue))
@@ -664,20 +800,26 @@ namespace Boxfish
 					int lmrDepth = std::max(depth - 1 - GetReduction<PV>(improving, depth, moveIndex), 0);
 
 					if (!SeeGE(position, move, -(25 - std::min(lmrDepth, 18)) * lmrDepth * lmrDepth))
+					{
+						BOX_STAT(thread, STAT_SEE_PRUNES);
 						continue;
+					}
 				}
 				else if (!SeeGE(position, move, -110 * depth))
+				{
+					BOX_STAT(thread, STAT_SEE_PRUNES);
 					continue;
+				}
 			}
 
 			// Singular extension
-			if (!IsRoot && depth >= 7 && move == ttMove && stack->ExcludedMove == MOVE_NONE && !IsMateScore(ttValue) && (ttEntry->GetFlag() & LOWER_BOUND) && ttEntry->GetDepth() >= depth - 3)
+			if (!IsRoot && depth >= 7 && move == ttMove && stack->ExcludedMove == MOVE_NONE && !IsMateScore(ttValue) && (ttData.GetFlag() & LOWER_BOUND) && ttData.GetDepth() >= depth - 3)
 			{
 				ValueType singularBeta = ttValue - ((formerPv + 4) * depth) / 2;
 				int singularDepth = (depth - 1 + 3 * formerPv) / 2;
 
 				stack->ExcludedMove = move;
-				ValueType value = SearchPosition<NonPV>(position, stack, singularDepth, singularBeta - 1, singularBeta, selDepth, cutNode, rootInfo);
+				ValueType value = SearchPosition<NonPV>(thread, position, stack, singularDepth, singularBeta - 1, singularBeta, selDepth, cutNode, rootInfo);
 				stack->ExcludedMove = MOVE_NONE;
 
 				if (value < singularBeta)
@@ -690,7 +832,7 @@ namespace Boxfish
 				else if (ttValue >= beta)
 				{
 					stack->ExcludedMove = move;
-					value = SearchPosition<NonPV>(position, stack, (depth + 3) / 2, beta - 1, beta, selDepth, cutNode, rootInfo);
+					value = SearchPosition<NonPV>(thread, position, stack, (depth + 3) / 2, beta - 1, beta, selDepth, cutNode, rootInfo);
 					stack->ExcludedMove = MOVE_NONE;
 
 					if (value >= beta)
@@ -703,7 +845,12 @@ namespace Boxfish
 			int extendedDepth = depth - 1 + depthExtension;
 
 			stack->CurrentMove = move;
-			m_TranspositionTable.Prefetch(movedPosition.Hash);
+
+			UndoInfo undo;
+			ApplyMove(position, move, &undo);
+			thread.Nodes.fetch_add(1, std::memory_order_relaxed);
+			BOX_STAT(thread, STAT_MOVES_SEARCHED);
+			m_TranspositionTable.Prefetch(position.Hash);
 
 			bool fullDepthSearch = false;
 			int depthReduction = 0;
@@ -737,8 +884,11 @@ namespace Boxfish
 
 				int d = std::clamp(extendedDepth - reduction, 1, extendedDepth);
 
-				value = -SearchPosition<NonPV>(movedPosition, stack + 1, d, -(alpha + 1), -alpha, selDepth, true, rootInfo);
+				value = -SearchPosition<NonPV>(thread, position, stack + 1, d, -(alpha + 1), -alpha, selDepth, true, rootInfo);
 				fullDepthSearch = value > alpha && d != extendedDepth;
+				BOX_STAT(thread, STAT_LMR_SEARCHES);
+				if (fullDepthSearch)
+					BOX_STAT(thread, STAT_LMR_RESEARCHES);
 			}
 			else
 			{
@@ -747,18 +897,20 @@ namespace Boxfish
 
 			if (fullDepthSearch)
 			{
-				value = -SearchPosition<NonPV>(movedPosition, stack + 1, extendedDepth, -(alpha + 1), -alpha, selDepth, !cutNode, rootInfo);
+				value = -SearchPosition<NonPV>(thread, position, stack + 1, extendedDepth, -(alpha + 1), -alpha, selDepth, !cutNode, rootInfo);
 			}
 			if (IsPvNode && (moveIndex == FirstMoveIndex || (value > alpha && (IsRoot || value < beta))))
 			{
 				pv[0] = MOVE_NONE;
 				(stack + 1)->PV = pv;
-				value = -SearchPosition<PV>(movedPosition, stack + 1, extendedDepth, -beta, -alpha, selDepth, false, rootInfo);
+				value = -SearchPosition<PV>(thread, position, stack + 1, extendedDepth, -beta, -alpha, selDepth, false, rootInfo);
 			}
 
-			if (CheckLimits())
+			UndoMove(position, move, undo);
+
+			if (CheckLimits(thread))
 			{
-				m_WasStopped = true;
+				thread.WasStopped = true;
 				return SCORE_NONE;
 			}
 
@@ -798,23 +950,35 @@ namespace Boxfish
 			// Beta cutoff - Fail high
 			if (value >= beta)
 			{
+				BOX_STAT(thread, STAT_BETA_CUTOFFS);
+				if (moveIndex == FirstMoveIndex)
+					BOX_STAT(thread, STAT_FIRST_MOVE_CUTOFFS);
 				if (!isCaptureOrPromotion)
 				{
-					m_OrderingTables.CounterMoves[previousMove.GetFromSquareIndex()][previousMove.GetToSquareIndex()] = move;
-					UpdateQuietStats(position, stack, depth, move);
+					thread.Tables.CounterMoves[previousMove.GetFromSquareIndex()][previousMove.GetToSquareIndex()] = move;
+					UpdateQuietStats(thread, position, stack, depth, move);
 				}
 				if (stack->ExcludedMove == MOVE_NONE && rootInfo.PVIndex == 0)
 				{
-					ttEntry->Update(ttHash, move, depth, GetValueForTT(value, stack->Ply), LOWER_BOUND, position.GetTotalHalfMoves(), IsPvNode);
+					ttEntry->Update(ttHash, move, depth, GetValueForTT(value, stack->Ply), LOWER_BOUND, m_TranspositionTable.GetAge(), IsPvNode);
 				}
 				return value;
 			}
 			else if (!isCaptureOrPromotion)
 			{
-				m_OrderingTables.Butterfly[position.TeamToPlay][move.GetFromSquareIndex()][move.GetToSquareIndex()] += depth * depth;
+				thread.Tables.Butterfly[position.TeamToPlay][move.GetFromSquareIndex()][move.GetToSquareIndex()] += depth * depth;
 			}
 		}
 
+		if (moveIndex == 0)
+		{
+			if (stack->ExcludedMove != MOVE_NONE)
+				return alpha;
+			if (inCheck)
+				return MatedIn(stack->Ply);
+			return EvaluateDraw(position, stack->Contempt);
+		}
+
 		if (bestValue <= alpha)
 			stack->TTIsPv = stack->TTIsPv || ((stack->TTIsPv) && depth > 3);
 		else if (depth > 3)
@@ -823,35 +987,43 @@ namespace Boxfish
 		EntryFlag entryFlag = (bestValue > originalAlpha) ? EXACT : UPPER_BOUND;
 		if (stack->ExcludedMove == MOVE_NONE && !(IsRoot && rootInfo.PVIndex == 0))
 		{
-			ttEntry->Update(ttHash, bestMove, depth, GetValueForTT(bestValue, stack->Ply), entryFlag, position.GetTotalHalfMoves(), IsPvNode);
+			ttEntry->Update(ttHash, bestMove, depth, GetValueForTT(bestValue, stack->Ply), entryFlag, m_TranspositionTable.GetAge(), IsPvNode);
 		}
 		return bestValue;
 	}
 
 	template<Search::NodeType NT>
-	ValueType Search::QuiescenceSearch(Position& position, SearchStack* stack, int depth, ValueType alpha, ValueType beta)
+	ValueType Search::QuiescenceSearch(ThreadData& thread, Position& position, SearchStack* stack, int depth, ValueType alpha, ValueType beta)
 	{
 		constexpr bool IsPvNode = NT == PV;
 		const bool inCheck = position.InCheck();
 
-		MoveList pvMoveList = m_MovePool.GetList();
+		MoveList pvMoveList = thread.Pool.GetList();
 		Move* pv = pvMoveList.Moves;
 
+		if (!thread.Accumulators.empty())
+			ResetAccumulator(thread, stack);
+
 		ValueType originalAlpha = alpha;
 
 		ZobristHash ttHash = position.Hash;
 		if (stack->ExcludedMove != MOVE_NONE)
 			ttHash ^= stack->ExcludedMove.GetKey();
-		TranspositionTableEntry* ttEntry = m_TranspositionTable.GetEntry(ttHash, stack->TTHit);
-		ValueType ttValue = stack->TTHit ? GetValueFromTT(ttEntry->GetScore(), stack->Ply) : SCORE_NONE;
+		TranspositionTableData ttData;
+		TranspositionTableEntry* ttEntry = m_TranspositionTable.GetEntry(ttHash, stack->TTHit, ttData);
+		ValueType ttValue = stack->TTHit ? GetValueFromTT(ttData.GetScore(), stack->Ply) : SCORE_NONE;
+		BOX_STAT(thread, STAT_QUIESCENCE_NODES);
+		BOX_STAT(thread, STAT_TT_PROBES);
+		if (stack->TTHit)
+			BOX_STAT(thread, STAT_TT_HITS);
 
 		if (!IsPvNode && stack->TTHit && !IsMateScore(ttValue))
 		{
-			if (ttEntry->GetFlag() == EXACT)
+			if (ttData.GetFlag() == EXACT)
 				return ttValue;
-			if (ttEntry->GetFlag() == UPPER_BOUND && ttValue <= alpha)
+			if (ttData.GetFlag() == UPPER_BOUND && ttValue <= alpha)
 				return ttValue;
-			if (ttEntry->GetFlag() == LOWER_BOUND && ttValue >= beta)
+			if (ttData.GetFlag() == LOWER_BOUND && ttValue >= beta)
 				return ttValue;
 		}
 
@@ -861,15 +1033,15 @@ namespace Boxfish
 		ValueType evaluation = MatedIn(stack->Ply);
 		if (!inCheck)
 		{
-			if (stack->TTHit && ttEntry->GetDepth() >= depth - 3 && (ttEntry->GetFlag() & LOWER_BOUND) && !IsMateScore(ttValue))
+			if (stack->TTHit && ttData.GetDepth() >= depth - 3 && (ttData.GetFlag() & LOWER_BOUND) && !IsMateScore(ttValue))
 				evaluation = ttValue;
 			else
-				evaluation = StaticEvalPosition(position, alpha, beta, stack->Ply);
+				evaluation = StaticEvalPosition(thread, position, alpha, beta, stack->Ply);
 
 			if (evaluation >= beta)
 			{
 				if (stack->ExcludedMove != MOVE_NONE)
-					ttEntry->Update(ttHash, MOVE_NONE, depth, GetValueForTT(evaluation, stack->Ply), LOWER_BOUND, position.GetTotalHalfMoves(), IsPvNode);
+					ttEntry->Update(ttHash, MOVE_NONE, depth, GetValueForTT(evaluation, stack->Ply), LOWER_BOUND, m_TranspositionTable.GetAge(), IsPvNode);
 				return evaluation;
 			}
 			if (alpha < evaluation)
@@ -882,15 +1054,18 @@ namespace Boxfish
 		(stack + 1)->Ply = stack->Ply + 1;
 		(stack + 1)->Contempt = -stack->Contempt;
 
+		// Only captures are searched when not in check so quiet moves are never generated, stalemates are left to the main search
 		MoveGenerator generator(position);
-		MoveList legalMoves = m_MovePool.GetList();
-		generator.GetPseudoLegalMoves(legalMoves);
-
-		if (legalMoves.MoveCount <= 0)
+		MoveList moves = thread.Pool.GetList();
+		if (inCheck)
 		{
-			if (inCheck)
+			generator.Generate<EVASIONS>(moves);
+			if (moves.MoveCount <= 0)
 				return MatedIn(stack->Ply);
-			return EvaluateDraw(position, stack->Contempt);
+		}
+		else
+		{
+			generator.Generate<CAPTURES>(moves);
 		}
 
 		if (!inCheck && evaluation >= beta + 250)
@@ -904,81 +1079,135 @@ namespace Boxfish
 
 		constexpr int FIRST_MOVE_INDEX = 1;
 		int moveIndex = 0;
-		QuiescenceMoveSelector selector(position, legalMoves, inCheck);
+		QuiescenceMoveSelector selector(position, moves, inCheck);
 		Move move;
 
 		while (!selector.Empty())
 		{
-			moveIndex++;
 			move = selector.GetNextMove();
+			if (!inCheck && !generator.IsLegal(move))
+				continue;
+			moveIndex++;
 
-			if (generator.IsLegal(move))
-			{
-				Position movedPosition = position;
-				ApplyMove(movedPosition, move);
-				m_Nodes++;
+			UndoInfo undo;
+			ApplyMove(position, move, &undo);
+			thread.Nodes.fetch_add(1, std::memory_order_relaxed);
 
-				m_TranspositionTable.Prefetch(movedPosition.Hash);
+			m_TranspositionTable.Prefetch(position.Hash);
 
-				stack->CurrentMove = move;
+			stack->CurrentMove = move;
 
-				if (IsPvNode)
-				{
-					pv[0] = MOVE_NONE;
-					(stack + 1)->PV = pv;
-				}
+			if (IsPvNode)
+			{
+				pv[0] = MOVE_NONE;
+				(stack + 1)->PV = pv;
+			}
 
-				ValueType score = -QuiescenceSearch<NT>(movedPosition, stack + 1, depth - 1, -beta, -alpha);
-				if (score > bestValue)
-					bestValue = score;
+			ValueType score = -QuiescenceSearch<NT>(thread, position, stack + 1, depth - 1, -beta, -alpha);
+			UndoMove(position, move, undo);
+			if (score > bestValue)
+				bestValue = score;
 
-				if (CheckLimits())
-				{
-					m_WasStopped = true;
-					return SCORE_NONE;
-				}
+			if (CheckLimits(thread))
+			{
+				thread.WasStopped = true;
+				return SCORE_NONE;
+			}
 
-				if (score > alpha)
+			if (score > alpha)
+			{
+				alpha = score;
+				if (IsPvNode && (stack + 1)->PV)
 				{
-					alpha = score;
-					if (IsPvNode && (stack + 1)->PV)
-					{
-						UpdatePV(stack->PV, move, (stack + 1)->PV);
-					}
+					UpdatePV(stack->PV, move, (stack + 1)->PV);
 				}
+			}
 
-				if (score >= beta)
-				{
-					if (stack->ExcludedMove != MOVE_NONE)
-						ttEntry->Update(ttHash, move, depth, GetValueForTT(score, stack->Ply), LOWER_BOUND, position.GetTotalHalfMoves(), IsPvNode);
-					return score;
-				}
+			if (score >= beta)
+			{
+				if (stack->ExcludedMove != MOVE_NONE)
+					ttEntry->Update(ttHash, move, depth, GetValueForTT(score, stack->Ply), LOWER_BOUND, m_TranspositionTable.GetAge(), IsPvNode);
+				return score;
 			}
 		}
 
 		EntryFlag entryFlag = (alpha > originalAlpha) ? EXACT : UPPER_BOUND;
 		if (stack->ExcludedMove == MOVE_NONE)
-			ttEntry->Update(ttHash, MOVE_NONE, depth, GetValueForTT(alpha, stack->Ply), entryFlag, position.GetTotalHalfMoves(), IsPvNode);
+			ttEntry->Update(ttHash, MOVE_NONE, depth, GetValueForTT(alpha, stack->Ply), entryFlag, m_TranspositionTable.GetAge(), IsPvNode);
 
 		return alpha;
 	}
 
-	bool Search::CheckLimits() const
+	void Search::SetThreadCount(int threads)
+	{
+		threads = std::max(threads, 1);
+		if (m_Threads.size() == (size_t)threads)
+			return;
+		m_Threads.clear();
+		for (int i = 0; i < threads; i++)
+			m_Threads.push_back(std::make_unique<ThreadData>(i));
+	}
+
+	size_t Search::GetTotalNodes() const
+	{
+		size_t nodes = 0;
+		for (const std::unique_ptr<ThreadData>& thread : m_Threads)
+			nodes += thread->Nodes.load(std::memory_order_relaxed);
+		return nodes;
+	}
+
+	SearchStats Search::GetSearchStats() const
+	{
+		SearchStats stats;
+		for (const std::unique_ptr<ThreadData>& thread : m_Threads)
+			stats += thread->Stats;
+		return stats;
+	}
+
+	size_t Search::GetTotalTablebaseHits() const
+	{
+		size_t hits = 0;
+		for (const std::unique_ptr<ThreadData>& thread : m_Threads)
+			hits += thread->TablebaseHits.load(std::memory_order_relaxed);
+		return hits;
+	}
+
+	const Search::ThreadData& Search::SelectBestThread() const
+	{
+		const ThreadData* bestThread = m_Threads[0].get();
+		for (const std::unique_ptr<ThreadData>& thread : m_Threads)
+		{
+			if (thread->RootMoves.empty())
+				continue;
+			// A deeper completed iteration is more reliable than a higher score from a shallower one
+			if (bestThread->RootMoves.empty() || thread->CompletedDepth > bestThread->CompletedDepth ||
+				(thread->CompletedDepth == bestThread->CompletedDepth && thread->RootMoves[0].Score > bestThread->RootMoves[0].Score))
+				bestThread = thread.get();
+		}
+		return *bestThread;
+	}
+
+	bool Search::CheckLimits(const ThreadData& thread) const
 	{
-		if (m_Limits.Infinite)
-			return m_ShouldStop;
+		if (m_ShouldStop || m_StopThreads || thread.WasStopped)
+			return true;
+		// Helpers only stop when the main thread tells them to
+		if (m_Limits.Infinite || thread.Index != 0)
+			return false;
 		// Only check every 1024 nodes
-		if (m_Limits.Milliseconds > 0 && !(m_Nodes & 1023))
+		if ((m_Limits.Milliseconds > 0 || m_TimeManager.IsEnabled()) && !(thread.Nodes.load(std::memory_order_relaxed) & 1023))
 		{
 			auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - m_StartTime);
-			if (elapsed.count() >= m_Limits.Milliseconds)
+			if (m_Limits.Milliseconds > 0 && elapsed.count() >= m_Limits.Milliseconds)
+				return true;
+			if (m_TimeManager.IsEnabled() && elapsed.count() >= m_TimeManager.GetMaximumTime())
 				return true;
 		}
 		if (m_Limits.Nodes > 0)
 		{
-			return m_Nodes >= m_Limits.Nodes;
+			return GetTotalNodes() >= m_Limits.Nodes;
 		}
-		return m_ShouldStop || m_WasStopped;
+		return false;
 	}
 
 	bool Search::IsDraw(const Position& position, SearchStack* stack) const
@@ -1024,7 +1253,7 @@ namespace Boxfish
 
 	ValueType Search::GetValueForTT(ValueType value, int currentPly) const
 	{
-		if (IsMateScore(value))
+		if (IsDecisiveScore(value))
 		{
 			if (value > 0)
 				return value + currentPly;
@@ -1036,7 +1265,7 @@ namespace Boxfish
 
 	ValueType Search::GetValueFromTT(ValueType value, int currentPly) const
 	{
-		if (IsMateScore(value))
+		if (IsDecisiveScore(value))
 		{
 			if (value > 0)
 				return value - currentPly;
@@ -1058,28 +1287,54 @@ namespace Boxfish
 		return score != SCORE_NONE && (score >= MateIn(MAX_PLY) || score <= MatedIn(MAX_PLY));
 	}
 
-	ValueType Search::StaticEvalPosition(const Position& position, ValueType alpha, ValueType beta, int ply) const
+	bool Search::IsDecisiveScore(ValueType score) const
+	{
+		return score != SCORE_NONE && (score >= SCORE_TABLEBASE_WIN - MAX_PLY || score <= -SCORE_TABLEBASE_WIN + MAX_PLY);
+	}
+
+	ValueType Search::StaticEvalPosition(ThreadData& thread, const Position& position, ValueType alpha, ValueType beta, int ply) const
 	{
 		BOX_ASSERT(!position.InCheck(), "Cannot evaluate position in check");
-		return Evaluate(position, position.TeamToPlay, alpha, beta);
+		EvalHashEntry* entry = thread.EvalTable.GetEntry(position.Hash);
+		if (entry->Key == position.Hash.Hash)
+			return entry->Score;
+		bool lazy = false;
+		// The accumulators are only allocated when the search uses the NNUE
+		ValueType evaluation = !thread.Accumulators.empty()
+			? EvaluateNNUE(position, position.TeamToPlay, thread.Accumulators.data(), ply)
+			: Evaluate(position, position.TeamToPlay, alpha, beta, &thread.PawnTable, m_Settings.LazyEvalMargin, &lazy);
+		// Lazy evaluations depend on the window so are not reused
+		if (!lazy)
+		{
+			entry->Key = position.Hash.Hash;
+			entry->Score = evaluation;
+		}
+		return evaluation;
+	}
+
+	void Search::ResetAccumulator(ThreadData& thread, SearchStack* stack) const
+	{
+		NNUEAccumulator& accumulator = thread.Accumulators[stack->Ply];
+		accumulator.Computed[TEAM_WHITE] = false;
+		accumulator.Computed[TEAM_BLACK] = false;
+		accumulator.LastMove = (stack - 1)->CurrentMove;
 	}
 
-	void Search::UpdateQuietStats(const Position& position, SearchStack* stack, int depth, Move move)
+	void Search::UpdateQuietStats(ThreadData& thread, const Position& position, SearchStack* stack, int depth, Move move)
 	{
 		if (move != stack->KillerMoves[0] && move != stack->KillerMoves[1])
 		{
 			stack->KillerMoves[1] = stack->KillerMoves[0];
 			stack->KillerMoves[0] = move;
 		}
-		m_OrderingTables.History[position.TeamToPlay][move.GetFromSquareIndex()][move.GetToSquareIndex()] += depth * depth;
+		thread.Tables.History[position.TeamToPlay][move.GetFromSquareIndex()][move.GetToSquareIndex()] += depth * depth;
 	}
 
-	std::vector<Search::RootMove> Search::GenerateRootMoves(const Position& position, SearchStack* stack)
+	std::vector<Search::RootMove> Search::GenerateRootMoves(ThreadData& thread, const Position& position, SearchStack* stack)
 	{
-		MoveList list = m_MovePool.GetList();
+		MoveList list = thread.Pool.GetList();
 		MoveGenerator generator(position);
-		generator.GetPseudoLegalMoves(list);
-		generator.FilterLegalMoves(list);
+		generator.GetLegalMoves(list);
 		std::vector<RootMove> result;
 		for (int i = 0; i < list.MoveCount; i++)
 		{
@@ -1091,6 +1346,28 @@ namespace Boxfish
 				result.push_back(mv);
 			}
 		}
+
+		// Only keep the moves that preserve the tablebase result, the search then picks between them
+		if (result.size() > 1 && m_TablebaseLimit > 0)
+		{
+			std::vector<Move> moves;
+			for (const RootMove& mv : result)
+				moves.push_back(mv.PV[0]);
+			std::vector<int> ranks(moves.size());
+			Position rootPosition = position;
+			if (RankRootMoves(rootPosition, moves.data(), (int)moves.size(), ranks.data()))
+			{
+				thread.TablebaseHits.fetch_add(moves.size(), std::memory_order_relaxed);
+				int bestRank = *std::max_element(ranks.begin(), ranks.end());
+				std::vector<RootMove> filtered;
+				for (size_t i = 0; i < result.size(); i++)
+				{
+					if (ranks[i] == bestRank)
+						filtered.push_back(result[i]);
+				}
+				result = filtered;
+			}
+		}
 		return result;
 	}
 
@@ -1,14 +1,21 @@
 #pragma once
 #include "MoveGenerator.h"
 #include "Evaluation.h"
+#include "NNUE.h"
 #include "PositionUtils.h"
 #include "TranspositionTable.h"
+#include "EvalHashTable.h"
 #include "MoveSelector.h"
 #include "Settings.h"
 #include "Book.h"
+#include "Tablebase.h"
+#include "Perft.h"
+#include "SearchStats.h"
+#include "TimeManager.h"
 
 #include <chrono>
 #include <atomic>
+#include <memory>
 #include <unordered_set>
 
 #ifdef SWIG
@@ -27,6 +34,10 @@ namespace Boxfish
 		int Depth = -1;
 		int64_t Nodes = -1;
 		int Milliseconds = -1;
+		// Clock time left and increment per move for each team, a negative time means there is no clock
+		int Time[TEAM_MAX] = { -1, -1 };
+		int Increment[TEAM_MAX] = { 0, 0 };
+		int MovesToGo = 0;
 		std::unordered_set<Move> Only = {};
 	};
 
@@ -92,25 +103,47 @@ namespace Boxfish
 			int PVLast;
 		};
 
+		// State owned by a single search thread, everything else (TT, limits, history) is shared
+		struct BOX_API ThreadData
+		{
+		public:
+			int Index;
+			MovePool Pool;
+			OrderingTables Tables;
+			PawnHashTable PawnTable;
+			EvalHashTable EvalTable;
+			std::atomic<size_t> Nodes;
+			std::atomic<size_t> TablebaseHits;
+			SearchStats Stats;
+			int CompletedDepth;
+			bool WasStopped;
+			std::vector<RootMove> RootMoves;
+			// Indexed by ply, only allocated while searching with the NNUE
+			std::vector<NNUEAccumulator> Accumulators;
+
+		public:
+			ThreadData(int index);
+		};
+
 	private:
 		TranspositionTable m_TranspositionTable;
+		PerftHashTable m_PerftTable;
 		BoxfishSettings m_Settings;
 		SearchLimits m_Limits;
+		TimeManager m_TimeManager;
 		std::vector<ZobristHash> m_PositionHistory;
 		const OpeningBook* m_OpeningBook;
 
-		MovePool m_MovePool;
+		std::vector<std::unique_ptr<ThreadData>> m_Threads;
+		// Largest number of pieces probed in the tablebases, fixed when a search starts
+		int m_TablebaseLimit;
 
-		size_t m_Nodes;
-		std::chrono::time_point<std::chrono::high_resolution_clock> m_SearchRootStartTime;
 		std::chrono::time_point<std::chrono::high_resolution_clock> m_StartTime;
 
-		bool m_WasStopped;
 		std::atomic<bool> m_ShouldStop;
+		std::atomic<bool> m_StopThreads;
 		bool m_Log;
 
-		OrderingTables m_OrderingTables;
-
 	public:
 		Search(size_t transpositionTableSize = TranspositionTable::TABLE_SIZE, bool log = true);
 
@@ -120,11 +153,21 @@ namespace Boxfish
 		void SetLimits(const SearchLimits& limits);
 		void PushPosition(const Position& position);
 		void Reset();
+		void ClearTranspositionTable();
+		void ClearEvaluationCache();
+		bool SaveTranspositionTable(const std::string& filename) const;
+		bool LoadTranspositionTable(const std::string& filename);
 		void SetOpeningBook(const OpeningBook* book);
 
-		const TranspositionTableEntry* ProbeTranspostionTable(const Position& position) const;
+		bool ProbeTranspostionTable(const Position& position, TranspositionTableData& data) const;
+		// Nodes searched by every thread since the start of the last search
+		size_t GetTotalNodes() const;
+		// Counters summed over every thread for the last search, all zero unless built with BOX_SEARCH_STATS.
+		// Must not be called while searching
+		SearchStats GetSearchStats() const;
 
 		size_t Perft(const Position& position, int depth);
+		PerftResult Divide(const Position& position, int depth);
 		Move SearchBestMove(const Position& position, SearchLimits limits);
 		Move SearchBestMove(const Position& position, SearchLimits limits, const std::function<void(SearchResult)>& callback);
 		void Ponder(const Position& position, SearchLimits limits, const std::function<void(SearchResult)>& callback = {});
@@ -133,15 +176,19 @@ namespace Boxfish
 		void Stop();
 
 	private:
-		size_t PerftPosition(Position& position, int depth);
+		void LogPerft(const PerftResult& result, bool divide) const;
+		void LogSearchInfo(const RootMove& rootMove, int depth, int pvIndex) const;
 
-		RootMove SearchRoot(Position& position, int depth, const std::function<void(SearchResult)>& callback);
+		RootMove SearchRoot(ThreadData& thread, Position& position, int depth, const std::function<void(SearchResult)>& callback);
 		template<NodeType type>
-		ValueType SearchPosition(Position& position, SearchStack* stack, int depth, ValueType alpha, ValueType beta, int& selDepth, bool cutNode, const RootInfo& rootInfo);
+		ValueType SearchPosition(ThreadData& thread, Position& position, SearchStack* stack, int depth, ValueType alpha, ValueType beta, int& selDepth, bool cutNode, const RootInfo& rootInfo);
 		template<NodeType type>
-		ValueType QuiescenceSearch(Position& position, SearchStack* stack, int depth, ValueType alpha, ValueType beta);
+		ValueType QuiescenceSearch(ThreadData& thread, Position& position, SearchStack* stack, int depth, ValueType alpha, ValueType beta);
 
-		bool CheckLimits() const;
+		void SetThreadCount(int threads);
+		size_t GetTotalTablebaseHits() const;
+		const ThreadData& SelectBestThread() const;
+		bool CheckLimits(const ThreadData& thread) const;
 
 		bool IsDraw(const Position& position, SearchStack* stack) const;
 		ValueType EvaluateDraw(const Position& postion, ValueType contempt) const;
@@ -151,11 +198,15 @@ namespace Boxfish
 		ValueType GetValueFromTT(ValueType value, int currentPly) const;
 		int GetPliesFromMateScore(ValueType score) const;
 		bool IsMateScore(ValueType score) const;
-		ValueType StaticEvalPosition(const Position& position, ValueType alpha, ValueType beta, int ply) const;
+		// Mate or tablebase win/loss, these are stored in the TT relative to the node instead of the root
+		bool IsDecisiveScore(ValueType score) const;
+		ValueType StaticEvalPosition(ThreadData& thread, const Position& position, ValueType alpha, ValueType beta, int ply) const;
+		// Called when entering a node, the accumulator of the previous node at this ply belongs to a different position
+		void ResetAccumulator(ThreadData& thread, SearchStack* stack) const;
 
-		void UpdateQuietStats(const Position& position, SearchStack* stack, int depth, Move move);
+		void UpdateQuietStats(ThreadData& thread, const Position& position, SearchStack* stack, int depth, Move move);
 
-		std::vector<RootMove> GenerateRootMoves(const Position& position, SearchStack* stack);
+		std::vector<RootMove> GenerateRootMoves(ThreadData& thread, const Position& position, SearchStack* stack);
 		int ChooseBestMove(const std::vector<RootMove>& moves, int skillLevel, int maxPVs) const;
 	};
 
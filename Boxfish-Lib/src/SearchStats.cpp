@@ -0,0 +1,54 @@
+#include "SearchStats.h"
+#include <cstdio>
+
+namespace Boxfish
+{
+
+	void SearchStats::Clear()
+	{
+		for (int i = 0; i < STAT_MAX; i++)
+			Counters[i] = 0;
+	}
+
+	SearchStats& SearchStats::operator+=(const SearchStats& other)
+	{
+		for (int i = 0; i < STAT_MAX; i++)
+			Counters[i] += other.Counters[i];
+		return *this;
+	}
+
+	static std::string FormatRatio(uint64_t count, uint64_t total)
+	{
+		char buffer[64];
+		snprintf(buffer, sizeof(buffer), "%llu (%.1f%%)", (unsigned long long)count, total > 0 ? 100.0 * count / total : 0.0);
+		return buffer;
+	}
+
+	std::string FormatSearchStats(const SearchStats& stats)
+	{
+		const uint64_t* c = stats.Counters;
+		const uint64_t nodes = c[STAT_MAIN_NODES] + c[STAT_QUIESCENCE_NODES];
+		char branching[32];
+		snprintf(branching, sizeof(branching), "%.2f", c[STAT_EXPANDED_NODES] > 0 ? (double)c[STAT_MOVES_SEARCHED] / c[STAT_EXPANDED_NODES] : 0.0);
+
+		std::string result = "";
+		result += "             Main nodes: " + FormatRatio(c[STAT_MAIN_NODES], nodes) + '\n';
+		result += "       Quiescence nodes: " + FormatRatio(c[STAT_QUIESCENCE_NODES], nodes) + '\n';
+		result += "              TT probes: " + std::to_string(c[STAT_TT_PROBES]) + '\n';
+		result += "                TT hits: " + FormatRatio(c[STAT_TT_HITS], c[STAT_TT_PROBES]) + '\n';
+		result += "             TT cutoffs: " + FormatRatio(c[STAT_TT_CUTOFFS], c[STAT_MAIN_NODES]) + '\n';
+		result += "         Expanded nodes: " + FormatRatio(c[STAT_EXPANDED_NODES], c[STAT_MAIN_NODES]) + '\n';
+		result += "       Branching factor: " + std::string(branching) + '\n';
+		result += "           Beta cutoffs: " + FormatRatio(c[STAT_BETA_CUTOFFS], c[STAT_EXPANDED_NODES]) + '\n';
+		result += "     First move cutoffs: " + FormatRatio(c[STAT_FIRST_MOVE_CUTOFFS], c[STAT_BETA_CUTOFFS]) + '\n';
+		result += "               Razoring: " + FormatRatio(c[STAT_RAZORING], c[STAT_MAIN_NODES]) + '\n';
+		result += "        Futility prunes: " + FormatRatio(c[STAT_FUTILITY_PRUNES], c[STAT_MAIN_NODES]) + '\n';
+		result += "        Null move tries: " + FormatRatio(c[STAT_NULL_MOVE_TRIES], c[STAT_MAIN_NODES]) + '\n';
+		result += "      Null move cutoffs: " + FormatRatio(c[STAT_NULL_MOVE_CUTOFFS], c[STAT_NULL_MOVE_TRIES]) + '\n';
+		result += "             SEE prunes: " + std::to_string(c[STAT_SEE_PRUNES]) + '\n';
+		result += "           LMR searches: " + FormatRatio(c[STAT_LMR_SEARCHES], c[STAT_MOVES_SEARCHED]) + '\n';
+		result += "        LMR re-searches: " + FormatRatio(c[STAT_LMR_RESEARCHES], c[STAT_LMR_SEARCHES]);
+		return result;
+	}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include "Types.h"
+#include <string>
+
+#ifdef SWIG
+#define BOX_API
+#endif
+
+namespace Boxfish
+{
+
+	// Counters are only updated when built with BOX_SEARCH_STATS (premake --stats), otherwise BOX_STAT compiles to nothing
+#ifdef BOX_SEARCH_STATS
+	constexpr bool SEARCH_STATS_ENABLED = true;
+#define BOX_STAT(thread, stat) ((thread).Stats.Counters[stat]++)
+#else
+	constexpr bool SEARCH_STATS_ENABLED = false;
+#define BOX_STAT(thread, stat) ((void)0)
+#endif
+
+	enum SearchStat
+	{
+		STAT_MAIN_NODES,
+		STAT_QUIESCENCE_NODES,
+		STAT_TT_PROBES,
+		STAT_TT_HITS,
+		STAT_TT_CUTOFFS,
+		// Nodes that reached the move loop
+		STAT_EXPANDED_NODES,
+		STAT_MOVES_SEARCHED,
+		STAT_BETA_CUTOFFS,
+		STAT_FIRST_MOVE_CUTOFFS,
+		STAT_RAZORING,
+		STAT_FUTILITY_PRUNES,
+		STAT_NULL_MOVE_TRIES,
+		STAT_NULL_MOVE_CUTOFFS,
+		STAT_SEE_PRUNES,
+		STAT_LMR_SEARCHES,
+		STAT_LMR_RESEARCHES,
+		STAT_MAX
+	};
+
+	struct BOX_API SearchStats
+	{
+	public:
+		uint64_t Counters[STAT_MAX] = {};
+
+	public:
+		void Clear();
+		SearchStats& operator+=(const SearchStats& other);
+	};
+
+	std::string FormatSearchStats(const SearchStats& stats);
+
+}
@@ -1,5 +1,6 @@
 #pragma once
 #include "Types.h"
+#include <string>
 
 #ifdef SWIG
 #define BOX_API
@@ -14,8 +15,21 @@ namespace Boxfish
 		int MultiPV = 1;
 		int SkillLevel = 20;
 		size_t HashTableBytes = 50 * 1024 * 1024;
-		int Threads = 1; // Unused at the moment
+		int Threads = 1;
 		int Contempt = 0;
+		// Evaluate with the loaded NNUE instead of the hand crafted evaluation
+		bool UseNNUE = false;
+		// Evaluate stops after material and piece squares when they are this far outside the search window, 0 disables it.
+		// Disabled until a margin has been shown not to lose strength in games
+		int LazyEvalMargin = 0;
+		// Directories containing Syzygy tablebases, empty to disable probing
+		std::string SyzygyPath = "";
+		// Tablebases with as many pieces as the largest table are only probed at this depth or more
+		int SyzygyProbeDepth = 1;
+		// Memory for caching perft subtree counts, 0 to disable
+		size_t PerftHashBytes = 0;
+		// Milliseconds kept back on every move for communication delays when playing on a clock
+		int MoveOverhead = 30;
 	};
 
 }
\ No newline at end of file
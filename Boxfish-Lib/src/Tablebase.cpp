@@ -0,0 +1,1231 @@
+#include "Tablebase.h"
+#include "Endgame.h"
+#include "MoveGenerator.h"
+#include "PositionUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#if defined(EMSCRIPTEN)
+// Tables are read into memory
+#elif defined(BOX_PLATFORM_WINDOWS)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Prober for the Syzygy WDL (.rtbw) and DTZ (.rtbz) formats, following the reference implementation by Ronald de Man.
+// A table stores one value per position index, compressed with recursive pairing and canonical Huffman codes.
+// Positions are indexed relative to the stronger side (the first half of the file name, e.g. KRvK) with
+// symmetries removed: the leading pawn is kept on files A-D and pawnless positions have their first piece in the A1-D1-D4 triangle.
+
+namespace Boxfish
+{
+
+	static constexpr uint8_t WDL_MAGIC[4] = { 0x71, 0xE8, 0x23, 0x5D };
+	static constexpr uint8_t DTZ_MAGIC[4] = { 0xD7, 0x66, 0x0C, 0xA5 };
+
+	// Rank given to root moves that win or lose regardless of the 50 move counter
+	static constexpr int MAX_DTZ = 1 << 18;
+
+	enum TablebaseType
+	{
+		TB_WDL,
+		TB_DTZ
+	};
+
+	enum TablebaseFlag : uint8_t
+	{
+		TB_FLAG_STM = 1,
+		TB_FLAG_MAPPED = 2,
+		TB_FLAG_WIN_PLIES = 4,
+		TB_FLAG_LOSS_PLIES = 8,
+		TB_FLAG_WIDE = 16,
+		TB_FLAG_SINGLE_VALUE = 128
+	};
+
+	// Huffman symbols use 12 bits
+	using Symbol = uint16_t;
+
+	struct SparseEntry
+	{
+	public:
+		uint8_t Block[4];
+		uint8_t Offset[2];
+	};
+
+	static_assert(sizeof(SparseEntry) == 6, "SparseEntry must be packed");
+
+	// Two 12 bit symbols that a pair symbol expands into, the right symbol is 0xFFF for leaves which store their value on the left
+	struct SymbolPair
+	{
+	public:
+		uint8_t Bytes[3];
+
+		inline Symbol GetLeft() const { return ((Bytes[1] & 0xF) << 8) | Bytes[0]; }
+		inline Symbol GetRight() const { return (Bytes[2] << 4) | (Bytes[1] >> 4); }
+	};
+
+	static_assert(sizeof(SymbolPair) == 3, "SymbolPair must be packed");
+
+	struct PairsData
+	{
+	public:
+		uint8_t Flags = 0;
+		int MaxSymbolLength = 0;
+		int MinSymbolLength = 0;
+		uint32_t BlockCount = 0;
+		size_t BlockSize = 0;
+		// There is a sparse index entry about every Span values
+		size_t Span = 0;
+		const uint8_t* LowestSymbols = nullptr;
+		const SymbolPair* Tree = nullptr;
+		const uint8_t* BlockLengths = nullptr;
+		uint32_t BlockLengthCount = 0;
+		const SparseEntry* SparseIndex = nullptr;
+		size_t SparseIndexSize = 0;
+		const uint8_t* Data = nullptr;
+		// Base64[l - MinSymbolLength] is the lowest symbol of length l padded to 64 bits
+		std::vector<uint64_t> Base64;
+		// Number of values represented by each symbol minus one
+		std::vector<uint8_t> SymbolLengths;
+		// Piece codes in the order used by the encoding, these define the groups
+		int Pieces[TB_MAX_PIECES] = {};
+		uint64_t GroupIndex[TB_MAX_PIECES + 1] = {};
+		int GroupLength[TB_MAX_PIECES + 1] = {};
+		// DTZ only, offsets into the value map for win, loss, cursed win and blessed loss
+		uint16_t MapIndex[4] = {};
+	};
+
+	struct FileMapping
+	{
+	public:
+		uint8_t* BaseAddress = nullptr;
+		size_t Size = 0;
+#if !defined(EMSCRIPTEN) && defined(BOX_PLATFORM_WINDOWS)
+		HANDLE Handle = nullptr;
+#endif
+	};
+
+	struct TablebaseTable
+	{
+	public:
+		TablebaseType Type;
+		std::string Name;
+		// Key with the stronger side as white and as black
+		uint64_t Key;
+		uint64_t Key2;
+		int PieceCount;
+		bool HasPawns;
+		bool HasUniquePieces;
+		// Pawns of the leading team first
+		int PawnCount[TEAM_MAX];
+
+		std::atomic<bool> Ready;
+		FileMapping Mapping;
+		// DTZ only, maps stored values to distances
+		const uint8_t* Map;
+		PairsData Items[TEAM_MAX][FILE_MAX / 2];
+
+	public:
+		TablebaseTable(TablebaseType type, const std::string& name);
+
+		// DTZ tables store a single team to play
+		inline int GetSides() const { return (Type == TB_WDL && Key != Key2) ? 2 : 1; }
+		inline PairsData* Get(int teamToPlay, int file) { return &Items[teamToPlay % (Type == TB_WDL ? 2 : 1)][HasPawns ? file : 0]; }
+	};
+
+	static std::vector<std::string> s_Paths;
+	static std::deque<TablebaseTable> s_Tables;
+	// WDL and DTZ table for both material keys
+	static std::unordered_map<uint64_t, std::pair<TablebaseTable*, TablebaseTable*>> s_TableMap;
+	static std::mutex s_MappingMutex;
+	static int s_Cardinality = 0;
+
+	// Encoding tables
+	static int s_MapPawns[SQUARE_MAX];
+	static int s_MapB1H1H7[SQUARE_MAX];
+	static int s_MapA1D1D4[SQUARE_MAX];
+	static int s_MapKK[10][SQUARE_MAX];
+	static uint64_t s_Binomial[TB_MAX_PIECES - 1][SQUARE_MAX];
+	static uint64_t s_LeadPawnIndex[TB_MAX_PIECES - 1][SQUARE_MAX];
+	static uint64_t s_LeadPawnsSize[TB_MAX_PIECES - 1][FILE_MAX / 2];
+
+	// =================================================================================================================================
+	// UTILS
+	// =================================================================================================================================
+
+	template<typename T>
+	inline T ReadLittleEndian(const void* address)
+	{
+		T value;
+		std::memcpy(&value, address, sizeof(T));
+		return value;
+	}
+
+	template<typename T>
+	inline T ReadBigEndian(const void* address)
+	{
+		const uint8_t* bytes = (const uint8_t*)address;
+		T value = 0;
+		for (size_t i = 0; i < sizeof(T); i++)
+			value = (value << 8) | bytes[i];
+		return value;
+	}
+
+	inline int OffsetA1H8(int square)
+	{
+		return (square >> 3) - (square & 7);
+	}
+
+	inline int FlipFileSquare(int square)
+	{
+		return square ^ 7;
+	}
+
+	inline int FlipRankSquare(int square)
+	{
+		return square ^ 56;
+	}
+
+	inline bool ComparePawns(int a, int b)
+	{
+		return s_MapPawns[a] < s_MapPawns[b];
+	}
+
+	// Piece code used by the files, black pieces have the fourth bit set
+	inline int GetPieceCode(Team team, Piece piece)
+	{
+		return (team << 3) | (piece + 1);
+	}
+
+	inline bool IsZeroingMove(Move move)
+	{
+		return move.IsCapture() || move.GetMovingPiece() == PIECE_PAWN;
+	}
+
+	inline int GetLegalMoveCount(const Position& position)
+	{
+		Move moves[MAX_MOVES];
+		MoveList list(nullptr, moves);
+		MoveGenerator generator(position);
+		generator.GetLegalMoves(list);
+		return list.MoveCount;
+	}
+
+	static void InitEncoding()
+	{
+		int code = 0;
+		for (int square = 0; square < SQUARE_MAX; square++)
+		{
+			if (OffsetA1H8(square) < 0)
+				s_MapB1H1H7[square] = code++;
+		}
+
+		// b1-d1-d3 triangle first, diagonal squares last
+		std::vector<int> diagonal;
+		code = 0;
+		for (int square = 0; square <= d4; square++)
+		{
+			if (OffsetA1H8(square) < 0 && (square & 7) <= FILE_D)
+				s_MapA1D1D4[square] = code++;
+			else if (!OffsetA1H8(square) && (square & 7) <= FILE_D)
+				diagonal.push_back(square);
+		}
+		for (int square : diagonal)
+			s_MapA1D1D4[square] = code++;
+
+		// The 462 legal placements of two kings with the first in the a1-d1-d4 triangle.
+		// If the first king is on the diagonal the second is not above it.
+		std::vector<std::pair<int, int>> bothOnDiagonal;
+		code = 0;
+		for (int index = 0; index < 10; index++)
+		{
+			for (int square1 = 0; square1 <= d4; square1++)
+			{
+				if (s_MapA1D1D4[square1] != index || (!index && square1 != b1))
+					continue;
+				for (int square2 = 0; square2 < SQUARE_MAX; square2++)
+				{
+					if (std::max(std::abs((square1 & 7) - (square2 & 7)), std::abs((square1 >> 3) - (square2 >> 3))) <= 1)
+						continue;
+					if (!OffsetA1H8(square1) && OffsetA1H8(square2) > 0)
+						continue;
+					if (!OffsetA1H8(square1) && !OffsetA1H8(square2))
+						bothOnDiagonal.emplace_back(index, square2);
+					else
+						s_MapKK[index][square2] = code++;
+				}
+			}
+		}
+		for (const auto& pair : bothOnDiagonal)
+			s_MapKK[pair.first][pair.second] = code++;
+
+		s_Binomial[0][0] = 1;
+		for (int n = 1; n < SQUARE_MAX; n++)
+		{
+			for (int k = 0; k < TB_MAX_PIECES - 1 && k <= n; k++)
+				s_Binomial[k][n] = (k > 0 ? s_Binomial[k - 1][n - 1] : 0) + (k < n ? s_Binomial[k][n - 1] : 0);
+		}
+
+		// The pawn with the highest MapPawns value leads: the one nearest the edge and with the lowest rank
+		int availableSquares = 47;
+		for (int leadPawnCount = 1; leadPawnCount < TB_MAX_PIECES - 1; leadPawnCount++)
+		{
+			for (int file = FILE_A; file <= FILE_D; file++)
+			{
+				uint64_t index = 0;
+				for (int rank = RANK_2; rank <= RANK_7; rank++)
+				{
+					int square = 8 * rank + file;
+					if (leadPawnCount == 1)
+					{
+						s_MapPawns[square] = availableSquares--;
+						s_MapPawns[FlipFileSquare(square)] = availableSquares--;
+					}
+					s_LeadPawnIndex[leadPawnCount][square] = index;
+					index += s_Binomial[leadPawnCount - 1][s_MapPawns[square]];
+				}
+				s_LeadPawnsSize[leadPawnCount][file] = index;
+			}
+		}
+	}
+
+	// =================================================================================================================================
+	// FILE MAPPING
+	// =================================================================================================================================
+
+	static std::string FindFile(const std::string& filename)
+	{
+		for (const std::string& path : s_Paths)
+		{
+			std::string fullPath = path + "/" + filename;
+			std::ifstream file(fullPath, std::ios::binary);
+			if (file.is_open())
+				return fullPath;
+		}
+		return "";
+	}
+
+	static void UnmapFile(FileMapping& mapping)
+	{
+		if (!mapping.BaseAddress)
+			return;
+#if defined(EMSCRIPTEN)
+		std::free(mapping.BaseAddress);
+#elif defined(BOX_PLATFORM_WINDOWS)
+		UnmapViewOfFile(mapping.BaseAddress);
+		CloseHandle(mapping.Handle);
+#else
+		munmap(mapping.BaseAddress, mapping.Size);
+#endif
+		mapping = FileMapping();
+	}
+
+	// Returns the data following the magic bytes or nullptr if the file is missing or corrupted
+	static uint8_t* MapFile(const std::string& filename, TablebaseType type, FileMapping& mapping)
+	{
+		std::string path = FindFile(filename);
+		if (path.empty())
+			return nullptr;
+
+#if defined(EMSCRIPTEN)
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		size_t size = (size_t)file.tellg();
+		// The format aligns data relative to the start of the file
+		void* memory = std::aligned_alloc(64, (size + 63) / 64 * 64);
+		if (!memory)
+			return nullptr;
+		file.seekg(0);
+		file.read((char*)memory, size);
+		mapping.BaseAddress = (uint8_t*)memory;
+		mapping.Size = size;
+#elif defined(BOX_PLATFORM_WINDOWS)
+		HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (handle == INVALID_HANDLE_VALUE)
+			return nullptr;
+		DWORD sizeHigh;
+		DWORD sizeLow = GetFileSize(handle, &sizeHigh);
+		HANDLE mapHandle = CreateFileMapping(handle, nullptr, PAGE_READONLY, sizeHigh, sizeLow, nullptr);
+		CloseHandle(handle);
+		if (!mapHandle)
+			return nullptr;
+		void* memory = MapViewOfFile(mapHandle, FILE_MAP_READ, 0, 0, 0);
+		if (!memory)
+		{
+			CloseHandle(mapHandle);
+			return nullptr;
+		}
+		mapping.BaseAddress = (uint8_t*)memory;
+		mapping.Size = ((size_t)sizeHigh << 32) | sizeLow;
+		mapping.Handle = mapHandle;
+#else
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd == -1)
+			return nullptr;
+		struct stat info;
+		if (fstat(fd, &info) != 0 || info.st_size == 0)
+		{
+			close(fd);
+			return nullptr;
+		}
+		void* memory = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		close(fd);
+		if (memory == MAP_FAILED)
+			return nullptr;
+#ifdef MADV_RANDOM
+		madvise(memory, info.st_size, MADV_RANDOM);
+#endif
+		mapping.BaseAddress = (uint8_t*)memory;
+		mapping.Size = info.st_size;
+#endif
+
+		// Every table ends with a 16 byte checksum after 64 byte aligned data
+		const uint8_t* magic = (type == TB_WDL) ? WDL_MAGIC : DTZ_MAGIC;
+		if (mapping.Size % 64 != 16 || std::memcmp(mapping.BaseAddress, magic, 4) != 0)
+		{
+			BOX_WARN("Corrupted tablebase file {}", path);
+			UnmapFile(mapping);
+			return nullptr;
+		}
+		return mapping.BaseAddress + 4;
+	}
+
+	// =================================================================================================================================
+	// TABLE PARSING
+	// =================================================================================================================================
+
+	TablebaseTable::TablebaseTable(TablebaseType type, const std::string& name)
+		: Type(type), Name(name), Key(0), Key2(0), PieceCount(0), HasPawns(false), HasUniquePieces(false), PawnCount(), Ready(false), Mapping(), Map(nullptr), Items()
+	{
+		std::string signature = name;
+		signature.erase(signature.find('v'), 1);
+		Key = CreateMaterialKey(signature, TEAM_WHITE);
+		Key2 = CreateMaterialKey(signature, TEAM_BLACK);
+
+		// Count pieces for the stronger side (white) and the weaker side (black)
+		int counts[TEAM_MAX][PIECE_MAX] = {};
+		Team team = TEAM_BLACK;
+		for (char c : signature)
+		{
+			if (c == 'K')
+				team = OtherTeam(team);
+			const char* pieces = "PNBRQK";
+			counts[team][std::strchr(pieces, c) - pieces]++;
+			PieceCount++;
+		}
+
+		HasPawns = counts[TEAM_WHITE][PIECE_PAWN] || counts[TEAM_BLACK][PIECE_PAWN];
+		for (Team t : { TEAM_WHITE, TEAM_BLACK })
+		{
+			for (Piece piece = PIECE_PAWN; piece < PIECE_KING; piece++)
+			{
+				if (counts[t][piece] == 1)
+					HasUniquePieces = true;
+			}
+		}
+
+		// The team with fewer pawns leads because that compresses better
+		int whitePawns = counts[TEAM_WHITE][PIECE_PAWN];
+		int blackPawns = counts[TEAM_BLACK][PIECE_PAWN];
+		bool whiteLeads = !blackPawns || (whitePawns && blackPawns >= whitePawns);
+		PawnCount[0] = whiteLeads ? whitePawns : blackPawns;
+		PawnCount[1] = whiteLeads ? blackPawns : whitePawns;
+	}
+
+	// Number of values represented by a symbol minus one
+	static int SetSymbolLength(PairsData* data, Symbol symbol, std::vector<bool>& visited)
+	{
+		visited[symbol] = true;
+		Symbol right = data->Tree[symbol].GetRight();
+		if (right == 0xFFF)
+			return 0;
+		Symbol left = data->Tree[symbol].GetLeft();
+		if (!visited[left])
+			data->SymbolLengths[left] = SetSymbolLength(data, left, visited);
+		if (!visited[right])
+			data->SymbolLengths[right] = SetSymbolLength(data, right, visited);
+		return data->SymbolLengths[left] + data->SymbolLengths[right] + 1;
+	}
+
+	static const uint8_t* SetSizes(PairsData* data, const uint8_t* ptr)
+	{
+		data->Flags = *ptr++;
+		if (data->Flags & TB_FLAG_SINGLE_VALUE)
+		{
+			data->BlockCount = 0;
+			data->Span = 0;
+			data->BlockLengthCount = 0;
+			data->SparseIndexSize = 0;
+			// The single value is stored in place of the symbol length
+			data->MinSymbolLength = *ptr++;
+			return ptr;
+		}
+
+		// The group index after the last group is the size of the table
+		uint64_t tableSize = data->GroupIndex[std::find(data->GroupLength, data->GroupLength + TB_MAX_PIECES, 0) - data->GroupLength];
+
+		data->BlockSize = 1ULL << *ptr++;
+		data->Span = 1ULL << *ptr++;
+		data->SparseIndexSize = (size_t)((tableSize + data->Span - 1) / data->Span);
+		int padding = *ptr++;
+		data->BlockCount = ReadLittleEndian<uint32_t>(ptr);
+		ptr += sizeof(uint32_t);
+		// Padded so the sparse index never points past the end
+		data->BlockLengthCount = data->BlockCount + padding;
+		data->MaxSymbolLength = *ptr++;
+		data->MinSymbolLength = *ptr++;
+		data->LowestSymbols = ptr;
+		data->Base64.resize(data->MaxSymbolLength - data->MinSymbolLength + 1);
+
+		// Longer canonical codes have lower values, so Base64 is decreasing
+		for (int i = (int)data->Base64.size() - 2; i >= 0; i--)
+		{
+			data->Base64[i] = (data->Base64[i + 1] + ReadLittleEndian<Symbol>(data->LowestSymbols + i * sizeof(Symbol))
+				- ReadLittleEndian<Symbol>(data->LowestSymbols + (i + 1) * sizeof(Symbol))) / 2;
+		}
+		for (size_t i = 0; i < data->Base64.size(); i++)
+			data->Base64[i] <<= 64 - i - data->MinSymbolLength;
+
+		ptr += data->Base64.size() * sizeof(Symbol);
+		data->SymbolLengths.resize(ReadLittleEndian<uint16_t>(ptr));
+		ptr += sizeof(uint16_t);
+		data->Tree = (const SymbolPair*)ptr;
+
+		std::vector<bool> visited(data->SymbolLengths.size());
+		for (Symbol symbol = 0; symbol < data->SymbolLengths.size(); symbol++)
+		{
+			if (!visited[symbol])
+				data->SymbolLengths[symbol] = SetSymbolLength(data, symbol, visited);
+		}
+		return ptr + data->SymbolLengths.size() * sizeof(SymbolPair) + (data->SymbolLengths.size() & 1);
+	}
+
+	static const uint8_t* SetDTZMap(TablebaseTable& table, const uint8_t* ptr, int maxFile)
+	{
+		if (table.Type != TB_DTZ)
+			return ptr;
+
+		table.Map = ptr;
+		for (int file = FILE_A; file <= maxFile; file++)
+		{
+			PairsData* data = table.Get(0, file);
+			if (!(data->Flags & TB_FLAG_MAPPED))
+				continue;
+			if (data->Flags & TB_FLAG_WIDE)
+			{
+				ptr += (uintptr_t)ptr & 1;
+				for (int i = 0; i < 4; i++)
+				{
+					data->MapIndex[i] = (uint16_t)((ptr - table.Map) / 2 + 1);
+					ptr += 2 * ReadLittleEndian<uint16_t>(ptr) + 2;
+				}
+			}
+			else
+			{
+				for (int i = 0; i < 4; i++)
+				{
+					data->MapIndex[i] = (uint16_t)(ptr - table.Map + 1);
+					ptr += *ptr + 1;
+				}
+			}
+		}
+		return ptr + ((uintptr_t)ptr & 1);
+	}
+
+	// Pieces in a group are encoded together, the groups are combined in the order stored in the file
+	static void SetGroups(const TablebaseTable& table, PairsData* data, const int order[2], int file)
+	{
+		int n = 0;
+		int firstLength = table.HasPawns ? 0 : table.HasUniquePieces ? 3 : 2;
+		data->GroupLength[n] = 1;
+		for (int i = 1; i < table.PieceCount; i++)
+		{
+			if (--firstLength > 0 || data->Pieces[i] == data->Pieces[i - 1])
+				data->GroupLength[n]++;
+			else
+				data->GroupLength[++n] = 1;
+		}
+		data->GroupLength[++n] = 0;
+
+		const bool pawnsOnBothSides = table.HasPawns && table.PawnCount[1];
+		int next = pawnsOnBothSides ? 2 : 1;
+		int freeSquares = SQUARE_MAX - data->GroupLength[0] - (pawnsOnBothSides ? data->GroupLength[1] : 0);
+		uint64_t index = 1;
+
+		for (int k = 0; next < n || k == order[0] || k == order[1]; k++)
+		{
+			if (k == order[0])
+			{
+				// Leading pawns or pieces
+				data->GroupIndex[0] = index;
+				index *= table.HasPawns ? s_LeadPawnsSize[data->GroupLength[0]][file] : table.HasUniquePieces ? 31332 : 462;
+			}
+			else if (k == order[1])
+			{
+				// Remaining pawns
+				data->GroupIndex[1] = index;
+				index *= s_Binomial[data->GroupLength[1]][48 - data->GroupLength[0]];
+			}
+			else
+			{
+				data->GroupIndex[next] = index;
+				index *= s_Binomial[data->GroupLength[next]][freeSquares];
+				freeSquares -= data->GroupLength[next++];
+			}
+		}
+		data->GroupIndex[n] = index;
+	}
+
+	static void SetupTable(TablebaseTable& table, const uint8_t* ptr)
+	{
+		enum { Split = 1, HasPawns = 2 };
+		BOX_ASSERT(table.HasPawns == !!(*ptr & HasPawns), "Tablebase pawn flag mismatch");
+		BOX_ASSERT((table.Key != table.Key2) == !!(*ptr & Split), "Tablebase split flag mismatch");
+		ptr++;
+
+		const int sides = table.GetSides();
+		const int maxFile = table.HasPawns ? FILE_D : FILE_A;
+		const bool pawnsOnBothSides = table.HasPawns && table.PawnCount[1];
+
+		for (int file = FILE_A; file <= maxFile; file++)
+		{
+			for (int i = 0; i < sides; i++)
+				*table.Get(i, file) = PairsData();
+
+			int order[2][2] = {
+				{ *ptr & 0xF, pawnsOnBothSides ? *(ptr + 1) & 0xF : 0xF },
+				{ *ptr >> 4, pawnsOnBothSides ? *(ptr + 1) >> 4 : 0xF }
+			};
+			ptr += 1 + pawnsOnBothSides;
+
+			for (int k = 0; k < table.PieceCount; k++, ptr++)
+			{
+				for (int i = 0; i < sides; i++)
+					table.Get(i, file)->Pieces[k] = i ? (*ptr >> 4) : (*ptr & 0xF);
+			}
+
+			for (int i = 0; i < sides; i++)
+				SetGroups(table, table.Get(i, file), order[i], file);
+		}
+
+		ptr += (uintptr_t)ptr & 1;
+
+		for (int file = FILE_A; file <= maxFile; file++)
+		{
+			for (int i = 0; i < sides; i++)
+				ptr = SetSizes(table.Get(i, file), ptr);
+		}
+
+		ptr = SetDTZMap(table, ptr, maxFile);
+
+		for (int file = FILE_A; file <= maxFile; file++)
+		{
+			for (int i = 0; i < sides; i++)
+			{
+				PairsData* data = table.Get(i, file);
+				data->SparseIndex = (const SparseEntry*)ptr;
+				ptr += data->SparseIndexSize * sizeof(SparseEntry);
+			}
+		}
+
+		for (int file = FILE_A; file <= maxFile; file++)
+		{
+			for (int i = 0; i < sides; i++)
+			{
+				PairsData* data = table.Get(i, file);
+				data->BlockLengths = ptr;
+				ptr += data->BlockLengthCount * sizeof(uint16_t);
+			}
+		}
+
+		for (int file = FILE_A; file <= maxFile; file++)
+		{
+			for (int i = 0; i < sides; i++)
+			{
+				ptr = (const uint8_t*)(((uintptr_t)ptr + 0x3F) & ~(uintptr_t)0x3F);
+				PairsData* data = table.Get(i, file);
+				data->Data = ptr;
+				ptr += data->BlockCount * data->BlockSize;
+			}
+		}
+	}
+
+	// Maps the file the first time the table is probed, false if it is missing
+	static bool EnsureMapped(TablebaseTable& table)
+	{
+		if (table.Ready.load(std::memory_order_acquire))
+			return table.Mapping.BaseAddress != nullptr;
+
+		std::lock_guard<std::mutex> lock(s_MappingMutex);
+		if (table.Ready.load(std::memory_order_relaxed))
+			return table.Mapping.BaseAddress != nullptr;
+
+		const uint8_t* data = MapFile(table.Name + (table.Type == TB_WDL ? ".rtbw" : ".rtbz"), table.Type, table.Mapping);
+		if (data)
+			SetupTable(table, data);
+		table.Ready.store(true, std::memory_order_release);
+		return data != nullptr;
+	}
+
+	// =================================================================================================================================
+	// DECODING
+	// =================================================================================================================================
+
+	static int DecompressPairs(const PairsData* data, uint64_t index)
+	{
+		if (data->Flags & TB_FLAG_SINGLE_VALUE)
+			return data->MinSymbolLength;
+
+		// The sparse index entry k points to the value with index k * Span + Span / 2,
+		// walk the block lengths from there to find the block that stores index
+		uint32_t k = (uint32_t)(index / data->Span);
+		uint32_t block = ReadLittleEndian<uint32_t>(data->SparseIndex[k].Block);
+		int offset = ReadLittleEndian<uint16_t>(data->SparseIndex[k].Offset);
+		offset += (int)(index % data->Span) - (int)(data->Span / 2);
+
+		while (offset < 0)
+			offset += ReadLittleEndian<uint16_t>(data->BlockLengths + sizeof(uint16_t) * --block) + 1;
+		while (offset > ReadLittleEndian<uint16_t>(data->BlockLengths + sizeof(uint16_t) * block))
+			offset -= ReadLittleEndian<uint16_t>(data->BlockLengths + sizeof(uint16_t) * block++) + 1;
+
+		const uint8_t* ptr = data->Data + (uint64_t)block * data->BlockSize;
+		uint64_t buffer = ReadBigEndian<uint64_t>(ptr);
+		ptr += sizeof(uint64_t);
+		int bufferSize = 64;
+		Symbol symbol;
+
+		// Skip symbols until the one that expands to the value at offset
+		while (true)
+		{
+			int length = 0;
+			while (buffer < data->Base64[length])
+				length++;
+			symbol = (Symbol)((buffer - data->Base64[length]) >> (64 - length - data->MinSymbolLength));
+			symbol += ReadLittleEndian<Symbol>(data->LowestSymbols + length * sizeof(Symbol));
+
+			if (offset < data->SymbolLengths[symbol] + 1)
+				break;
+
+			offset -= data->SymbolLengths[symbol] + 1;
+			length += data->MinSymbolLength;
+			buffer <<= length;
+			bufferSize -= length;
+			if (bufferSize <= 32)
+			{
+				bufferSize += 32;
+				buffer |= (uint64_t)ReadBigEndian<uint32_t>(ptr) << (64 - bufferSize);
+				ptr += sizeof(uint32_t);
+			}
+		}
+
+		// Expand pairs until reaching the leaf that stores the value
+		while (data->SymbolLengths[symbol])
+		{
+			Symbol left = data->Tree[symbol].GetLeft();
+			if (offset < data->SymbolLengths[left] + 1)
+			{
+				symbol = left;
+			}
+			else
+			{
+				offset -= data->SymbolLengths[left] + 1;
+				symbol = data->Tree[symbol].GetRight();
+			}
+		}
+		return data->Tree[symbol].GetLeft();
+	}
+
+	static int MapScore(TablebaseTable& table, int file, int value, WDLScore wdl)
+	{
+		if (table.Type == TB_WDL)
+			return value - 2;
+
+		constexpr int WDLMap[] = { 1, 3, 0, 2, 0 };
+		const PairsData* data = table.Get(0, file);
+		if (data->Flags & TB_FLAG_MAPPED)
+		{
+			int index = data->MapIndex[WDLMap[wdl + 2]] + value;
+			if (data->Flags & TB_FLAG_WIDE)
+				value = ReadLittleEndian<uint16_t>(table.Map + sizeof(uint16_t) * index);
+			else
+				value = table.Map[index];
+		}
+
+		// Stored in moves unless the flags say plies
+		if ((wdl == WDL_WIN && !(data->Flags & TB_FLAG_WIN_PLIES)) || (wdl == WDL_LOSS && !(data->Flags & TB_FLAG_LOSS_PLIES)) ||
+			wdl == WDL_CURSED_WIN || wdl == WDL_BLESSED_LOSS)
+			value *= 2;
+		return value + 1;
+	}
+
+	static int ProbeTable(const Position& position, TablebaseTable& table, WDLScore wdl, ProbeState* result)
+	{
+		int squares[TB_MAX_PIECES];
+		int pieces[TB_MAX_PIECES];
+		int size = 0;
+		int leadPawnCount = 0;
+		BitBoard leadPawns = ZERO_BB;
+		int tableFile = FILE_A;
+
+		// Symmetric tables only store white to play and tables are stored with white as the stronger side,
+		// so flip the colours and board if needed
+		const bool symmetricBlackToPlay = table.Key == table.Key2 && position.TeamToPlay == TEAM_BLACK;
+		const bool blackStronger = position.GetMaterialKey() != table.Key;
+		const bool flip = symmetricBlackToPlay || blackStronger;
+		const int flipColor = flip * 8;
+		const int flipSquares = flip * 56;
+		const int teamToPlay = flip ^ (int)position.TeamToPlay;
+
+		if (table.HasPawns)
+		{
+			// Pawns come first in every piece sequence
+			const int pawnCode = table.Get(0, 0)->Pieces[0] ^ flipColor;
+			BitBoard pawns = position.GetTeamPieces((Team)(pawnCode >> 3), PIECE_PAWN);
+			leadPawns = pawns;
+			while (pawns)
+				squares[size++] = (int)PopLeastSignificantBit(pawns) ^ flipSquares;
+			leadPawnCount = size;
+			std::swap(squares[0], *std::max_element(squares, squares + leadPawnCount, ComparePawns));
+			tableFile = std::min(squares[0] & 7, FILE_H - (squares[0] & 7));
+		}
+
+		if (table.Type == TB_DTZ)
+		{
+			const PairsData* data = table.Get(teamToPlay, tableFile);
+			if ((data->Flags & TB_FLAG_STM) != teamToPlay && !(table.Key == table.Key2 && !table.HasPawns))
+			{
+				*result = PROBE_CHANGE_TEAM;
+				return 0;
+			}
+		}
+
+		BitBoard remaining = position.GetAllPieces() ^ leadPawns;
+		while (remaining)
+		{
+			SquareIndex square = PopLeastSignificantBit(remaining);
+			squares[size] = (int)square ^ flipSquares;
+			pieces[size++] = GetPieceCode(position.GetTeamAt(square), position.GetPieceOnSquare(square)) ^ flipColor;
+		}
+
+		PairsData* data = table.Get(teamToPlay, tableFile);
+
+		// Reorder the pieces to match the sequence stored in the table
+		for (int i = leadPawnCount; i < size - 1; i++)
+		{
+			for (int j = i + 1; j < size; j++)
+			{
+				if (data->Pieces[i] == pieces[j])
+				{
+					std::swap(pieces[i], pieces[j]);
+					std::swap(squares[i], squares[j]);
+					break;
+				}
+			}
+		}
+
+		// Keep the lead piece on files A-D
+		if ((squares[0] & 7) > FILE_D)
+		{
+			for (int i = 0; i < size; i++)
+				squares[i] = FlipFileSquare(squares[i]);
+		}
+
+		uint64_t index;
+		if (table.HasPawns)
+		{
+			index = s_LeadPawnIndex[leadPawnCount][squares[0]];
+			std::stable_sort(squares + 1, squares + leadPawnCount, ComparePawns);
+			for (int i = 1; i < leadPawnCount; i++)
+				index += s_Binomial[i][s_MapPawns[squares[i]]];
+		}
+		else
+		{
+			// Keep the lead piece below rank 5
+			if ((squares[0] >> 3) > RANK_4)
+			{
+				for (int i = 0; i < size; i++)
+					squares[i] = FlipRankSquare(squares[i]);
+			}
+
+			// The first piece of the leading group off the a1-h8 diagonal must be below it
+			for (int i = 0; i < data->GroupLength[0]; i++)
+			{
+				if (!OffsetA1H8(squares[i]))
+					continue;
+				if (OffsetA1H8(squares[i]) > 0)
+				{
+					for (int j = i; j < size; j++)
+						squares[j] = ((squares[j] >> 3) | (squares[j] << 3)) & 63;
+				}
+				break;
+			}
+
+			if (table.HasUniquePieces)
+			{
+				// The three leading pieces are encoded together
+				int adjust1 = squares[1] > squares[0];
+				int adjust2 = (squares[2] > squares[0]) + (squares[2] > squares[1]);
+
+				if (OffsetA1H8(squares[0]))
+					index = (s_MapA1D1D4[squares[0]] * 63 + (squares[1] - adjust1)) * 62 + squares[2] - adjust2;
+				else if (OffsetA1H8(squares[1]))
+					index = (6 * 63 + (squares[0] >> 3) * 28 + s_MapB1H1H7[squares[1]]) * 62 + squares[2] - adjust2;
+				else if (OffsetA1H8(squares[2]))
+					index = 6 * 63 * 62 + 4 * 28 * 62 + (squares[0] >> 3) * 7 * 28 + ((squares[1] >> 3) - adjust1) * 28 + s_MapB1H1H7[squares[2]];
+				else
+					index = 6 * 63 * 62 + 4 * 28 * 62 + 4 * 7 * 28 + (squares[0] >> 3) * 7 * 6 + ((squares[1] >> 3) - adjust1) * 6 + ((squares[2] >> 3) - adjust2);
+			}
+			else
+			{
+				index = s_MapKK[s_MapA1D1D4[squares[0]]][squares[1]];
+			}
+		}
+
+		// Remaining groups in ascending square order, skipping squares taken by earlier groups
+		index *= data->GroupIndex[0];
+		int* groupSquares = squares + data->GroupLength[0];
+		bool remainingPawns = table.HasPawns && table.PawnCount[1];
+		int next = 0;
+		while (data->GroupLength[++next])
+		{
+			std::stable_sort(groupSquares, groupSquares + data->GroupLength[next]);
+			uint64_t n = 0;
+			for (int i = 0; i < data->GroupLength[next]; i++)
+			{
+				int adjust = (int)std::count_if(squares, groupSquares, [&](int square) { return groupSquares[i] > square; });
+				n += s_Binomial[i + 1][groupSquares[i] - adjust - 8 * remainingPawns];
+			}
+			remainingPawns = false;
+			index += n * data->GroupIndex[next];
+			groupSquares += data->GroupLength[next];
+		}
+
+		return MapScore(table, tableFile, DecompressPairs(data, index), wdl);
+	}
+
+	static int ProbeTable(const Position& position, TablebaseType type, ProbeState* result, WDLScore wdl = WDL_DRAW)
+	{
+		// King vs king
+		if (position.GetAllPieces().GetCount() == 2)
+			return WDL_DRAW;
+
+		auto it = s_TableMap.find(position.GetMaterialKey());
+		TablebaseTable* table = (it == s_TableMap.end()) ? nullptr : (type == TB_WDL ? it->second.first : it->second.second);
+		if (!table || !EnsureMapped(*table))
+		{
+			*result = PROBE_FAIL;
+			return 0;
+		}
+		return ProbeTable(position, *table, wdl, result);
+	}
+
+	// =================================================================================================================================
+	// PROBING
+	// =================================================================================================================================
+
+	// Tables are not valid for positions with en passant rights or where a capture is the only good move,
+	// so resolve captures (and pawn moves for DTZ) by search before probing
+	template<bool CheckZeroingMoves>
+	static WDLScore SearchTablebase(Position& position, ProbeState* result)
+	{
+		WDLScore bestValue = WDL_LOSS;
+		WDLScore value;
+
+		Move moves[MAX_MOVES];
+		MoveList list(nullptr, moves);
+		MoveGenerator generator(position);
+		generator.GetLegalMoves(list);
+
+		int moveCount = 0;
+		for (int i = 0; i < list.MoveCount; i++)
+		{
+			const Move move = list.Moves[i];
+			if (!move.IsCapture() && (!CheckZeroingMoves || move.GetMovingPiece() != PIECE_PAWN))
+				continue;
+
+			moveCount++;
+			UndoInfo undo;
+			ApplyMove(position, move, &undo);
+			value = (WDLScore)-SearchTablebase<false>(position, result);
+			UndoMove(position, move, undo);
+
+			if (*result == PROBE_FAIL)
+				return WDL_DRAW;
+
+			if (value > bestValue)
+			{
+				bestValue = value;
+				if (value >= WDL_WIN)
+				{
+					*result = PROBE_ZEROING_BEST_MOVE;
+					return value;
+				}
+			}
+		}
+
+		// If every legal move was searched the table value is not needed (and may be wrong)
+		const bool noMoreMoves = moveCount && moveCount == list.MoveCount;
+		if (noMoreMoves)
+		{
+			value = bestValue;
+		}
+		else
+		{
+			value = (WDLScore)ProbeTable(position, TB_WDL, result);
+			if (*result == PROBE_FAIL)
+				return WDL_DRAW;
+		}
+
+		// DTZ stores a "don't care" value if the best capture is at least as good
+		if (bestValue >= value)
+		{
+			*result = (bestValue > WDL_DRAW || noMoreMoves) ? PROBE_ZEROING_BEST_MOVE : PROBE_OK;
+			return bestValue;
+		}
+		*result = PROBE_OK;
+		return value;
+	}
+
+	// DTZ of the position before a zeroing move with the given outcome
+	inline int GetDTZBeforeZeroing(WDLScore wdl)
+	{
+		return wdl == WDL_WIN ? 1 :
+			wdl == WDL_CURSED_WIN ? 101 :
+			wdl == WDL_BLESSED_LOSS ? -101 :
+			wdl == WDL_LOSS ? -1 : 0;
+	}
+
+	inline int Sign(int value)
+	{
+		return (value > 0) - (value < 0);
+	}
+
+	static void RegisterTable(const std::string& name)
+	{
+		if (FindFile(name + ".rtbw").empty())
+			return;
+
+		s_Tables.emplace_back(TB_WDL, name);
+		TablebaseTable* wdl = &s_Tables.back();
+		if (s_TableMap.find(wdl->Key) != s_TableMap.end())
+		{
+			s_Tables.pop_back();
+			return;
+		}
+		s_Tables.emplace_back(TB_DTZ, name);
+		TablebaseTable* dtz = &s_Tables.back();
+
+		s_TableMap[wdl->Key] = { wdl, dtz };
+		s_TableMap[wdl->Key2] = { wdl, dtz };
+		s_Cardinality = std::max(s_Cardinality, wdl->PieceCount);
+	}
+
+	// Every multiset of non-king pieces in file name order (QRBNP)
+	static void EnumeratePieceSets(std::vector<std::string>& result, std::string current, int maxPieces, int firstPiece)
+	{
+		static constexpr char PIECES[] = "QRBNP";
+		result.push_back(current);
+		if ((int)current.size() == maxPieces)
+			return;
+		for (int i = firstPiece; i < 5; i++)
+			EnumeratePieceSets(result, current + PIECES[i], maxPieces, i);
+	}
+
+	int InitTablebases(const std::string& paths)
+	{
+		static bool s_EncodingInitialized = false;
+		if (!s_EncodingInitialized)
+		{
+			InitEncoding();
+			s_EncodingInitialized = true;
+		}
+
+		for (TablebaseTable& table : s_Tables)
+			UnmapFile(table.Mapping);
+		s_Tables.clear();
+		s_TableMap.clear();
+		s_Paths.clear();
+		s_Cardinality = 0;
+
+		if (paths.empty() || paths == "<empty>")
+			return 0;
+
+#if defined(BOX_PLATFORM_WINDOWS) && !defined(EMSCRIPTEN)
+		constexpr char SEPARATOR = ';';
+#else
+		constexpr char SEPARATOR = ':';
+#endif
+		size_t start = 0;
+		while (start <= paths.size())
+		{
+			size_t end = paths.find(SEPARATOR, start);
+			if (end == std::string::npos)
+				end = paths.size();
+			if (end > start)
+				s_Paths.push_back(paths.substr(start, end - start));
+			start = end + 1;
+		}
+
+		// Try both orders of every pair of piece sets, the files are named with the stronger side first
+		std::vector<std::string> pieceSets;
+		EnumeratePieceSets(pieceSets, "", TB_MAX_PIECES - 2, 0);
+		for (const std::string& strong : pieceSets)
+		{
+			for (const std::string& weak : pieceSets)
+			{
+				if (!strong.empty() && strong.size() + weak.size() <= TB_MAX_PIECES - 2)
+					RegisterTable("K" + strong + "vK" + weak);
+			}
+		}
+
+		int count = (int)s_Tables.size() / 2;
+		if (count > 0)
+			BOX_INFO("Found {} tablebases", count);
+		return count;
+	}
+
+	int GetTablebaseCardinality()
+	{
+		return s_Cardinality;
+	}
+
+	WDLScore ProbeWDL(Position& position, ProbeState* result)
+	{
+		*result = PROBE_OK;
+		return SearchTablebase<false>(position, result);
+	}
+
+	int ProbeDTZ(Position& position, ProbeState* result)
+	{
+		*result = PROBE_OK;
+		const WDLScore wdl = SearchTablebase<true>(position, result);
+
+		// Draws are not stored
+		if (*result == PROBE_FAIL || wdl == WDL_DRAW)
+			return 0;
+
+		// The stored value is not valid when a zeroing move is best
+		if (*result == PROBE_ZEROING_BEST_MOVE)
+			return GetDTZBeforeZeroing(wdl);
+
+		int dtz = ProbeTable(position, TB_DTZ, result, wdl);
+		if (*result == PROBE_FAIL)
+			return 0;
+
+		if (*result != PROBE_CHANGE_TEAM)
+			return (dtz + 100 * (wdl == WDL_BLESSED_LOSS || wdl == WDL_CURSED_WIN)) * Sign(wdl);
+
+		// The table stores the other team to play, find the move with the best DTZ with a 1 ply search
+		int minDTZ = 0xFFFF;
+
+		Move moves[MAX_MOVES];
+		MoveList list(nullptr, moves);
+		MoveGenerator generator(position);
+		generator.GetLegalMoves(list);
+
+		for (int i = 0; i < list.MoveCount; i++)
+		{
+			const Move move = list.Moves[i];
+			const bool zeroing = IsZeroingMove(move);
+
+			UndoInfo undo;
+			ApplyMove(position, move, &undo);
+
+			// For zeroing moves the DTZ before the move is needed, otherwise the DTZ of the following sequence
+			dtz = zeroing ? -GetDTZBeforeZeroing(SearchTablebase<false>(position, result)) : -ProbeDTZ(position, result);
+
+			// Mating moves have DTZ 1
+			if (dtz == 1 && position.InCheck() && GetLegalMoveCount(position) == 0)
+				minDTZ = 1;
+
+			if (!zeroing)
+				dtz += Sign(dtz);
+
+			// Only consider moves that keep the result
+			if (dtz < minDTZ && Sign(dtz) == Sign(wdl))
+				minDTZ = dtz;
+
+			UndoMove(position, move, undo);
+
+			if (*result == PROBE_FAIL)
+				return 0;
+		}
+
+		// No legal moves means mate
+		return minDTZ == 0xFFFF ? -1 : minDTZ;
+	}
+
+	static bool RankRootMovesDTZ(Position& position, const Move* moves, int count, int* ranks)
+	{
+		ProbeState result = PROBE_OK;
+		const int rule50 = position.HalfTurnsSinceCaptureOrPush;
+
+		for (int i = 0; i < count && result != PROBE_FAIL; i++)
+		{
+			UndoInfo undo;
+			ApplyMove(position, moves[i], &undo);
+
+			int dtz;
+			if (position.HalfTurnsSinceCaptureOrPush == 0)
+			{
+				// Zeroing move
+				dtz = GetDTZBeforeZeroing((WDLScore)-ProbeWDL(position, &result));
+			}
+			else
+			{
+				dtz = -ProbeDTZ(position, &result);
+				dtz = dtz > 0 ? dtz + 1 : dtz < 0 ? dtz - 1 : dtz;
+			}
+
+			if (dtz == 2 && position.InCheck() && GetLegalMoveCount(position) == 0)
+				dtz = 1;
+
+			UndoMove(position, moves[i], undo);
+
+			// Certain wins rank equally, as do losses unless the 50 move rule could save them
+			ranks[i] =
+				dtz > 0 ? (dtz + rule50 <= 99 ? MAX_DTZ : MAX_DTZ - (dtz + rule50)) :
+				dtz < 0 ? (-dtz * 2 + rule50 < 100 ? -MAX_DTZ : -MAX_DTZ + (-dtz + rule50)) :
+				0;
+		}
+		return result != PROBE_FAIL;
+	}
+
+	static bool RankRootMovesWDL(Position& position, const Move* moves, int count, int* ranks)
+	{
+		static constexpr int WDLToRank[] = { -MAX_DTZ, -MAX_DTZ + 101, 0, MAX_DTZ - 101, MAX_DTZ };
+		ProbeState result = PROBE_OK;
+
+		for (int i = 0; i < count && result != PROBE_FAIL; i++)
+		{
+			UndoInfo undo;
+			ApplyMove(position, moves[i], &undo);
+			WDLScore wdl = (WDLScore)-ProbeWDL(position, &result);
+			UndoMove(position, moves[i], undo);
+			ranks[i] = WDLToRank[wdl + 2];
+		}
+		return result != PROBE_FAIL;
+	}
+
+	bool RankRootMoves(Position& position, const Move* moves, int count, int* ranks)
+	{
+		if (HasCastlingRights(position) || position.GetAllPieces().GetCount() > s_Cardinality)
+			return false;
+		return RankRootMovesDTZ(position, moves, count, ranks) || RankRootMovesWDL(position, moves, count, ranks);
+	}
+
+}
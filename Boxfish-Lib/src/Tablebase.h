@@ -0,0 +1,62 @@
+#pragma once
+#include "Position.h"
+#include "Move.h"
+#include <string>
+
+#ifdef SWIG
+#define BOX_API
+#endif
+
+namespace Boxfish
+{
+
+	// Syzygy tables only cover positions without castling rights
+	constexpr int TB_MAX_PIECES = 7;
+
+	// Relative to the team to play, cursed wins and blessed losses are drawn under the 50 move rule
+	enum WDLScore : int
+	{
+		WDL_LOSS = -2,
+		WDL_BLESSED_LOSS = -1,
+		WDL_DRAW = 0,
+		WDL_CURSED_WIN = 1,
+		WDL_WIN = 2
+	};
+
+	enum ProbeState : int
+	{
+		PROBE_FAIL = 0,
+		PROBE_OK = 1,
+		// DTZ only, the best move is a zeroing move
+		PROBE_ZEROING_BEST_MOVE = 2,
+		// DTZ only, the probed table stores the other team
+		PROBE_CHANGE_TEAM = -1
+	};
+
+	inline bool HasCastlingRights(const Position& position)
+	{
+		return position.Teams[TEAM_WHITE].CastleKingSide || position.Teams[TEAM_WHITE].CastleQueenSide ||
+			position.Teams[TEAM_BLACK].CastleKingSide || position.Teams[TEAM_BLACK].CastleQueenSide;
+	}
+
+	// Unmaps any previously loaded tables and registers every .rtbw/.rtbz file found in paths.
+	// Directories are separated by ';' on Windows and ':' elsewhere, an empty string or "<empty>" disables probing.
+	// Files are only mapped into memory when first probed. Returns the number of tables found.
+	int InitTablebases(const std::string& paths);
+
+	// Largest number of pieces (including kings) of any registered table, 0 if none were found
+	int GetTablebaseCardinality();
+
+	// Win/draw/loss for the team to play. The position must have no castling rights.
+	// The move is only made and unmade so the position is unchanged on return.
+	WDLScore ProbeWDL(Position& position, ProbeState* result);
+
+	// Distance to zeroing of the 50 move counter in plies, signed like WDL.
+	// 0 for draws, +-1 when the next zeroing move wins/loses (or the team to play is mated)
+	int ProbeDTZ(Position& position, ProbeState* result);
+
+	// Ranks every legal root move (higher is better, equal ranks are equally good) using the DTZ tables and
+	// the WDL tables if DTZ is missing. Returns false if the position could not be probed.
+	bool RankRootMoves(Position& position, const Move* moves, int count, int* ranks);
+
+}
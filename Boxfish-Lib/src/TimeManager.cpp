@@ -0,0 +1,54 @@
+#include "TimeManager.h"
+#include <algorithm>
+
+namespace Boxfish
+{
+
+	TimeManager::TimeManager()
+		: m_Enabled(false), m_OptimumTime(0), m_MaximumTime(0), m_BestMoveChanges(0.0), m_StableIterations(0)
+	{
+	}
+
+	void TimeManager::Init(int time, int increment, int movesToGo, int ply, int moveOverhead)
+	{
+		m_Enabled = time >= 0;
+		m_OptimumTime = 0;
+		m_MaximumTime = 0;
+		m_BestMoveChanges = 0.0;
+		m_StableIterations = 0;
+		if (!m_Enabled)
+			return;
+
+		// Without movestogo assume fewer moves remain as the game goes on
+		const int movesLeft = (movesToGo > 0) ? std::min(movesToGo, 50) : std::max(50 - ply / 4, 20);
+		// Keep the overhead back for every remaining move so that the clock never runs out
+		const int64_t available = std::max<int64_t>((int64_t)time + (int64_t)increment * (movesLeft - 1) - (int64_t)moveOverhead * (movesLeft + 2), 1);
+		const int64_t optimum = std::max<int64_t>(available / movesLeft, 1);
+
+		// A single move may use at most 80% of the clock
+		const int64_t hardLimit = std::max<int64_t>((int64_t)time * 4 / 5 - moveOverhead, 1);
+		m_MaximumTime = (int)std::min(hardLimit, optimum * ((movesToGo > 0) ? 3 : 5));
+		m_OptimumTime = (int)std::min<int64_t>(optimum, m_MaximumTime);
+	}
+
+	bool TimeManager::ShouldStop(int elapsed, int iterationTime, bool bestMoveChanged, ValueType scoreDrop)
+	{
+		if (!m_Enabled)
+			return false;
+
+		m_BestMoveChanges = m_BestMoveChanges / 2 + (bestMoveChanged ? 1.0 : 0.0);
+		m_StableIterations = bestMoveChanged ? 0 : m_StableIterations + 1;
+
+		// Use more time while the best move keeps changing or the score is falling, less once the best move is settled
+		const double instability = 1.0 + m_BestMoveChanges;
+		const double stability = (m_StableIterations >= 6) ? 0.6 : (m_StableIterations >= 3) ? 0.8 : 1.0;
+		const double fallingScore = std::clamp(1.0 + scoreDrop / 100.0, 0.8, 1.5);
+		const double optimum = std::min(m_OptimumTime * instability * stability * fallingScore, (double)m_MaximumTime);
+		if (elapsed >= optimum)
+			return true;
+
+		// The next iteration usually takes at least as long as every previous one together, don't start one that would be aborted
+		return elapsed + 2 * iterationTime > m_MaximumTime;
+	}
+
+}
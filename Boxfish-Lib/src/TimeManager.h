@@ -0,0 +1,40 @@
+#pragma once
+#include "Position.h"
+
+#ifdef SWIG
+#define BOX_API
+#endif
+
+namespace Boxfish
+{
+
+	// Splits the remaining clock time into a budget for a single move.
+	// The optimum time is where iterative deepening normally stops, scaled up while the best move or score is unstable.
+	// The maximum time is a hard limit that aborts the search even in the middle of an iteration.
+	class BOX_API TimeManager
+	{
+	private:
+		bool m_Enabled;
+		int m_OptimumTime;
+		int m_MaximumTime;
+
+		double m_BestMoveChanges;
+		int m_StableIterations;
+
+	public:
+		TimeManager();
+
+		// All times are in milliseconds. A negative time disables time management, movesToGo of 0 means sudden death
+		void Init(int time, int increment, int movesToGo, int ply, int moveOverhead);
+
+		inline bool IsEnabled() const { return m_Enabled; }
+		inline int GetOptimumTime() const { return m_OptimumTime; }
+		inline int GetMaximumTime() const { return m_MaximumTime; }
+
+		// Called after every completed iteration with the time spent so far and on the last iteration,
+		// scoreDrop is positive when the score is worse than the previous iteration.
+		// Returns true if another iteration should not be started
+		bool ShouldStop(int elapsed, int iterationTime, bool bestMoveChanged, ValueType scoreDrop);
+	};
+
+}
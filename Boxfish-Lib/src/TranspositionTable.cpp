@@ -1,49 +1,183 @@
 #include "TranspositionTable.h"
-#include <bitset>
+#include <cstring>
+#include <fstream>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <thread>
+#include <vector>
+
+#ifdef BOX_PLATFORM_LINUX
+#include <sys/mman.h>
+#endif
 
 namespace Boxfish
 {
 
+	// Large tables are aligned to 2MB so they can be backed by transparent huge pages
+	static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+	static constexpr char SNAPSHOT_MAGIC[4] = { 'B', 'X', 'T', 'T' };
+	static constexpr uint32_t SNAPSHOT_VERSION = 1;
+
+	struct TranspositionTableFileHeader
+	{
+	public:
+		char Magic[4];
+		uint32_t Version;
+		uint64_t ZobristSignature;
+		uint64_t ClusterCount;
+		uint32_t ClusterSize;
+		uint32_t Age;
+	};
+
+	// Returns nullptr if the memory can't be allocated
+	static void* AllocateTable(size_t sizeBytes)
+	{
+		if (sizeBytes > std::numeric_limits<size_t>::max() - HUGE_PAGE_SIZE)
+			return nullptr;
+#if defined(BOX_PLATFORM_WINDOWS)
+		return _aligned_malloc(sizeBytes, alignof(TranspositionTableCluster));
+#elif defined(BOX_PLATFORM_LINUX)
+		size_t alignment = (sizeBytes >= HUGE_PAGE_SIZE) ? HUGE_PAGE_SIZE : alignof(TranspositionTableCluster);
+		size_t allocationSize = (sizeBytes + alignment - 1) / alignment * alignment;
+		void* memory = std::aligned_alloc(alignment, allocationSize);
+		if (memory && alignment == HUGE_PAGE_SIZE)
+			madvise(memory, allocationSize, MADV_HUGEPAGE);
+		return memory;
+#else
+		size_t alignment = alignof(TranspositionTableCluster);
+		return std::aligned_alloc(alignment, (sizeBytes + alignment - 1) / alignment * alignment);
+#endif
+	}
+
+	static void FreeTable(void* memory)
+	{
+#if defined(BOX_PLATFORM_WINDOWS)
+		_aligned_free(memory);
+#else
+		std::free(memory);
+#endif
+	}
+
 	TranspositionTable::TranspositionTable(size_t sizeBytes)
-		: m_Entries{ nullptr }, m_EntryCount()
+		: m_Clusters(nullptr), m_ClusterCount(0), m_Age(0)
+	{
+		if (!Resize(sizeBytes))
+			throw std::bad_alloc();
+	}
+
+	TranspositionTable::~TranspositionTable()
 	{
-		size_t nEntries = sizeBytes / sizeof(TranspositionTableEntry);
+		if (m_Clusters)
+			FreeTable(m_Clusters);
+	}
 
-		if (nEntries != 0)
+	bool TranspositionTable::Resize(size_t sizeBytes, int threads)
+	{
+		size_t nClusters = std::max<size_t>(sizeBytes / sizeof(TranspositionTableCluster), 1);
+		if (nClusters != m_ClusterCount)
 		{
-			uint8_t nBits = 1;
-			size_t ret = 1;
-			while (nEntries >>= 1)
+			TranspositionTableCluster* clusters = (TranspositionTableCluster*)AllocateTable(nClusters * sizeof(TranspositionTableCluster));
+			if (!clusters)
 			{
-				nBits++;
-				ret <<= 1;
+				BOX_WARN("Failed to allocate {} byte transposition table", nClusters * sizeof(TranspositionTableCluster));
+				return false;
 			}
-			m_EntryCount = ret - 1;
-			m_Entries = std::make_unique<TranspositionTableEntry[]>(m_EntryCount + 1);
-			m_Mask = m_EntryCount;
+			if (m_Clusters)
+				FreeTable(m_Clusters);
+			m_Clusters = clusters;
+			m_ClusterCount = nClusters;
 		}
+		Clear(threads);
+		return true;
+	}
 
-		Clear();
+	bool TranspositionTable::SaveToFile(const std::string& filename) const
+	{
+		std::ofstream file(filename, std::ios::binary);
+		if (!file.good())
+			return false;
+		TranspositionTableFileHeader header;
+		memcpy(header.Magic, SNAPSHOT_MAGIC, sizeof(header.Magic));
+		header.Version = SNAPSHOT_VERSION;
+		header.ZobristSignature = GetZobristSignature();
+		header.ClusterCount = m_ClusterCount;
+		header.ClusterSize = sizeof(TranspositionTableCluster);
+		header.Age = m_Age;
+		file.write((const char*)&header, sizeof(header));
+		file.write((const char*)m_Clusters, m_ClusterCount * sizeof(TranspositionTableCluster));
+		return file.good();
+	}
+
+	bool TranspositionTable::LoadFromFile(const std::string& filename, int threads)
+	{
+		std::ifstream file(filename, std::ios::binary | std::ios::ate);
+		if (!file.good())
+			return false;
+		size_t fileSize = (size_t)file.tellg();
+		file.seekg(0);
+
+		TranspositionTableFileHeader header;
+		if (fileSize < sizeof(header) || !file.read((char*)&header, sizeof(header)))
+			return false;
+		if (memcmp(header.Magic, SNAPSHOT_MAGIC, sizeof(header.Magic)) != 0 || header.Version != SNAPSHOT_VERSION ||
+			header.ZobristSignature != GetZobristSignature() || header.ClusterSize != sizeof(TranspositionTableCluster) ||
+			header.ClusterCount == 0 || fileSize != sizeof(header) + header.ClusterCount * sizeof(TranspositionTableCluster))
+			return false;
+
+		// Cluster indices depend on the table size so the snapshot must be loaded into a table of the same size
+		if (!Resize(header.ClusterCount * sizeof(TranspositionTableCluster), threads))
+			return false;
+		if (!file.read((char*)m_Clusters, m_ClusterCount * sizeof(TranspositionTableCluster)))
+		{
+			Clear(threads);
+			return false;
+		}
+		m_Age = (uint8_t)(header.Age % TranspositionTableData::AGE_CYCLE);
+		return true;
 	}
 
 	int TranspositionTable::GetFullProportion() const
 	{
 		int count = 0;
-		int samples = 1023 * 64;
-		for (uint64_t i = 0; i < samples; i++)
+		int samples = (int)std::min<size_t>(1000, m_ClusterCount);
+		for (int i = 0; i < samples; i++)
 		{
-			if (m_Entries[(i * 67) & m_Mask].GetAge() >= 0)
-				count++;
+			const TranspositionTableCluster& cluster = m_Clusters[i];
+			for (int j = 0; j < TranspositionTableCluster::ENTRY_COUNT; j++)
+			{
+				if (!cluster.Entries[j].Peek().IsEmpty())
+					count++;
+			}
 		}
-		return (int)(count * 1000 / samples);
+		return (int)(count * 1000 / (samples * TranspositionTableCluster::ENTRY_COUNT));
 	}
 
-	void TranspositionTable::Clear()
+	void TranspositionTable::Clear(int threads)
 	{
-		for (size_t i = 0; i < m_EntryCount; i++)
+		m_Age = 0;
+		if (m_ClusterCount == 0)
+			return;
+
+		// Not worth starting threads for small tables
+		constexpr size_t MinClustersPerThread = HUGE_PAGE_SIZE / sizeof(TranspositionTableCluster);
+		threads = (int)std::max<size_t>(1, std::min<size_t>(threads, m_ClusterCount / MinClustersPerThread));
+
+		const size_t stride = m_ClusterCount / threads;
+		auto clearRange = [this, stride, threads](int index)
 		{
-			m_Entries[i].Update(0ULL, MOVE_NONE, -1, SCORE_NONE, LOWER_BOUND, -1, false);
-		}
+			size_t start = stride * index;
+			size_t count = (index == threads - 1) ? (m_ClusterCount - start) : stride;
+			std::memset((void*)(m_Clusters + start), 0, count * sizeof(TranspositionTableCluster));
+		};
+
+		std::vector<std::thread> workers;
+		for (int i = 1; i < threads; i++)
+			workers.emplace_back(clearRange, i);
+		clearRange(0);
+		for (std::thread& worker : workers)
+			worker.join();
 	}
 
 }
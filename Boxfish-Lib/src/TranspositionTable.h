@@ -4,6 +4,13 @@
 #include "Evaluation.h"
 #include <memory>
 #include <iostream>
+#include <string>
+#include <algorithm>
+#include <atomic>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 #ifdef SWIG
 #define BOX_API
@@ -19,62 +26,145 @@ namespace Boxfish
 		LOWER_BOUND = 0b10,
 	};
 
+	// Entry data is packed into a single 64 bit word:
+	// Move (28 bits) | Score (20 bits, signed) | Depth (8 bits) | Flag (2 bits) | PV (1 bit) | Age (5 bits)
+	struct BOX_API TranspositionTableData
+	{
+	public:
+		static constexpr int DEPTH_OFFSET = 128;
+		static constexpr int AGE_CYCLE = 32;
+
+	private:
+		static constexpr int SCORE_SHIFT = 28;
+		static constexpr int DEPTH_SHIFT = 48;
+		static constexpr int FLAG_SHIFT = 56;
+		static constexpr int PV_SHIFT = 58;
+		static constexpr int AGE_SHIFT = 59;
+
+		static constexpr uint64_t MOVE_MASK = 0xFFFFFFF;
+		static constexpr uint64_t SCORE_MASK = 0xFFFFF;
+
+	public:
+		uint64_t Data = 0;
+
+	public:
+		TranspositionTableData() = default;
+		inline TranspositionTableData(uint64_t data) : Data(data) {}
+		inline TranspositionTableData(Move move, int depth, ValueType score, EntryFlag flag, uint8_t age, bool isPv)
+			: Data(Pack(move, depth, score, flag, age, isPv))
+		{
+		}
+
+		inline Move GetMove() const { return Move((uint32_t)(Data & MOVE_MASK)); }
+		inline int GetDepth() const { return GetStoredDepth() - DEPTH_OFFSET; }
+		inline bool IsPv() const { return (Data >> PV_SHIFT) & 0x1; }
+		// Sign extend the 20 bit score
+		inline ValueType GetScore() const { return (ValueType)((int64_t)(Data << (64 - SCORE_SHIFT - 20)) >> (64 - 20)); }
+		inline EntryFlag GetFlag() const { return (EntryFlag)((Data >> FLAG_SHIFT) & 0x3); }
+		inline uint8_t GetAge() const { return (uint8_t)(Data >> AGE_SHIFT); }
+		inline bool IsEmpty() const { return GetStoredDepth() == 0; }
+
+		inline void SetMove(Move move) { Data = (Data & ~MOVE_MASK) | move.GetPacked(); }
+
+	private:
+		inline int GetStoredDepth() const { return (int)((Data >> DEPTH_SHIFT) & 0xFF); }
+
+		static inline uint64_t Pack(Move move, int depth, ValueType score, EntryFlag flag, uint8_t age, bool isPv)
+		{
+			BOX_ASSERT(score >= -(1 << 19) && score < (1 << 19), "Score out of range");
+			uint64_t storedDepth = (uint64_t)std::clamp(depth + DEPTH_OFFSET, 1, 0xFF);
+			return (uint64_t)move.GetPacked() |
+				(((uint64_t)score & SCORE_MASK) << SCORE_SHIFT) |
+				(storedDepth << DEPTH_SHIFT) |
+				((uint64_t)flag << FLAG_SHIFT) |
+				((uint64_t)isPv << PV_SHIFT) |
+				((uint64_t)(age % AGE_CYCLE) << AGE_SHIFT);
+		}
+	};
+
+	// Entries are shared between search threads without locking.
+	// The key is stored XORed with the data word, so an entry torn by concurrent writes fails verification and reads as a miss.
 	struct BOX_API TranspositionTableEntry
 	{
 	private:
-		ZobristHash Hash;
-		Move BestMove;
-		int8_t Depth;
-		ValueType Score;
-		int16_t Age = -1;
-		EntryFlag Flag;
-		bool IsPvEntry;
+		std::atomic<uint64_t> Key;
+		std::atomic<uint64_t> Data;
 
 	public:
-		inline ZobristHash GetHash() const { return Hash; }
-		inline Move GetMove() const { return BestMove; }
-		inline int GetDepth() const { return (int)Depth; }
-		inline bool IsPv() const { return IsPvEntry; }
-		inline ValueType GetScore() const { return Score; }
-		inline EntryFlag GetFlag() const { return Flag; }
-		inline int16_t GetAge() const { return Age; }
-
-		inline void Update(ZobristHash hash, Move move, int depth, ValueType score, EntryFlag flag, int16_t age, bool isPv)
+		// Returns true and copies the data if the entry holds a consistent record for hash
+		inline bool Load(const ZobristHash& hash, TranspositionTableData& data) const
+		{
+			data = Data.load(std::memory_order_relaxed);
+			uint64_t key = Key.load(std::memory_order_relaxed);
+			return !data.IsEmpty() && (key ^ data.Data) == hash.Hash;
+		}
+
+		inline TranspositionTableData Peek() const { return Data.load(std::memory_order_relaxed); }
+
+		inline void Update(ZobristHash hash, Move move, int depth, ValueType score, EntryFlag flag, uint8_t age, bool isPv)
 		{
 			BOX_ASSERT(flag >= 1 && flag <= 3, "Invalid flag");
-			if (move != MOVE_NONE || hash != Hash)
-				BestMove = move;
-			if (flag == EXACT || hash != Hash || (depth + 7 > Depth - 4) || Age < 0)
-			{
-				Hash = hash;
-				Depth = (int8_t)depth;
-				Score = score;
-				Age = age;
-				Flag = flag;
-				IsPvEntry = isPv;
-			}
+			TranspositionTableData current;
+			const bool newKey = !Load(hash, current);
+			Move bestMove = current.GetMove();
+			if (move != MOVE_NONE || newKey)
+				bestMove = move;
+			if (flag == EXACT || newKey || (depth + 7 > current.GetDepth() - 4))
+				current = TranspositionTableData(bestMove, depth, score, flag, age, isPv);
+			else
+				current.SetMove(bestMove);
+			Data.store(current.Data, std::memory_order_relaxed);
+			Key.store(hash.Hash ^ current.Data, std::memory_order_relaxed);
 		}
 	};
 
+	// Entries are bucketed so that a probe touches a single cache line
+	struct alignas(64) TranspositionTableCluster
+	{
+	public:
+		static constexpr int ENTRY_COUNT = 4;
+
+		TranspositionTableEntry Entries[ENTRY_COUNT];
+	};
+
+	static_assert(sizeof(TranspositionTableEntry) == 16, "Invalid entry size");
+	static_assert(sizeof(TranspositionTableCluster) == 64, "Invalid cluster size");
+
 	class BOX_API TranspositionTable
 	{
 	public:
 		static constexpr uint64_t TABLE_SIZE = 50 * 1024 * 1024;
 
 	private:
-		std::unique_ptr<TranspositionTableEntry[]> m_Entries;
-		size_t m_EntryCount;
-		size_t m_Mask;
+		TranspositionTableCluster* m_Clusters;
+		size_t m_ClusterCount;
+		uint8_t m_Age;
 
 	public:
 		TranspositionTable(size_t sizeBytes = TABLE_SIZE);
+		TranspositionTable(const TranspositionTable& other) = delete;
+		TranspositionTable& operator=(const TranspositionTable& other) = delete;
+		~TranspositionTable();
 
+		// Reallocates the table, discarding all entries. Must not be called while searching.
+		// Returns false and keeps the current table and its entries if the memory can't be allocated
+		bool Resize(size_t sizeBytes, int threads = 1);
+
+		// Snapshots are only loaded if they were written with the same format and Zobrist keys
+		bool SaveToFile(const std::string& filename) const;
+		bool LoadFromFile(const std::string& filename, int threads = 1);
+
+		inline size_t GetSizeBytes() const { return m_ClusterCount * sizeof(TranspositionTableCluster); }
 		int GetFullProportion() const;
+		inline uint8_t GetAge() const { return m_Age; }
+
+		// Should be called once at the start of every search
+		inline void NewSearch() { m_Age = (m_Age + 1) % TranspositionTableData::AGE_CYCLE; }
 
 		inline void Prefetch(const ZobristHash& hash) const
 		{
 #ifndef EMSCRIPTEN
-			void* address = &m_Entries[GetIndexFromHash(hash)];
+			void* address = &m_Clusters[GetIndexFromHash(hash)];
 	#ifdef BOX_PLATFORM_WINDOWS
 			_mm_prefetch((const char*)address, _MM_HINT_T0);
 	#else
@@ -83,17 +173,64 @@ namespace Boxfish
 #endif
 		}
 
-		inline TranspositionTableEntry* GetEntry(const ZobristHash& hash, bool& found) const
+		// Returns the matching entry if found, otherwise the entry that should be replaced
+		inline TranspositionTableEntry* GetEntry(const ZobristHash& hash, bool& found, TranspositionTableData& data) const
 		{
-			TranspositionTableEntry* entry = &m_Entries[GetIndexFromHash(hash)];
-			found = entry->GetHash() == hash;
-			return entry;
+			TranspositionTableEntry* entries = m_Clusters[GetIndexFromHash(hash)].Entries;
+			for (int i = 0; i < TranspositionTableCluster::ENTRY_COUNT; i++)
+			{
+				if (entries[i].Load(hash, data))
+				{
+					found = true;
+					return &entries[i];
+				}
+				if (data.IsEmpty())
+				{
+					found = false;
+					return &entries[i];
+				}
+			}
+
+			// Prefer replacing shallow entries from previous searches
+			TranspositionTableEntry* replace = &entries[0];
+			int replaceValue = GetReplacementValue(entries[0].Peek());
+			for (int i = 1; i < TranspositionTableCluster::ENTRY_COUNT; i++)
+			{
+				int value = GetReplacementValue(entries[i].Peek());
+				if (value < replaceValue)
+				{
+					replace = &entries[i];
+					replaceValue = value;
+				}
+			}
+			found = false;
+			return replace;
 		}
 
-		void Clear();
+		// Clearing with multiple threads also spreads the first touch of each page over the threads' NUMA nodes
+		void Clear(int threads = 1);
 
 	private:
-		inline size_t GetIndexFromHash(const ZobristHash& hash) const { return hash.Hash & m_Mask; }
+		// Multiply-shift maps the hash onto any cluster count, so the table does not need to be a power of 2
+		inline size_t GetIndexFromHash(const ZobristHash& hash) const
+		{
+#if defined(__SIZEOF_INT128__)
+			return (size_t)(((unsigned __int128)hash.Hash * (unsigned __int128)m_ClusterCount) >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+			return (size_t)__umulh(hash.Hash, (uint64_t)m_ClusterCount);
+#else
+			uint64_t aLow = hash.Hash & 0xFFFFFFFF;
+			uint64_t aHigh = hash.Hash >> 32;
+			uint64_t bLow = (uint64_t)m_ClusterCount & 0xFFFFFFFF;
+			uint64_t bHigh = (uint64_t)m_ClusterCount >> 32;
+			uint64_t lowHigh = aLow * bHigh;
+			uint64_t highLow = aHigh * bLow;
+			uint64_t middle = ((aLow * bLow) >> 32) + (lowHigh & 0xFFFFFFFF) + (highLow & 0xFFFFFFFF);
+			return (size_t)(aHigh * bHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32));
+#endif
+		}
+		inline int GetRelativeAge(const TranspositionTableData& data) const { return (TranspositionTableData::AGE_CYCLE + m_Age - data.GetAge()) % TranspositionTableData::AGE_CYCLE; }
+		inline int GetReplacementValue(const TranspositionTableData& data) const { return data.GetDepth() - 8 * GetRelativeAge(data); }
 	};
 
 }
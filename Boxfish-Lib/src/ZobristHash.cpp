@@ -13,6 +13,7 @@ namespace Boxfish
 	uint64_t s_BlackToMove;
 	uint64_t s_CastlingRights[4];
 	uint64_t s_EnPassantFile[FILE_MAX];
+	uint64_t s_NoPawns;
 
 	void InitZobristHash()
 	{
@@ -39,10 +40,35 @@ namespace Boxfish
 			{
 				s_EnPassantFile[file] = dist(mt);
 			}
+			s_NoPawns = dist(mt);
 			s_Initialized = true;
 		}
 	}
 
+	uint64_t GetZobristSignature()
+	{
+		BOX_ASSERT(s_Initialized, "Zobrist keys not initialized");
+		uint64_t signature = s_Seed;
+		auto combine = [&signature](uint64_t key)
+		{
+			signature = (signature ^ key) * 0x100000001B3ULL;
+		};
+		for (Piece piece = PIECE_PAWN; piece < PIECE_MAX; piece++)
+		{
+			for (SquareIndex index = a1; index < FILE_MAX * RANK_MAX; index++)
+			{
+				combine(s_PieceOnSquare[TEAM_WHITE][piece][index]);
+				combine(s_PieceOnSquare[TEAM_BLACK][piece][index]);
+			}
+		}
+		combine(s_BlackToMove);
+		for (int i = 0; i < 4; i++)
+			combine(s_CastlingRights[i]);
+		for (File file = FILE_A; file < FILE_MAX; file++)
+			combine(s_EnPassantFile[file]);
+		return signature;
+	}
+
 	ZobristHash operator^(const ZobristHash& left, const ZobristHash& right)
 	{
 		return left.Hash ^ right.Hash;
@@ -105,6 +131,21 @@ namespace Boxfish
 			AddCastleQueenside(TEAM_BLACK);
 	}
 
+	void ZobristHash::SetPawnsFromPosition(const Position& position)
+	{
+		// Non-zero so that an empty pawn hash entry never matches
+		Hash = s_NoPawns;
+		for (Team team : { TEAM_WHITE, TEAM_BLACK })
+		{
+			BitBoard pawns = position.GetTeamPieces(team, PIECE_PAWN);
+			while (pawns)
+			{
+				SquareIndex index = PopLeastSignificantBit(pawns);
+				AddPieceAt(team, PIECE_PAWN, index);
+			}
+		}
+	}
+
 	void ZobristHash::RemovePieceAt(Team team, Piece piece, SquareIndex square)
 	{
 		Hash ^= s_PieceOnSquare[team][piece][square];
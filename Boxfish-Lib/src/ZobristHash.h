@@ -11,6 +11,8 @@ namespace Boxfish
 	struct Position;
 
 	void InitZobristHash();
+	// Identifies the set of Zobrist keys in use, hashes from a different set are meaningless
+	uint64_t GetZobristSignature();
 
 	class BOX_API ZobristHash
 	{
@@ -22,6 +24,8 @@ namespace Boxfish
 		ZobristHash(uint64_t hash);
 
 		void SetFromPosition(const Position& position);
+		// Key of the pawn structure only, updated with AddPieceAt/RemovePieceAt for pawn moves
+		void SetPawnsFromPosition(const Position& position);
 		void RemovePieceAt(Team team, Piece piece, SquareIndex square);
 		void AddPieceAt(Team team, Piece piece, SquareIndex square);
 		void FlipTeamToPlay();
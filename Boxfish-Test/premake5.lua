@@ -24,6 +24,11 @@ project "Boxfish-Test"
         "../%{BoxfishIncludeDirs.Catch}"
     }
 
+    defines
+    {
+        "BOX_TEST_TABLEBASE_DIR=\"" .. path.getabsolute("tablebases") .. "\""
+    }
+
     links
     {
         "Boxfish-Lib"
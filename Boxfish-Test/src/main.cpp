@@ -1,6 +1,11 @@
 #define CATCH_CONFIG_MAIN
 #include "catch.hpp"
 #include "Boxfish.h"
+#include <thread>
+#include <fstream>
+#include <cstdio>
+#include <random>
+#include <tuple>
 
 namespace Test
 {
@@ -225,40 +230,90 @@ namespace Test
 		REQUIRE(search.Perft(position, 5) == 164075551);
 	}
 
+	TEST_CASE("PerftSuite", "[Perft]")
+	{
+		Init();
+		PerftHashTable table(16 * 1024 * 1024);
+
+		// En passant, castling and promotion edge cases
+		const std::vector<std::tuple<std::string, int, size_t>> suite = {
+			{ "3k4/3p4/8/K1P4r/8/8/8/8 b - - 0 1", 6, 1134888 },
+			{ "8/8/4k3/8/2p5/8/B2P2K1/8 w - - 0 1", 6, 1015133 },
+			{ "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1", 6, 1440467 },
+			{ "5k2/8/8/8/8/8/8/4K2R w K - 0 1", 6, 661072 },
+			{ "3k4/8/8/8/8/8/8/R3K3 w Q - 0 1", 6, 803711 },
+			{ "r3k2r/1b4bq/8/8/8/8/7B/R3K2R w KQkq - 0 1", 4, 1274206 },
+			{ "r3k2r/8/3Q4/8/8/5q2/8/R3K2R b KQkq - 0 1", 4, 1720476 },
+			{ "2K2r2/4P3/8/8/8/8/8/3k4 w - - 0 1", 6, 3821001 },
+			{ "8/8/1P2K3/8/2n5/1q6/8/5k2 b - - 0 1", 5, 1004658 },
+			{ "4k3/1P6/8/8/8/8/K7/8 w - - 0 1", 6, 217342 },
+			{ "8/P1k5/K7/8/8/8/8/8 w - - 0 1", 6, 92683 },
+			{ "K1k5/8/P7/8/8/8/8/8 w - - 0 1", 6, 2217 },
+			{ "8/k1P5/8/1K6/8/8/8/8 w - - 0 1", 7, 567584 },
+			{ "8/8/2k5/5q2/5n2/8/5K2/8 b - - 0 1", 4, 23527 },
+		};
+
+		for (const auto& test : suite)
+		{
+			Position position = CreatePositionFromFEN(std::get<0>(test));
+			const int depth = std::get<1>(test);
+			const size_t nodes = std::get<2>(test);
+
+			PerftResult result = RunPerft(position, depth);
+			REQUIRE(result.Nodes == nodes);
+			REQUIRE(result.Divide.size() == GetLegalMovesSlow(position).size());
+			REQUIRE(RunPerft(position, depth, 4).Nodes == nodes);
+			// Second run is mostly answered by the hash table
+			REQUIRE(RunPerft(position, depth, 4, &table).Nodes == nodes);
+			REQUIRE(RunPerft(position, depth, 4, &table).Nodes == nodes);
+		}
+
+		Position position = CreateStartingPosition();
+		REQUIRE(RunPerft(position, 0).Nodes == 1);
+		REQUIRE(RunPerft(position, 1).Nodes == 20);
+		PerftResult result = RunPerft(position, 3, 2, &table);
+		REQUIRE(result.Nodes == 8902);
+		for (const PerftMove& move : result.Divide)
+		{
+			UndoInfo undo;
+			ApplyMove(position, move.RootMove, &undo);
+			REQUIRE(RunPerft(position, 2).Nodes == move.Nodes);
+			UndoMove(position, move.RootMove, undo);
+		}
+	}
+
 	TEST_CASE("Transposition", "[Transposition]")
 	{
+		Init();
 		TranspositionTable tt;
 
 		Position position = CreateStartingPosition();
 
-		TranspositionTableEntry tte;
-		tte.Update(position.Hash, MOVE_NONE, 10, 487, UPPER_BOUND, 160, false);
+		TranspositionTableData tte(MOVE_NONE, 10, 487, UPPER_BOUND, 16, false);
 
-		REQUIRE(tte.GetHash() == position.Hash);
 		REQUIRE(tte.GetMove() == MOVE_NONE);
 		REQUIRE(tte.GetDepth() == 10);
 		REQUIRE(tte.GetScore() == 487);
 		REQUIRE(tte.GetFlag() == UPPER_BOUND);
-		REQUIRE(tte.GetAge() == 160);
+		REQUIRE(tte.GetAge() == 16);
 		REQUIRE(tte.IsPv() == false);
 
 		bool found;
-		TranspositionTableEntry* entry = tt.GetEntry(position.Hash, found);
+		TranspositionTableData data;
+		TranspositionTableEntry* entry = tt.GetEntry(position.Hash, found, data);
 		REQUIRE(!found);
-		*entry = tte;
-		TranspositionTableEntry* newEntry = tt.GetEntry(position.Hash, found);
+		entry->Update(position.Hash, MOVE_NONE, 10, 487, UPPER_BOUND, 16, false);
+		TranspositionTableEntry* newEntry = tt.GetEntry(position.Hash, found, data);
 		REQUIRE(newEntry == entry);
 		REQUIRE(found);
-		REQUIRE(newEntry->GetHash() == position.Hash);
-		REQUIRE(newEntry->GetMove() == MOVE_NONE);
-		REQUIRE(newEntry->GetDepth() == 10);
-		REQUIRE(newEntry->GetScore() == 487);
-		REQUIRE(newEntry->GetFlag() == UPPER_BOUND);
-		REQUIRE(newEntry->GetAge() == 160);
-		REQUIRE(newEntry->IsPv() == false);
-
-		tte.Update(position.Hash, MOVE_NONE, 0, -23, EXACT, 2, true);
-		REQUIRE(tte.GetHash() == position.Hash);
+		REQUIRE(data.GetMove() == MOVE_NONE);
+		REQUIRE(data.GetDepth() == 10);
+		REQUIRE(data.GetScore() == 487);
+		REQUIRE(data.GetFlag() == UPPER_BOUND);
+		REQUIRE(data.GetAge() == 16);
+		REQUIRE(data.IsPv() == false);
+
+		tte = TranspositionTableData(MOVE_NONE, 0, -23, EXACT, 2, true);
 		REQUIRE(tte.GetMove() == MOVE_NONE);
 		REQUIRE(tte.GetDepth() == 0);
 		REQUIRE(tte.GetScore() == -23);
@@ -268,14 +323,142 @@ namespace Test
 
 		Move move = PGN::CreateMoveFromString(position, "e4");
 
-		tte.Update(position.Hash, move, -5, SCORE_MATE - 10, EXACT, 22, true);
-		REQUIRE(tte.GetHash() == position.Hash);
+		tte = TranspositionTableData(move, -5, SCORE_MATE - 10, EXACT, 22, true);
 		REQUIRE(tte.GetMove() == move);
 		REQUIRE(tte.GetDepth() == -5);
 		REQUIRE(tte.GetScore() == SCORE_MATE - 10);
 		REQUIRE(tte.GetFlag() == EXACT);
 		REQUIRE(tte.GetAge() == 22);
 		REQUIRE(tte.IsPv() == true);
+
+		// Storing a shallower bound without a move keeps the previous best move
+		entry->Update(position.Hash, move, 8, 30, EXACT, 40, true);
+		entry->Update(position.Hash, MOVE_NONE, 3, -SCORE_MATE + 4, LOWER_BOUND, 40, false);
+		REQUIRE(entry->Load(position.Hash, data));
+		REQUIRE(data.GetMove() == move);
+		REQUIRE(data.GetScore() == -SCORE_MATE + 4);
+		REQUIRE(data.GetFlag() == LOWER_BOUND);
+		REQUIRE(data.GetAge() == 40 % TranspositionTableData::AGE_CYCLE);
+
+		// An entry is only readable with the hash it was stored with
+		ZobristHash otherHash = position.Hash ^ 1ULL;
+		REQUIRE(!entry->Load(otherHash, data));
+
+		// Hashes that share a cluster fill its entries before replacing the least valuable one
+		TranspositionTable smallTable(4 * sizeof(TranspositionTableCluster));
+		for (int i = 0; i < TranspositionTableCluster::ENTRY_COUNT; i++)
+		{
+			ZobristHash hash = ((uint64_t)(i + 1) << 32) | 1;
+			TranspositionTableEntry* clusterEntry = smallTable.GetEntry(hash, found, data);
+			REQUIRE(!found);
+			clusterEntry->Update(hash, MOVE_NONE, 10 - i, 0, EXACT, smallTable.GetAge(), false);
+		}
+		for (int i = 0; i < TranspositionTableCluster::ENTRY_COUNT; i++)
+		{
+			ZobristHash hash = ((uint64_t)(i + 1) << 32) | 1;
+			smallTable.GetEntry(hash, found, data);
+			REQUIRE(found);
+			REQUIRE(data.GetDepth() == 10 - i);
+		}
+		ZobristHash newHash = (5ULL << 32) | 1;
+		TranspositionTableEntry* replaced = smallTable.GetEntry(newHash, found, data);
+		REQUIRE(!found);
+		REQUIRE(replaced->Peek().GetDepth() == 10 - (TranspositionTableCluster::ENTRY_COUNT - 1));
+
+		// Sizes that are not a power of 2 use the whole budget
+		smallTable.Resize(3 * sizeof(TranspositionTableCluster) + 10);
+		REQUIRE(smallTable.GetSizeBytes() == 3 * sizeof(TranspositionTableCluster));
+		REQUIRE(!smallTable.GetEntry(newHash, found, data)->Load(newHash, data));
+		for (uint64_t i = 0; i < 3; i++)
+		{
+			ZobristHash hash = i * (0xFFFFFFFFFFFFFFFFULL / 3) + 1;
+			smallTable.GetEntry(hash, found, data)->Update(hash, MOVE_NONE, 1, (ValueType)i, EXACT, 0, false);
+		}
+		for (uint64_t i = 0; i < 3; i++)
+		{
+			ZobristHash hash = i * (0xFFFFFFFFFFFFFFFFULL / 3) + 1;
+			smallTable.GetEntry(hash, found, data);
+			REQUIRE(found);
+			REQUIRE(data.GetScore() == (ValueType)i);
+		}
+
+		// A failed allocation keeps the current table and its entries
+		REQUIRE(!smallTable.Resize(std::numeric_limits<size_t>::max()));
+		REQUIRE(smallTable.GetSizeBytes() == 3 * sizeof(TranspositionTableCluster));
+		smallTable.GetEntry(1, found, data);
+		REQUIRE(found);
+
+		Search search(1024 * 1024, false);
+		BoxfishSettings settings = search.GetSettings();
+		settings.HashTableBytes = std::numeric_limits<size_t>::max();
+		search.SetSettings(settings);
+		REQUIRE(search.GetSettings().HashTableBytes == 1024 * 1024);
+	}
+
+	TEST_CASE("TranspositionSnapshot", "[Transposition]")
+	{
+		Init();
+		const std::string filename = "boxfish_tt_snapshot.bin";
+		Position position = CreateStartingPosition();
+		Move move = PGN::CreateMoveFromString(position, "e4");
+
+		TranspositionTable tt(5 * sizeof(TranspositionTableCluster));
+		bool found;
+		TranspositionTableData data;
+		tt.GetEntry(position.Hash, found, data)->Update(position.Hash, move, 12, 35, EXACT, tt.GetAge(), true);
+		REQUIRE(tt.SaveToFile(filename));
+
+		TranspositionTable loaded(64 * sizeof(TranspositionTableCluster));
+		REQUIRE(loaded.LoadFromFile(filename));
+		REQUIRE(loaded.GetSizeBytes() == tt.GetSizeBytes());
+		loaded.GetEntry(position.Hash, found, data);
+		REQUIRE(found);
+		REQUIRE(data.GetMove() == move);
+		REQUIRE(data.GetDepth() == 12);
+		REQUIRE(data.GetScore() == 35);
+
+		// Corrupt the version field
+		{
+			std::fstream file(filename, std::ios::binary | std::ios::in | std::ios::out);
+			file.seekp(4);
+			uint32_t version = 0xFFFFFFFF;
+			file.write((const char*)&version, sizeof(version));
+		}
+		REQUIRE(!loaded.LoadFromFile(filename));
+		REQUIRE(!loaded.LoadFromFile("boxfish_missing_snapshot.bin"));
+		std::remove(filename.c_str());
+	}
+
+	TEST_CASE("TranspositionConcurrency", "[Transposition]")
+	{
+		// Writers race on a single entry, readers must never see data from one writer under another writer's key
+		TranspositionTable tt(sizeof(TranspositionTableCluster));
+		bool found;
+		TranspositionTableData data;
+		TranspositionTableEntry* entry = tt.GetEntry(1, found, data);
+
+		std::atomic<bool> torn(false);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; t++)
+		{
+			threads.emplace_back([entry, t, &torn]()
+			{
+				ZobristHash hash = 0x9E3779B97F4A7C15ULL * (t + 1);
+				TranspositionTableData read;
+				for (int i = 0; i < 100000; i++)
+				{
+					entry->Update(hash, MOVE_NONE, t + 1, t * 1000 + 1, EXACT, 0, false);
+					for (int other = 0; other < 4; other++)
+					{
+						if (entry->Load(0x9E3779B97F4A7C15ULL * (other + 1), read) && (read.GetDepth() != other + 1 || read.GetScore() != other * 1000 + 1))
+							torn = true;
+					}
+				}
+			});
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+		REQUIRE(!torn);
 	}
 
 	TEST_CASE("Checks", "[Check]")
@@ -308,6 +491,228 @@ namespace Test
 		REQUIRE(position.InCheck(TEAM_BLACK) == true);
 	}
 
+	// Start position, Kiwipete, perft positions 3 to 5 and an en passant capture next to the king
+	const std::vector<std::string> TEST_POSITIONS = {
+		"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+		"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+		"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+		"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+		"8/8/8/2k5/3Pp3/8/8/4K2R b K d3 0 1",
+	};
+
+	// Calls fn(position, ply, lastMove) for every node up to depth plies below position, lastMove is MOVE_NONE at the root
+	// and after a null move. Null moves are only tried when not in check. Every move is undone so position is unchanged on return
+	template<typename Fn>
+	void ForEachNode(Position& position, int depth, const Fn& fn, bool nullMoves = false, int ply = 0, Move lastMove = MOVE_NONE)
+	{
+		fn(position, ply, lastMove);
+		if (depth <= 0)
+			return;
+		for (Move move : GetLegalMovesSlow(position))
+		{
+			UndoInfo undo;
+			ApplyMove(position, move, &undo);
+			ForEachNode(position, depth - 1, fn, nullMoves, ply + 1, move);
+			UndoMove(position, move, undo);
+		}
+		if (nullMoves && !position.InCheck())
+		{
+			UndoInfo undo;
+			ApplyNullMove(position, &undo);
+			ForEachNode(position, depth - 1, fn, nullMoves, ply + 1, MOVE_NONE);
+			UndoNullMove(position, undo);
+		}
+	}
+
+	bool SamePosition(const Position& a, const Position& b)
+	{
+		if (!(a.Hash == b.Hash) || !(a.PawnHash == b.PawnHash) || GetFENFromPosition(a) != GetFENFromPosition(b))
+			return false;
+		for (Team team : { TEAM_WHITE, TEAM_BLACK })
+		{
+			if (a.InfoCache.TeamPieces[team] != b.InfoCache.TeamPieces[team] || a.InfoCache.KingSquare[team] != b.InfoCache.KingSquare[team]
+				|| a.InfoCache.CheckedBy[team] != b.InfoCache.CheckedBy[team] || a.InfoCache.InCheck[team] != b.InfoCache.InCheck[team]
+				|| a.InfoCache.BlockersForKing[team] != b.InfoCache.BlockersForKing[team] || a.InfoCache.Pinners[team] != b.InfoCache.Pinners[team]
+				|| a.InfoCache.NonPawnMaterial[team] != b.InfoCache.NonPawnMaterial[team] || a.InfoCache.PieceScore[team] != b.InfoCache.PieceScore[team])
+				return false;
+		}
+		for (Piece piece = PIECE_PAWN; piece < PIECE_MAX; piece++)
+		{
+			if (a.InfoCache.PiecesByType[piece] != b.InfoCache.PiecesByType[piece])
+				return false;
+		}
+		for (SquareIndex square = a1; square < SQUARE_MAX; square++)
+		{
+			if (a.InfoCache.PieceOnSquare[square] != b.InfoCache.PieceOnSquare[square])
+				return false;
+		}
+		return a.InfoCache.AllPieces == b.InfoCache.AllPieces && a.InfoCache.Phase == b.InfoCache.Phase;
+	}
+
+	// Makes and unmakes every legal move of position
+	void CheckMakeUnmake(Position& position)
+	{
+		const Position original = position;
+		for (Move move : GetLegalMovesSlow(position))
+		{
+			bool givesCheck = GivesCheck(position, move);
+			UndoInfo undo;
+			ApplyMove(position, move, &undo);
+			REQUIRE(givesCheck == position.InCheck());
+
+			Position copied = original;
+			ApplyMove(copied, move);
+			REQUIRE(SamePosition(position, copied));
+			Position fresh = CreatePositionFromFEN(GetFENFromPosition(position));
+			REQUIRE(position.PawnHash == fresh.PawnHash);
+			REQUIRE(position.GetPieceScore(TEAM_WHITE) == fresh.GetPieceScore(TEAM_WHITE));
+			REQUIRE(position.GetPieceScore(TEAM_BLACK) == fresh.GetPieceScore(TEAM_BLACK));
+			REQUIRE(position.GetPhase() == fresh.GetPhase());
+			REQUIRE(position.GetMaterialKey() == fresh.GetMaterialKey());
+
+			UndoMove(position, move, undo);
+			REQUIRE(SamePosition(position, original));
+		}
+	}
+
+	TEST_CASE("MakeUnmake", "[Check]")
+	{
+		Init();
+		for (const std::string& fen : TEST_POSITIONS)
+		{
+			Position position = CreatePositionFromFEN(fen);
+			ForEachNode(position, 2, [](Position& node, int, Move) { CheckMakeUnmake(node); });
+		}
+	}
+
+	void CheckLegalMoves(const Position& position)
+	{
+		Move buffer[MAX_MOVES];
+		MoveList list(buffer);
+		MoveGenerator generator(position);
+		generator.GetLegalMoves(list);
+		std::vector<Move> legal = GetLegalMovesSlow(position);
+		REQUIRE(list.MoveCount == legal.size());
+		REQUIRE(std::is_permutation(list.Moves, list.Moves + list.MoveCount, legal.begin()));
+	}
+
+	TEST_CASE("LegalMoves", "[MoveGenerator]")
+	{
+		Init();
+		std::vector<std::string> positions = TEST_POSITIONS;
+		positions.insert(positions.end(), {
+				"8/8/8/8/k2Pp2Q/8/8/3K4 b - d3 0 1",
+				"4k3/8/8/b7/8/8/3P4/4K3 w - - 0 1",
+				"4k3/4r3/8/8/8/8/4B3/4K3 w - - 0 1",
+				"3k4/8/8/8/8/8/3r4/R2K1b2 w - - 0 1",
+				"8/8/8/8/1kpP4/8/N7/K7 b - d3 0 1",
+				"r3k2r/Pppp1ppp/1b3nbN/nPB5/B1P1P3/4qN2/Pp1P2PP/R2Q1RK1 w kq - 2 2",
+			});
+		for (const std::string& fen : positions)
+		{
+			Position position = CreatePositionFromFEN(fen);
+			ForEachNode(position, 2, [](Position& node, int, Move) { CheckLegalMoves(node); });
+		}
+	}
+
+	void CheckMoveSelector(const Position& position, const std::vector<Move>& foreignMoves)
+	{
+		Move buffer[MAX_MOVES];
+		MoveList all(buffer);
+		MoveGenerator generator(position);
+		generator.GetPseudoLegalMoves(all);
+		std::vector<Move> expected(all.Moves, all.Moves + all.MoveCount);
+
+		Move splitBuffer[MAX_MOVES];
+		MoveList split(splitBuffer);
+		generator.Generate<CAPTURES>(split);
+		for (int i = 0; i < split.MoveCount; i++)
+			REQUIRE(split.Moves[i].IsCaptureOrPromotion());
+		int captureCount = split.MoveCount;
+		generator.Generate<QUIETS>(split);
+		for (int i = captureCount; i < split.MoveCount; i++)
+			REQUIRE(!split.Moves[i].IsCaptureOrPromotion());
+		REQUIRE(split.MoveCount == all.MoveCount);
+
+		if (!position.InCheck())
+		{
+			std::vector<Move> quietChecks;
+			for (int i = captureCount; i < split.MoveCount; i++)
+			{
+				if (GivesCheck(position, split.Moves[i]))
+					quietChecks.push_back(split.Moves[i]);
+			}
+			Move checksBuffer[MAX_MOVES];
+			MoveList checks(checksBuffer);
+			generator.Generate<QUIET_CHECKS>(checks);
+			REQUIRE(checks.MoveCount == quietChecks.size());
+			REQUIRE(std::is_permutation(checks.Moves, checks.Moves + checks.MoveCount, quietChecks.begin()));
+
+			Move nonEvasionsBuffer[MAX_MOVES];
+			MoveList nonEvasions(nonEvasionsBuffer);
+			generator.Generate<NON_EVASIONS>(nonEvasions);
+			REQUIRE(std::is_permutation(nonEvasions.Moves, nonEvasions.Moves + nonEvasions.MoveCount, expected.begin(), expected.end()));
+		}
+
+		for (Move move : expected)
+			REQUIRE(generator.IsPseudoLegal(move));
+		for (Move move : foreignMoves)
+			REQUIRE(generator.IsPseudoLegal(move) == (std::find(expected.begin(), expected.end(), move) != expected.end()));
+
+		std::vector<Move> legal = GetLegalMovesSlow(position);
+		// Evasions are generated legal
+		if (position.InCheck())
+			expected = legal;
+		Move ttMove = legal.empty() ? MOVE_NONE : legal.back();
+		const size_t count = foreignMoves.size();
+		Move killers[2] = { count > 0 ? foreignMoves[count - 1] : MOVE_NONE, count > 1 ? foreignMoves[count - 2] : MOVE_NONE };
+		Move counterMove = count > 2 ? foreignMoves[count - 3] : MOVE_NONE;
+		OrderingTables tables;
+		tables.Clear();
+
+		Move selectorBuffer[MAX_MOVES];
+		MoveList selectorMoves(selectorBuffer);
+		MoveSelector selector(&selectorMoves, &position, ttMove, counterMove, MOVE_NONE, &tables, killers);
+		std::vector<Move> selected;
+		Move move;
+		while ((move = selector.GetNextMove(false)) != MOVE_NONE)
+			selected.push_back(move);
+
+		REQUIRE(selected.size() == expected.size());
+		REQUIRE(std::is_permutation(selected.begin(), selected.end(), expected.begin()));
+		if (ttMove != MOVE_NONE)
+			REQUIRE(selected[0] == ttMove);
+	}
+
+	TEST_CASE("MoveSelector", "[MoveSelector]")
+	{
+		Init();
+		std::vector<Move> foreignMoves;
+		for (const std::string& fen : {
+				"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+				"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq -",
+				"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -",
+				"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+				"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+				"8/8/8/2k5/3Pp3/8/8/4K2R b K d3 0 1",
+				"5k2/8/8/8/8/8/8/4K2R w K - 0 1",
+				"4k3/8/8/4N3/8/8/8/4RK2 w - - 0 1",
+				"7k/8/8/8/8/2P5/1B6/K7 w - - 0 1",
+			})
+		{
+			Position position = CreatePositionFromFEN(fen);
+			for (Move move : GetLegalMovesSlow(position))
+			{
+				Position movedPosition = position;
+				ApplyMove(movedPosition, move);
+				CheckMoveSelector(movedPosition, foreignMoves);
+				foreignMoves.push_back(move);
+			}
+			CheckMoveSelector(position, foreignMoves);
+		}
+	}
+
 	TEST_CASE("Mirror", "[Evaluation]")
 	{
 		Init();
@@ -365,6 +770,501 @@ namespace Test
 		}
 	}
 
+	TEST_CASE("Score", "[Evaluation]")
+	{
+		for (int mg : { -30000, -515, -1, 0, 1, 140, 30000 })
+		{
+			for (int eg : { -30000, -975, -1, 0, 1, 350, 30000 })
+			{
+				Score score = MakeScore(mg, eg);
+				REQUIRE(MgValue(score) == mg);
+				REQUIRE(EgValue(score) == eg);
+				REQUIRE(MgValue(-score) == -mg);
+				REQUIRE(EgValue(-score) == -eg);
+				REQUIRE(EgValue(score + MakeScore(-mg, 7)) == eg + 7);
+			}
+		}
+	}
+
+	TEST_CASE("LazyEvaluation", "[Evaluation]")
+	{
+		Init();
+		Position position = CreatePositionFromFEN("r1bq1rk1/pp2ppbp/2np2p1/2n5/P3PP2/N1P2N2/1PB3PP/R1B1QRK1 b - -");
+		ValueType full = EvaluateDetailed(position).GetTotal(position.TeamToPlay);
+		const ValueType margin = 600;
+		bool lazy;
+		REQUIRE(Evaluate(position, position.TeamToPlay, full - 1, full + 1, nullptr, margin, &lazy) == full);
+		REQUIRE(!lazy);
+		Evaluate(position, position.TeamToPlay, full + 5000, full + 5001, nullptr, margin, &lazy);
+		REQUIRE(lazy);
+		Evaluate(position, position.TeamToPlay, full - 5001, full - 5000, nullptr, margin, &lazy);
+		REQUIRE(lazy);
+		// A margin of 0 always evaluates fully
+		REQUIRE(Evaluate(position, position.TeamToPlay, full + 5000, full + 5001, nullptr, 0, &lazy) == full);
+		REQUIRE(!lazy);
+	}
+
+	TEST_CASE("Endgames", "[Evaluation]")
+	{
+		Init();
+		REQUIRE(CreatePositionFromFEN("4k3/8/8/8/8/8/1N2B3/4K3 w - -").GetMaterialKey() == CreateMaterialKey("KBNK", TEAM_WHITE));
+		REQUIRE(CreatePositionFromFEN("4k3/8/8/8/8/8/1N2B3/4K3 w - -").GetMaterialKey() != CreateMaterialKey("KBNK", TEAM_BLACK));
+		REQUIRE(CreatePositionFromFEN("4k3/8/8/8/8/8/1N2B3/4K3 w - -").GetMaterialKey() == CreatePositionFromFEN("4k3/8/8/8/8/8/1B2N3/4K3 w - -").GetMaterialKey());
+
+		// King in front of the pawn on the sixth rank always wins
+		REQUIRE(ProbeKPK(CreatePositionFromFEN("4k3/8/4K3/4P3/8/8/8/8 w - -"), TEAM_WHITE));
+		REQUIRE(ProbeKPK(CreatePositionFromFEN("4k3/8/4K3/4P3/8/8/8/8 b - -"), TEAM_WHITE));
+		REQUIRE(ProbeKPK(CreatePositionFromFEN("8/8/8/8/4p3/4k3/8/4K3 b - -"), TEAM_BLACK));
+		// Opposition in front of the key squares
+		REQUIRE(!ProbeKPK(CreatePositionFromFEN("8/8/4k3/8/4K3/4P3/8/8 w - -"), TEAM_WHITE));
+		REQUIRE(ProbeKPK(CreatePositionFromFEN("8/8/4k3/8/4K3/4P3/8/8 b - -"), TEAM_WHITE));
+		// Outside the square of the pawn
+		REQUIRE(ProbeKPK(CreatePositionFromFEN("k7/8/8/8/8/8/7P/7K b - -"), TEAM_WHITE));
+		// Stalemate and rook pawns
+		REQUIRE(!ProbeKPK(CreatePositionFromFEN("4k3/4P3/4K3/8/8/8/8/8 b - -"), TEAM_WHITE));
+		REQUIRE(!ProbeKPK(CreatePositionFromFEN("k7/8/1K6/P7/8/8/8/8 w - -"), TEAM_WHITE));
+		REQUIRE(ProbeKPK(CreatePositionFromFEN("8/8/8/8/8/8/6kp/4K3 b - -"), TEAM_BLACK));
+
+		REQUIRE(Evaluate(CreatePositionFromFEN("4k3/8/4K3/4P3/8/8/8/8 b - -"), TEAM_WHITE) > SCORE_KNOWN_WIN);
+		REQUIRE(Evaluate(CreatePositionFromFEN("8/8/4k3/8/4K3/4P3/8/8 w - -"), TEAM_WHITE) == SCORE_DRAW);
+		REQUIRE(Evaluate(CreatePositionFromFEN("8/8/8/3k4/8/8/8/1R2K3 w - -"), TEAM_WHITE) > SCORE_KNOWN_WIN);
+		REQUIRE(Evaluate(CreatePositionFromFEN("8/8/8/3K4/8/8/8/1r2k3 w - -"), TEAM_BLACK) > SCORE_KNOWN_WIN);
+		REQUIRE(Evaluate(CreatePositionFromFEN("8/8/8/3k4/8/8/8/1NN1K3 w - -"), TEAM_WHITE) == SCORE_DRAW);
+		// Stalemated bare king
+		REQUIRE(Evaluate(CreatePositionFromFEN("k7/2Q5/1K6/8/8/8/8/8 b - -"), TEAM_WHITE) == SCORE_DRAW);
+
+		// The defending king is pushed towards a corner of the bishop's colour
+		ValueType rightCorner = Evaluate(CreatePositionFromFEN("k7/8/2K5/8/8/8/8/3BN3 w - -"), TEAM_WHITE);
+		ValueType wrongCorner = Evaluate(CreatePositionFromFEN("7k/8/5K2/8/8/8/8/3BN3 w - -"), TEAM_WHITE);
+		REQUIRE(rightCorner > wrongCorner);
+
+		// Rook pawn with the wrong bishop
+		REQUIRE(Evaluate(CreatePositionFromFEN("7k/8/8/7P/8/8/4B3/4K3 w - -"), TEAM_WHITE) < 100);
+		REQUIRE(Evaluate(CreatePositionFromFEN("7k/8/8/7P/8/8/3B4/4K3 w - -"), TEAM_WHITE) > 400);
+	}
+
+	void CheckPawnHashTable(const Position& position, PawnHashTable& table)
+	{
+		ValueType expected = Evaluate(position, position.TeamToPlay, -SCORE_MATE, SCORE_MATE);
+		REQUIRE(Evaluate(position, position.TeamToPlay, -SCORE_MATE, SCORE_MATE, &table) == expected);
+		REQUIRE(Evaluate(position, position.TeamToPlay, -SCORE_MATE, SCORE_MATE, &table) == expected);
+	}
+
+	TEST_CASE("PawnHashTable", "[Evaluation]")
+	{
+		Init();
+		PawnHashTable table;
+		std::vector<std::string> positions = TEST_POSITIONS;
+		positions.insert(positions.end(), {
+				"4b3/p3kp2/6p1/3pP2p/2pP1P2/4K1P1/P3N2P/8 w - -",
+				"2r2knr/2P5/1R3pp1/p4p1p/3P1B2/5N2/PP1N1PPP/3QR1K1 w - - 0 20",
+			});
+		for (const std::string& fen : positions)
+		{
+			Position position = CreatePositionFromFEN(fen);
+			ForEachNode(position, 2, [&table](Position& node, int, Move) { CheckPawnHashTable(node, table); });
+		}
+	}
+
+	// accumulators[ply] is reset when a node is entered, the way the search does. Only every other ply and the leaves are
+	// evaluated so that updates also have to be chained through positions that were never evaluated
+	void CheckNNUEAccumulator(const Position& position, NNUEAccumulator* accumulators, int ply, Move lastMove, bool leaf)
+	{
+		accumulators[ply].Computed[TEAM_WHITE] = accumulators[ply].Computed[TEAM_BLACK] = false;
+		accumulators[ply].LastMove = lastMove;
+		if (ply % 2 == 0 || leaf)
+		{
+			REQUIRE(EvaluateNNUE(position, position.TeamToPlay, accumulators, ply) == EvaluateNNUE(position, position.TeamToPlay));
+			REQUIRE(EvaluateNNUE(position, OtherTeam(position.TeamToPlay), accumulators, ply) == EvaluateNNUE(position, OtherTeam(position.TeamToPlay)));
+		}
+	}
+
+	TEST_CASE("NNUE", "[Evaluation]")
+	{
+		Init();
+		const std::string filename = "boxfish_test_network.nnue";
+		{
+			std::mt19937 mt(12345);
+			std::uniform_int_distribution<int> dist(-64, 64);
+			std::ofstream file(filename, std::ios::binary);
+			const char magic[4] = { 'B', 'X', 'N', 'N' };
+			const uint32_t header[3] = { 1, NNUE_INPUT_DIMENSIONS, NNUE_HALF_DIMENSIONS };
+			file.write(magic, sizeof(magic));
+			file.write((const char*)header, sizeof(header));
+			std::vector<int16_t> weights((size_t)(NNUE_INPUT_DIMENSIONS + 3) * NNUE_HALF_DIMENSIONS);
+			for (int16_t& weight : weights)
+				weight = (int16_t)dist(mt);
+			file.write((const char*)weights.data(), weights.size() * sizeof(int16_t));
+			const int32_t bias = 25;
+			file.write((const char*)&bias, sizeof(bias));
+		}
+		REQUIRE(!LoadNetwork("boxfish_missing_network.nnue"));
+		REQUIRE(LoadNetwork(filename));
+		std::remove(filename.c_str());
+
+		constexpr int depth = 3;
+		std::vector<NNUEAccumulator> accumulators(depth + 1);
+		for (const std::string& fen : TEST_POSITIONS)
+		{
+			Position position = CreatePositionFromFEN(fen);
+			ForEachNode(position, depth, [&accumulators](Position& node, int ply, Move lastMove)
+			{
+				CheckNNUEAccumulator(node, accumulators.data(), ply, lastMove, ply == depth);
+			}, true);
+		}
+
+		// Selecting the NNUE is a per search setting and doesn't change Evaluate() for everyone else
+		Search search(1024 * 1024, false);
+		BoxfishSettings settings = search.GetSettings();
+		settings.UseNNUE = true;
+		search.SetSettings(settings);
+		Position position = CreateStartingPosition();
+		REQUIRE(Evaluate(position, TEAM_WHITE) == EvaluateDetailed(position).GetTotal(TEAM_WHITE));
+		// The random network ignores material so the quiescence search barely prunes, keep to a quiet position
+		SearchLimits limits;
+		limits.Depth = 6;
+		REQUIRE(search.SearchBestMove(CreatePositionFromFEN("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - -"), limits) != MOVE_NONE);
+	}
+
+	TEST_CASE("Bench", "[Search]")
+	{
+		Init();
+		for (const std::string& fen : GetBenchPositions())
+		{
+			Position position = CreatePositionFromFEN(fen);
+			REQUIRE(GetFENFromPosition(position) == fen);
+			REQUIRE(!position.InCheck(OtherTeam(position.TeamToPlay)));
+			REQUIRE(!GetLegalMovesSlow(position).empty());
+		}
+
+		BenchResult first = RunBench(4, 1, 1024 * 1024, false);
+		// The signature doesn't depend on the settings of any other search
+		Search search(1024 * 1024, false);
+		BoxfishSettings settings = search.GetSettings();
+		settings.LazyEvalMargin = 600;
+		settings.UseNNUE = true;
+		search.SetSettings(settings);
+		BenchResult second = RunBench(4, 1, 1024 * 1024, false);
+		REQUIRE(first.Nodes > 0);
+		REQUIRE(first.Nodes == second.Nodes);
+	}
+
+	TEST_CASE("SearchStats", "[Search]")
+	{
+		Init();
+		Search search(1024 * 1024, false);
+		SearchLimits limits;
+		limits.Depth = 8;
+		search.SearchBestMove(CreatePositionFromFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10"), limits);
+		SearchStats stats = search.GetSearchStats();
+		const uint64_t* c = stats.Counters;
+
+		if (SEARCH_STATS_ENABLED)
+		{
+			REQUIRE(c[STAT_MAIN_NODES] > 0);
+			REQUIRE(c[STAT_QUIESCENCE_NODES] > 0);
+			REQUIRE(c[STAT_TT_HITS] <= c[STAT_TT_PROBES]);
+			REQUIRE(c[STAT_TT_CUTOFFS] <= c[STAT_TT_HITS]);
+			REQUIRE(c[STAT_EXPANDED_NODES] <= c[STAT_MAIN_NODES]);
+			REQUIRE(c[STAT_BETA_CUTOFFS] <= c[STAT_EXPANDED_NODES]);
+			REQUIRE(c[STAT_FIRST_MOVE_CUTOFFS] <= c[STAT_BETA_CUTOFFS]);
+			REQUIRE(c[STAT_NULL_MOVE_CUTOFFS] <= c[STAT_NULL_MOVE_TRIES]);
+			REQUIRE(c[STAT_LMR_RESEARCHES] <= c[STAT_LMR_SEARCHES]);
+			REQUIRE(c[STAT_LMR_SEARCHES] <= c[STAT_MOVES_SEARCHED]);
+		}
+		else
+		{
+			for (int i = 0; i < STAT_MAX; i++)
+				REQUIRE(c[i] == 0);
+		}
+	}
+
+	TEST_CASE("TimeManager", "[Search]")
+	{
+		Init();
+		TimeManager manager;
+		manager.Init(-1, 0, 0, 0, 30);
+		REQUIRE(!manager.IsEnabled());
+		REQUIRE(!manager.ShouldStop(1000000, 1000000, false, 0));
+
+		manager.Init(60000, 0, 0, 20, 30);
+		REQUIRE(manager.IsEnabled());
+		REQUIRE(manager.GetOptimumTime() > 0);
+		REQUIRE(manager.GetOptimumTime() <= manager.GetMaximumTime());
+		REQUIRE(manager.GetMaximumTime() < 60000);
+		const int suddenDeath = manager.GetOptimumTime();
+
+		manager.Init(60000, 1000, 0, 20, 30);
+		REQUIRE(manager.GetOptimumTime() > suddenDeath);
+
+		// Never plan to use the whole clock, even on the last move before the time control
+		for (int time : { 0, 10, 100, 1000, 60000 })
+		{
+			manager.Init(time, 0, 1, 80, 30);
+			REQUIRE(manager.GetOptimumTime() >= 1);
+			REQUIRE(manager.GetOptimumTime() <= manager.GetMaximumTime());
+			REQUIRE(manager.GetMaximumTime() <= std::max(time * 4 / 5, 1));
+		}
+
+		// An unstable best move or falling score extends the search past the optimum time, a stable one stops before it
+		manager.Init(60000, 0, 0, 20, 30);
+		const int optimum = manager.GetOptimumTime();
+		REQUIRE(!manager.ShouldStop(optimum * 11 / 10, 0, true, 0));
+		manager.Init(60000, 0, 0, 20, 30);
+		REQUIRE(!manager.ShouldStop(optimum * 11 / 10, 0, false, 200));
+		manager.Init(60000, 0, 0, 20, 30);
+		REQUIRE(manager.ShouldStop(optimum * 11 / 10, 0, false, 0));
+		manager.Init(60000, 0, 0, 20, 30);
+		for (int i = 0; i < 6; i++)
+			REQUIRE(!manager.ShouldStop(0, 0, false, 0));
+		REQUIRE(manager.ShouldStop(optimum * 7 / 10, 0, false, 0));
+
+		// Don't start an iteration that can't finish before the maximum time
+		manager.Init(60000, 0, 0, 20, 30);
+		REQUIRE(manager.ShouldStop(optimum / 2, manager.GetMaximumTime() / 2, false, 0));
+
+		Search search(1024 * 1024, false);
+		SearchLimits limits;
+		limits.Time[TEAM_WHITE] = 500;
+		limits.Time[TEAM_BLACK] = 500;
+		manager.Init(500, 0, 0, 0, search.GetSettings().MoveOverhead);
+		auto startTime = std::chrono::high_resolution_clock::now();
+		Move move = search.SearchBestMove(CreateStartingPosition(), limits);
+		auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - startTime);
+		REQUIRE(move != MOVE_NONE);
+		// Only catches a search that ignores the clock, the margin leaves room for slow or heavily loaded machines
+		REQUIRE(elapsed.count() < manager.GetMaximumTime() + 10000);
+	}
+
+	TEST_CASE("Tablebase", "[Tablebase]")
+	{
+		Init();
+		REQUIRE(InitTablebases("boxfish_missing_tablebases") == 0);
+		REQUIRE(GetTablebaseCardinality() == 0);
+
+		// Smallest valid KQvK WDL table: each team to play stores a single value, white to play wins and black to play loses
+		const std::string filename = "KQvK.rtbw";
+		{
+			uint8_t data[80] = { 0x71, 0xE8, 0x23, 0x5D, 0x01, 0x00, 0x66, 0x55, 0xEE, 0x00, 0x80, 0x04, 0x80, 0x00 };
+			std::ofstream file(filename, std::ios::binary);
+			file.write((const char*)data, sizeof(data));
+		}
+		REQUIRE(InitTablebases(".") == 1);
+		REQUIRE(GetTablebaseCardinality() == 3);
+
+		ProbeState state;
+		Position position = CreatePositionFromFEN("8/8/8/3k4/8/8/8/KQ6 w - - 0 1");
+		REQUIRE(ProbeWDL(position, &state) == WDL_WIN);
+		REQUIRE(state == PROBE_OK);
+		position = CreatePositionFromFEN("8/8/8/3k4/8/8/8/KQ6 b - - 0 1");
+		REQUIRE(ProbeWDL(position, &state) == WDL_LOSS);
+		// Colours flipped
+		position = CreatePositionFromFEN("kq6/8/8/8/3K4/8/8/8 b - - 0 1");
+		REQUIRE(ProbeWDL(position, &state) == WDL_WIN);
+		// The queen is hanging
+		position = CreatePositionFromFEN("K7/8/8/8/8/8/1Q6/2k5 b - - 0 1");
+		REQUIRE(ProbeWDL(position, &state) == WDL_DRAW);
+
+		// There is no DTZ table so root moves are ranked by WDL
+		position = CreatePositionFromFEN("8/8/8/3k4/8/8/8/KQ6 w - - 0 1");
+		std::vector<Move> moves = GetLegalMovesSlow(position);
+		std::vector<int> ranks(moves.size());
+		REQUIRE(ProbeDTZ(position, &state) == 0);
+		REQUIRE(state == PROBE_FAIL);
+		REQUIRE(RankRootMoves(position, moves.data(), (int)moves.size(), ranks.data()));
+		// Qe4+ loses the queen
+		REQUIRE(*std::max_element(ranks.begin(), ranks.end()) > 0);
+		REQUIRE(std::count(ranks.begin(), ranks.end(), 0) == 1);
+
+		std::remove(filename.c_str());
+		InitTablebases("");
+		REQUIRE(GetTablebaseCardinality() == 0);
+	}
+
+	// Absolute path of Boxfish-Test/tablebases so that the tests can be run from any directory
+	std::string GetTestTablebasePath()
+	{
+#ifdef BOX_TEST_TABLEBASE_DIR
+		return BOX_TEST_TABLEBASE_DIR;
+#else
+		const std::string file = __FILE__;
+		return file.substr(0, file.find_last_of("/\\")) + "/../tablebases";
+#endif
+	}
+
+	// FEN without castling rights for the given (FEN piece, square index) pairs
+	std::string CreateFEN(const std::vector<std::pair<char, int>>& pieces, Team teamToPlay)
+	{
+		char board[SQUARE_MAX] = {};
+		for (const auto& piece : pieces)
+			board[piece.second] = piece.first;
+		std::string fen;
+		for (int rank = RANK_8; rank >= RANK_1; rank--)
+		{
+			int empty = 0;
+			for (int file = FILE_A; file <= FILE_H; file++)
+			{
+				const char piece = board[file + rank * FILE_MAX];
+				if (!piece)
+				{
+					empty++;
+					continue;
+				}
+				if (empty > 0)
+					fen += char('0' + empty);
+				fen += piece;
+				empty = 0;
+			}
+			if (empty > 0)
+				fen += char('0' + empty);
+			if (rank != RANK_1)
+				fen += '/';
+		}
+		return fen + ((teamToPlay == TEAM_WHITE) ? " w - - 0 1" : " b - - 0 1");
+	}
+
+	// Kings on distinct, non adjacent squares
+	bool ValidKings(int whiteKing, int blackKing)
+	{
+		return std::abs(whiteKing % 8 - blackKing % 8) > 1 || std::abs(whiteKing / 8 - blackKing / 8) > 1;
+	}
+
+	int ProbeChildDTZ(Position& position, Move move)
+	{
+		UndoInfo undo;
+		ApplyMove(position, move, &undo);
+		ProbeState state;
+		const int dtz = ProbeDTZ(position, &state);
+		REQUIRE(state != PROBE_FAIL);
+		UndoMove(position, move, undo);
+		return dtz;
+	}
+
+	// Plays the line where the winning team zeroes as quickly as possible and the losing team delays it, returns the number of plies until mate
+	int PlayDTZLine(const std::string& fen)
+	{
+		Position position = CreatePositionFromFEN(fen);
+		int plies = 0;
+		std::vector<Move> moves = GetLegalMovesSlow(position);
+		while (!moves.empty())
+		{
+			const bool winning = plies % 2 == 0;
+			Move best = MOVE_NONE;
+			int bestDTZ = 0;
+			for (Move move : moves)
+			{
+				const int dtz = ProbeChildDTZ(position, move);
+				if (winning ? (dtz < 0 && (best == MOVE_NONE || dtz > bestDTZ)) : (best == MOVE_NONE || dtz > bestDTZ))
+				{
+					best = move;
+					bestDTZ = dtz;
+				}
+			}
+			REQUIRE(best != MOVE_NONE);
+			ApplyMove(position, best);
+			moves = GetLegalMovesSlow(position);
+			plies++;
+		}
+		REQUIRE(position.InCheck());
+		return plies;
+	}
+
+	TEST_CASE("TablebaseFiles", "[Tablebase]")
+	{
+		Init();
+		// Three piece tables generated by Scripts/generate_tablebases.py
+		REQUIRE(InitTablebases(GetTestTablebasePath()) == 5);
+		REQUIRE(GetTablebaseCardinality() == 3);
+
+		ProbeState state;
+		// Every KPvK position must agree with the bitbase, for both teams and the DTZ must have the same sign
+		for (Team strongTeam : { TEAM_WHITE, TEAM_BLACK })
+		{
+			for (Team teamToPlay : { TEAM_WHITE, TEAM_BLACK })
+			{
+				for (int whiteKing = 0; whiteKing < SQUARE_MAX; whiteKing++)
+				{
+					for (int blackKing = 0; blackKing < SQUARE_MAX; blackKing++)
+					{
+						if (!ValidKings(whiteKing, blackKing))
+							continue;
+						for (int pawn = 8; pawn < 56; pawn++)
+						{
+							if (pawn == whiteKing || pawn == blackKing)
+								continue;
+							Position position = CreatePositionFromFEN(CreateFEN({ { 'K', whiteKing }, { 'k', blackKing }, { (strongTeam == TEAM_WHITE) ? 'P' : 'p', pawn } }, teamToPlay));
+							if (position.InCheck(OtherTeam(teamToPlay)))
+								continue;
+							const WDLScore expected = !ProbeKPK(position, strongTeam) ? WDL_DRAW : (teamToPlay == strongTeam) ? WDL_WIN : WDL_LOSS;
+							const WDLScore wdl = ProbeWDL(position, &state);
+							REQUIRE(state != PROBE_FAIL);
+							REQUIRE(wdl == expected);
+							const int dtz = ProbeDTZ(position, &state);
+							REQUIRE(state != PROBE_FAIL);
+							REQUIRE((dtz > 0) - (dtz < 0) == (wdl > 0) - (wdl < 0));
+						}
+					}
+				}
+			}
+		}
+
+		// With the rook to play KRvK is always won, with the king to play it is only drawn by stalemate or by taking the rook
+		for (Team teamToPlay : { TEAM_WHITE, TEAM_BLACK })
+		{
+			for (int whiteKing = 0; whiteKing < SQUARE_MAX; whiteKing++)
+			{
+				for (int blackKing = 0; blackKing < SQUARE_MAX; blackKing++)
+				{
+					if (!ValidKings(whiteKing, blackKing))
+						continue;
+					for (int rook = 0; rook < SQUARE_MAX; rook++)
+					{
+						if (rook == whiteKing || rook == blackKing)
+							continue;
+						Position position = CreatePositionFromFEN(CreateFEN({ { 'K', whiteKing }, { 'k', blackKing }, { 'R', rook } }, teamToPlay));
+						if (position.InCheck(OtherTeam(teamToPlay)))
+							continue;
+						WDLScore expected = WDL_WIN;
+						if (teamToPlay == TEAM_BLACK)
+						{
+							const std::vector<Move> moves = GetLegalMovesSlow(position);
+							const bool stalemate = moves.empty() && !position.InCheck();
+							const bool takesRook = std::any_of(moves.begin(), moves.end(), [](Move move) { return move.IsCapture(); });
+							expected = (stalemate || takesRook) ? WDL_DRAW : WDL_LOSS;
+						}
+						REQUIRE(ProbeWDL(position, &state) == expected);
+						REQUIRE(state != PROBE_FAIL);
+					}
+				}
+			}
+		}
+
+		// KRvK stores plies, the other tables store moves and are only exact for odd distances
+		const std::vector<std::pair<std::string, int>> distances = {
+			{ "k7/8/1K6/8/8/8/8/7R w - - 0 1", 1 },
+			{ "R6k/8/6K1/8/8/8/8/8 b - - 0 1", -1 },
+			{ "7K/6R1/5k2/8/8/8/8/8 w - - 0 1", 31 },
+			{ "7K/5kR1/8/8/8/8/8/8 b - - 0 1", -32 },
+			{ "7K/6Q1/8/8/2k5/8/8/8 w - - 0 1", 19 },
+			{ "4k3/8/4K3/4P3/8/8/8/8 w - - 0 1", 3 },
+			{ "4k3/8/4K3/4P3/8/8/8/8 b - - 0 1", -4 },
+			{ "8/8/8/8/4p3/4k3/8/4K3 w - - 0 1", -4 },
+		};
+		for (const auto& [fen, dtz] : distances)
+		{
+			Position position = CreatePositionFromFEN(fen);
+			REQUIRE(ProbeDTZ(position, &state) == dtz);
+			REQUIRE(state != PROBE_FAIL);
+		}
+
+		// Following the tables mates in exactly the stored distance
+		REQUIRE(PlayDTZLine("7K/6R1/5k2/8/8/8/8/8 w - - 0 1") == 31);
+		REQUIRE(PlayDTZLine("7K/6Q1/8/8/2k5/8/8/8 w - - 0 1") == 19);
+
+		InitTablebases("");
+		REQUIRE(GetTablebaseCardinality() == 0);
+	}
+
 	TEST_CASE("PGN", "[FORMATTING]")
 	{
 		Init();
@@ -5,6 +5,7 @@ BoxfishLibDir = "Boxfish-Lib/"
 BoxfishCliDir = "Boxfish-Cli/"
 BoxfishTestDir = "Boxfish-Test/"
 BoxfishBookDir = "Boxfish-Book/"
+BoxfishBenchDir = "Boxfish-Bench/"
 
 -- Include directories relative to solution directory
 BoxfishIncludeDirs = {}
@@ -1,3 +1,3 @@
 pushd ../
-./vendor/bin/Linux/premake/premake5 --os=linux gmake2
+./vendor/bin/Linux/premake/premake5 --os=linux gmake2 "$@"
 popd
\ No newline at end of file
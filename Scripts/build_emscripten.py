@@ -7,19 +7,28 @@ CLI_DIRECTORY = "../Boxfish-Cli/src"
 SOURCE_DIRECTORY = "../Boxfish-Lib/src"
 SOURCE_FILES = [
     "Attacks.cpp",
+    "Bench.cpp",
     "Bitboard.cpp",
     "Book.cpp",
     "Boxfish.cpp",
+    "Endgame.cpp",
+    "EvalHashTable.cpp",
     "Evaluation.cpp",
     "Format.cpp",
     "Logging.cpp",
     "MoveGenerator.cpp",
     "MoveSelector.cpp",
+    "NNUE.cpp",
+    "PawnHashTable.cpp",
+    "Perft.cpp",
     "Position.cpp",
     "PositionUtils.cpp",
     "Random.cpp",
     "Rays.cpp",
     "Search.cpp",
+    "SearchStats.cpp",
+    "Tablebase.cpp",
+    "TimeManager.cpp",
     "TranspositionTable.cpp",
     "ZobristHash.cpp",
     "Emscripten.cpp",
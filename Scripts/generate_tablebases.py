@@ -0,0 +1,602 @@
+import hashlib
+import os
+from collections import Counter, defaultdict
+
+# Generates the three piece Syzygy tables (KPvK, KNvK, KBvK, KRvK and KQvK) used by Boxfish-Test.
+# Every position is solved by retrograde analysis, then written in the WDL (.rtbw) and DTZ (.rtbz) formats
+# with the same position indexing, pair compression and Huffman coding that Tablebase.cpp decodes.
+
+OUTPUT_DIRECTORY = os.path.join(os.path.dirname(os.path.abspath(__file__)), "../Boxfish-Test/tablebases")
+
+WDL_MAGIC = bytes([0x71, 0xE8, 0x23, 0x5D])
+DTZ_MAGIC = bytes([0xD7, 0x66, 0x0C, 0xA5])
+
+WHITE = 0
+BLACK = 1
+PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING = range(6)
+PIECE_NAMES = "PNBRQK"
+
+WDL_LOSS = -2
+WDL_DRAW = 0
+WDL_WIN = 2
+
+FLAG_STM = 1
+FLAG_MAPPED = 2
+FLAG_WIN_PLIES = 4
+FLAG_LOSS_PLIES = 8
+FLAG_SINGLE_VALUE = 128
+
+BLOCK_SIZE_LOG2 = 6
+SPAN_LOG2 = 8
+MAX_PAIRS = 64
+MIN_PAIR_COUNT = 16
+MAX_SYMBOL_VALUES = 256
+MAX_SYMBOL_LENGTH = 24
+MAX_BLOCK_VALUES = 65536
+
+# Which team to play is stored in each DTZ table and whether distances are stored in plies,
+# the tests rely on these covering both teams and both units
+DTZ_LAYOUT = {
+    KNIGHT: (WHITE, False),
+    BISHOP: (WHITE, False),
+    ROOK: (BLACK, True),
+    QUEEN: (WHITE, False),
+    PAWN: (WHITE, False),
+}
+
+# =====================================================================================================================
+# BOARD
+# =====================================================================================================================
+
+def file_of(square):
+    return square & 7
+
+def rank_of(square):
+    return square >> 3
+
+def distance(a, b):
+    return max(abs(file_of(a) - file_of(b)), abs(rank_of(a) - rank_of(b)))
+
+def step_targets(square, steps):
+    result = []
+    for df, dr in steps:
+        f = file_of(square) + df
+        r = rank_of(square) + dr
+        if 0 <= f < 8 and 0 <= r < 8:
+            result.append(8 * r + f)
+    return result
+
+KING_STEPS = [(df, dr) for df in (-1, 0, 1) for dr in (-1, 0, 1) if df or dr]
+KNIGHT_STEPS = [(1, 2), (2, 1), (2, -1), (1, -2), (-1, -2), (-2, -1), (-2, 1), (-1, 2)]
+ROOK_DIRECTIONS = [(1, 0), (-1, 0), (0, 1), (0, -1)]
+BISHOP_DIRECTIONS = [(1, 1), (1, -1), (-1, 1), (-1, -1)]
+
+KING_ATTACKS = [step_targets(square, KING_STEPS) for square in range(64)]
+KNIGHT_ATTACKS = [step_targets(square, KNIGHT_STEPS) for square in range(64)]
+WHITE_PAWN_ATTACKS = [step_targets(square, [(-1, 1), (1, 1)]) for square in range(64)]
+
+def slider_attacks(square, occupied, directions):
+    result = []
+    for df, dr in directions:
+        f = file_of(square) + df
+        r = rank_of(square) + dr
+        while 0 <= f < 8 and 0 <= r < 8:
+            target = 8 * r + f
+            result.append(target)
+            if occupied & (1 << target):
+                break
+            f += df
+            r += dr
+    return result
+
+def piece_attacks(piece, square, occupied):
+    if piece == KNIGHT:
+        return KNIGHT_ATTACKS[square]
+    if piece == BISHOP:
+        return slider_attacks(square, occupied, BISHOP_DIRECTIONS)
+    if piece == ROOK:
+        return slider_attacks(square, occupied, ROOK_DIRECTIONS)
+    if piece == QUEEN:
+        return slider_attacks(square, occupied, ROOK_DIRECTIONS + BISHOP_DIRECTIONS)
+    return WHITE_PAWN_ATTACKS[square]
+
+def attacks_square(piece, square, target, occupied):
+    return target in piece_attacks(piece, square, occupied)
+
+# =====================================================================================================================
+# SOLVING
+# =====================================================================================================================
+# Results map (team to play, white king, black king, white piece) to (wdl, dtz) from the view of the team to play.
+# dtz counts plies to the next zeroing move or mate: a win that zeroes or mates immediately has 1,
+# a mated position has 1, and no other capture or pawn move is available to the losing side.
+
+class Solver:
+    def __init__(self, piece, pawn_square=None, promotions=None, slices=None):
+        self.piece = piece
+        self.pawn_square = pawn_square
+        # Solved tables for every promotion piece and pawn slices for the squares the pawn can move to
+        self.promotions = promotions
+        self.slices = slices
+        self.results = {}
+
+    def is_valid(self, team, white_king, black_king, square):
+        if len({ white_king, black_king, square }) != 3 or distance(white_king, black_king) <= 1:
+            return False
+        occupied = (1 << white_king) | (1 << black_king) | (1 << square)
+        return team == BLACK or not attacks_square(self.piece, square, black_king, occupied)
+
+    def black_moves(self, white_king, black_king, square):
+        # Returns the number of legal moves, whether one of them captures and whether black is in check
+        occupied = (1 << white_king) | (1 << square)
+        count = 0
+        capture = False
+        for target in KING_ATTACKS[black_king]:
+            if distance(target, white_king) <= 1:
+                continue
+            if target == square:
+                count += 1
+                capture = True
+            elif not attacks_square(self.piece, square, target, occupied):
+                count += 1
+        in_check = attacks_square(self.piece, square, black_king, occupied | (1 << black_king))
+        return count, capture, in_check
+
+    def white_predecessors(self, white_king, black_king, square):
+        for origin in KING_ATTACKS[white_king]:
+            if origin != square and origin != black_king and self.is_valid(WHITE, origin, black_king, square):
+                yield (origin, black_king, square)
+        if self.pawn_square is None:
+            occupied = (1 << white_king) | (1 << black_king)
+            for origin in piece_attacks(self.piece, square, occupied):
+                if origin != white_king and origin != black_king and self.is_valid(WHITE, white_king, black_king, origin):
+                    yield (white_king, black_king, origin)
+
+    def black_predecessors(self, white_king, black_king, square):
+        for origin in KING_ATTACKS[black_king]:
+            if origin != white_king and origin != square and distance(origin, white_king) > 1:
+                yield (white_king, origin, square)
+
+    def white_zeroing_wins(self, white_king, black_king):
+        # Pawn moves into positions that are lost for black
+        pawn = self.pawn_square
+        push = pawn + 8
+        if push in (white_king, black_king):
+            return False
+        targets = [push]
+        if rank_of(pawn) == 1 and pawn + 16 not in (white_king, black_king):
+            targets.append(pawn + 16)
+        for target in targets:
+            if rank_of(target) == 7:
+                for table in self.promotions.values():
+                    if table[(BLACK, white_king, black_king, target)][0] == WDL_LOSS:
+                        return True
+            elif self.slices[target][(BLACK, white_king, black_king)][0] == WDL_LOSS:
+                return True
+        return False
+
+    def solve(self):
+        squares = [self.pawn_square] if self.pawn_square is not None else range(64)
+        remaining = {}
+        wins = defaultdict(list)
+        mated = []
+        for square in squares:
+            for white_king in range(64):
+                for black_king in range(64):
+                    if self.is_valid(BLACK, white_king, black_king, square):
+                        count, capture, in_check = self.black_moves(white_king, black_king, square)
+                        remaining[(white_king, black_king, square)] = count
+                        if count == 0 and in_check:
+                            mated.append((white_king, black_king, square))
+                    if self.pawn_square is not None and self.is_valid(WHITE, white_king, black_king, square):
+                        if self.white_zeroing_wins(white_king, black_king):
+                            self.results[(WHITE, white_king, black_king, square)] = (WDL_WIN, 1)
+                            wins[1].append((white_king, black_king, square))
+
+        def add_loss(state, dtz, winning_dtz):
+            self.results[(BLACK,) + state] = (WDL_LOSS, dtz)
+            for previous in self.white_predecessors(*state):
+                if (WHITE,) + previous not in self.results:
+                    self.results[(WHITE,) + previous] = (WDL_WIN, winning_dtz)
+                    wins[winning_dtz].append(previous)
+
+        # Mating moves count as a single ply like zeroing moves
+        for state in mated:
+            add_loss(state, 1, 1)
+
+        # Wins are visited in order of distance so a loss takes the distance of its longest defence
+        dtz = 1
+        while dtz <= max(wins.keys(), default=0):
+            for state in wins[dtz]:
+                for previous in self.black_predecessors(*state):
+                    if (BLACK,) + previous in self.results or previous not in remaining:
+                        continue
+                    remaining[previous] -= 1
+                    if remaining[previous] == 0:
+                        add_loss(previous, dtz + 1, dtz + 2)
+            dtz += 1
+
+        for square in squares:
+            for white_king in range(64):
+                for black_king in range(64):
+                    for team in (WHITE, BLACK):
+                        key = (team, white_king, black_king, square)
+                        if key not in self.results and self.is_valid(team, white_king, black_king, square):
+                            self.results[key] = (WDL_DRAW, 0)
+        return self.results
+
+def solve_pieces(piece):
+    return Solver(piece).solve()
+
+def solve_pawn(promotions):
+    # Solved from the seventh rank down, pawn moves lead into slices that are already known
+    slices = {}
+    for rank in range(6, 0, -1):
+        for file in range(8):
+            square = 8 * rank + file
+            results = Solver(PAWN, square, promotions, slices).solve()
+            slices[square] = { (team, white_king, black_king): value for (team, white_king, black_king, _), value in results.items() }
+    return slices
+
+# =====================================================================================================================
+# INDEXING
+# =====================================================================================================================
+
+def offset_a1h8(square):
+    return rank_of(square) - file_of(square)
+
+MAP_B1H1H7 = [0] * 64
+MAP_A1D1D4 = [0] * 64
+MAP_PAWNS = [0] * 64
+LEAD_PAWN_INDEX = [0] * 64
+LEAD_PAWNS_SIZE = [0] * 4
+
+def init_encoding():
+    code = 0
+    for square in range(64):
+        if offset_a1h8(square) < 0:
+            MAP_B1H1H7[square] = code
+            code += 1
+
+    diagonal = []
+    code = 0
+    for square in range(28):
+        if offset_a1h8(square) < 0 and file_of(square) <= 3:
+            MAP_A1D1D4[square] = code
+            code += 1
+        elif offset_a1h8(square) == 0 and file_of(square) <= 3:
+            diagonal.append(square)
+    for square in diagonal:
+        MAP_A1D1D4[square] = code
+        code += 1
+
+    available = 47
+    for file in range(4):
+        index = 0
+        for rank in range(1, 7):
+            square = 8 * rank + file
+            MAP_PAWNS[square] = available
+            MAP_PAWNS[square ^ 7] = available - 1
+            available -= 2
+            LEAD_PAWN_INDEX[square] = index
+            index += 1
+        LEAD_PAWNS_SIZE[file] = index
+
+def encode_pieces(squares):
+    # Three unique pieces with the first in the a1-d1-d4 triangle, see ProbeTable()
+    squares = list(squares)
+    if file_of(squares[0]) > 3:
+        squares = [square ^ 7 for square in squares]
+    if rank_of(squares[0]) > 3:
+        squares = [square ^ 56 for square in squares]
+    for i in range(3):
+        if offset_a1h8(squares[i]) == 0:
+            continue
+        if offset_a1h8(squares[i]) > 0:
+            for j in range(i, 3):
+                squares[j] = ((squares[j] >> 3) | (squares[j] << 3)) & 63
+        break
+
+    s0, s1, s2 = squares
+    adjust1 = int(s1 > s0)
+    adjust2 = int(s2 > s0) + int(s2 > s1)
+    if offset_a1h8(s0):
+        return (MAP_A1D1D4[s0] * 63 + (s1 - adjust1)) * 62 + s2 - adjust2
+    if offset_a1h8(s1):
+        return (6 * 63 + rank_of(s0) * 28 + MAP_B1H1H7[s1]) * 62 + s2 - adjust2
+    if offset_a1h8(s2):
+        return 6 * 63 * 62 + 4 * 28 * 62 + rank_of(s0) * 7 * 28 + (rank_of(s1) - adjust1) * 28 + MAP_B1H1H7[s2]
+    return 6 * 63 * 62 + 4 * 28 * 62 + 4 * 7 * 28 + rank_of(s0) * 7 * 6 + (rank_of(s1) - adjust1) * 6 + (rank_of(s2) - adjust2)
+
+def encode_pawn(squares):
+    # Lead pawn first, then one group for each remaining piece. Returns the file table and index
+    if file_of(squares[0]) > 3:
+        squares = [square ^ 7 for square in squares]
+    file = file_of(squares[0])
+    index = LEAD_PAWN_INDEX[squares[0]]
+    group_index = LEAD_PAWNS_SIZE[file]
+    free_squares = 63
+    for i in range(1, len(squares)):
+        adjust = sum(1 for square in squares[:i] if squares[i] > square)
+        index += (squares[i] - adjust) * group_index
+        group_index *= free_squares
+        free_squares -= 1
+    return file, index
+
+def pieces_table_size():
+    return 31332
+
+def pawn_table_size(file):
+    return LEAD_PAWNS_SIZE[file] * 63 * 62
+
+# =====================================================================================================================
+# COMPRESSION
+# =====================================================================================================================
+
+def huffman_lengths(frequencies):
+    while True:
+        lengths = { symbol: 0 for symbol in frequencies }
+        nodes = [(frequency, i, [symbol]) for i, (symbol, frequency) in enumerate(sorted(frequencies.items()))]
+        counter = len(nodes)
+        while len(nodes) > 1:
+            nodes.sort(key=lambda node: (node[0], node[1]))
+            a = nodes.pop(0)
+            b = nodes.pop(0)
+            for symbol in a[2] + b[2]:
+                lengths[symbol] += 1
+            nodes.append((a[0] + b[0], counter, a[2] + b[2]))
+            counter += 1
+        if max(lengths.values()) <= MAX_SYMBOL_LENGTH:
+            return lengths
+        frequencies = { symbol: (frequency + 1) // 2 for symbol, frequency in frequencies.items() }
+
+def pair_symbols(values):
+    # Recursive pairing: the most common pair of adjacent symbols becomes a new symbol
+    leaves = sorted(set(values))
+    tree = [(value, 0xFFF) for value in leaves]
+    sizes = [1] * len(leaves)
+    symbol_of = { value: i for i, value in enumerate(leaves) }
+    sequence = [symbol_of[value] for value in values]
+
+    for _ in range(MAX_PAIRS):
+        counts = Counter(zip(sequence, sequence[1:]))
+        candidates = [(count, pair) for pair, count in counts.items() if sizes[pair[0]] + sizes[pair[1]] <= MAX_SYMBOL_VALUES]
+        if not candidates:
+            break
+        count, (left, right) = max(candidates)
+        if count < MIN_PAIR_COUNT:
+            break
+        symbol = len(tree)
+        paired = []
+        i = 0
+        while i < len(sequence):
+            if i + 1 < len(sequence) and sequence[i] == left and sequence[i + 1] == right:
+                paired.append(symbol)
+                i += 2
+            else:
+                paired.append(sequence[i])
+                i += 1
+        # Huffman codes need at least two symbols
+        if len(set(paired)) < 2:
+            break
+        tree.append((left, right))
+        sizes.append(sizes[left] + sizes[right])
+        sequence = paired
+    return tree, sizes, sequence
+
+def compress(values, flags):
+    # Returns the size section, sparse index, block lengths and data of one PairsData
+    if len(set(values)) == 1:
+        return bytes([flags | FLAG_SINGLE_VALUE, values[0]]), b"", b"", b""
+
+    tree, sizes, sequence = pair_symbols(values)
+    lengths = huffman_lengths(Counter(sequence))
+    min_length = min(lengths.values())
+    max_length = max(lengths.values())
+
+    # Canonical codes: longer codes get lower symbols and lower code values
+    coded = sorted(lengths, key=lambda symbol: (-lengths[symbol], symbol))
+    order = coded + [symbol for symbol in range(len(tree)) if symbol not in lengths]
+    renumber = { symbol: i for i, symbol in enumerate(order) }
+    counts = Counter(lengths.values())
+    lowest = { max_length: 0 }
+    base = { max_length: 0 }
+    for length in range(max_length - 1, min_length - 1, -1):
+        lowest[length] = lowest[length + 1] + counts[length + 1]
+        assert (base[length + 1] + counts[length + 1]) % 2 == 0
+        base[length] = (base[length + 1] + counts[length + 1]) // 2
+    assert base[min_length] + counts[min_length] == 1 << min_length
+
+    codes = {}
+    for symbol in coded:
+        length = lengths[symbol]
+        codes[symbol] = (base[length] + renumber[symbol] - lowest[length], length)
+
+    # Blocks hold whole symbols
+    block_bits = 8 << BLOCK_SIZE_LOG2
+    blocks = []
+    bits = []
+    used = 0
+    block_values = 0
+    for symbol in sequence:
+        code, length = codes[symbol]
+        if used + length > block_bits or block_values + sizes[symbol] > MAX_BLOCK_VALUES:
+            blocks.append((bits, block_values))
+            bits = []
+            used = 0
+            block_values = 0
+        bits.append((code, length))
+        used += length
+        block_values += sizes[symbol]
+    blocks.append((bits, block_values))
+
+    data = bytearray()
+    for bits, _ in blocks:
+        buffer = 0
+        total = 0
+        for code, length in bits:
+            buffer = (buffer << length) | code
+            total += length
+        buffer <<= block_bits - total
+        data += buffer.to_bytes(block_bits // 8, "big")
+
+    block_lengths = bytearray()
+    starts = []
+    start = 0
+    for _, count in blocks:
+        block_lengths += (count - 1).to_bytes(2, "little")
+        starts.append(start)
+        start += count
+
+    # Entry k locates the value k * span + span / 2
+    span = 1 << SPAN_LOG2
+    sparse = bytearray()
+    block = 0
+    for k in range((len(values) + span - 1) // span):
+        middle = k * span + span // 2
+        while block + 1 < len(blocks) and starts[block + 1] <= middle:
+            block += 1
+        offset = middle - starts[block]
+        assert offset < 1 << 16
+        sparse += block.to_bytes(4, "little") + offset.to_bytes(2, "little")
+
+    sizes_section = bytearray([flags, BLOCK_SIZE_LOG2, SPAN_LOG2, 0])
+    sizes_section += len(blocks).to_bytes(4, "little")
+    sizes_section += bytes([max_length, min_length])
+    for length in range(min_length, max_length + 1):
+        sizes_section += lowest[length].to_bytes(2, "little")
+    sizes_section += len(order).to_bytes(2, "little")
+    for symbol in order:
+        left, right = tree[symbol]
+        if right != 0xFFF:
+            left = renumber[left]
+            right = renumber[right]
+        sizes_section += bytes([left & 0xFF, (left >> 8) | ((right & 0xF) << 4), right >> 4])
+    if len(order) & 1:
+        sizes_section += b"\x00"
+    return bytes(sizes_section), bytes(sparse), bytes(block_lengths), bytes(data)
+
+def fill_unknown(values):
+    # Positions that can't occur take the previous value, which compresses best
+    result = []
+    previous = next((value for value in values if value is not None), 0)
+    for value in values:
+        if value is not None:
+            previous = value
+        result.append(previous)
+    return result
+
+# =====================================================================================================================
+# WRITING
+# =====================================================================================================================
+
+def write_table(filename, magic, has_pawns, headers, sections, dtz_map=None):
+    # headers holds the order and piece bytes for every file, sections the compressed PairsData in file then team order.
+    # Only DTZ tables have a value map
+    content = bytearray(magic)
+    content.append(1 | (2 if has_pawns else 0))
+    for header in headers:
+        content += header
+    if len(content) & 1:
+        content.append(0)
+    for section in sections:
+        content += section[0]
+    if dtz_map is not None:
+        content += dtz_map
+        if len(content) & 1:
+            content.append(0)
+    for section in sections:
+        content += section[1]
+    for section in sections:
+        content += section[2]
+    for section in sections:
+        content += b"\x00" * (-len(content) % 64)
+        content += section[3]
+    content += b"\x00" * (-len(content) % 64)
+    content += hashlib.md5(content).digest()
+    with open(os.path.join(OUTPUT_DIRECTORY, filename), "wb") as file:
+        file.write(content)
+
+def piece_code(team, piece):
+    return (team << 3) | (piece + 1)
+
+def header(pieces):
+    # Order byte then the pieces, the low nibble describes white to play and the high nibble black to play
+    return bytes([0x00] + [code | (code << 4) for code in pieces])
+
+def dtz_value(wdl, dtz, plies):
+    return dtz - 1 if plies else (dtz - 1) // 2
+
+def dtz_symbols(entries, plies):
+    # Stored values are indices into the win and loss lists of the value map
+    known = [entry for entry in entries if entry is not None]
+    wins = sorted({ dtz_value(wdl, dtz, plies) for wdl, dtz in known if wdl == WDL_WIN })
+    losses = sorted({ dtz_value(wdl, dtz, plies) for wdl, dtz in known if wdl == WDL_LOSS })
+    assert len(wins) < 256 and len(losses) < 256
+    dtz_map = bytes([len(wins)] + wins + [len(losses)] + losses + [0, 0])
+    symbols = []
+    for entry in entries:
+        if entry is None or entry[0] == WDL_DRAW:
+            symbols.append(None)
+        elif entry[0] == WDL_WIN:
+            symbols.append(wins.index(dtz_value(*entry, plies)))
+        else:
+            symbols.append(losses.index(dtz_value(*entry, plies)))
+    return fill_unknown(symbols), dtz_map
+
+def generate_pieces(piece, results):
+    name = "K" + PIECE_NAMES[piece] + "vK"
+    pieces = [piece_code(WHITE, piece), piece_code(WHITE, KING), piece_code(BLACK, KING)]
+    size = pieces_table_size()
+    tables = { WHITE: [None] * size, BLACK: [None] * size }
+    for (team, white_king, black_king, square), value in results.items():
+        index = encode_pieces([square, white_king, black_king])
+        assert tables[team][index] in (None, value), name
+        tables[team][index] = value
+
+    wdl = [compress(fill_unknown([entry and entry[0] + 2 for entry in tables[team]]), 0) for team in (WHITE, BLACK)]
+    write_table(name + ".rtbw", WDL_MAGIC, False, [header(pieces)], wdl)
+
+    team, plies = DTZ_LAYOUT[piece]
+    symbols, dtz_map = dtz_symbols(tables[team], plies)
+    flags = team | FLAG_MAPPED | ((FLAG_WIN_PLIES | FLAG_LOSS_PLIES) if plies else 0)
+    dtz = compress(symbols, flags)
+    write_table(name + ".rtbz", DTZ_MAGIC, False, [header(pieces)], [dtz], dtz_map)
+
+def generate_pawn(slices):
+    name = "KPvK"
+    pieces = [piece_code(WHITE, PAWN), piece_code(WHITE, KING), piece_code(BLACK, KING)]
+    tables = { (team, file): [None] * pawn_table_size(file) for team in (WHITE, BLACK) for file in range(4) }
+    for square, results in slices.items():
+        for (team, white_king, black_king), value in results.items():
+            file, index = encode_pawn([square, white_king, black_king])
+            assert tables[(team, file)][index] in (None, value), name
+            tables[(team, file)][index] = value
+
+    wdl = []
+    for file in range(4):
+        for team in (WHITE, BLACK):
+            wdl.append(compress(fill_unknown([entry and entry[0] + 2 for entry in tables[(team, file)]]), 0))
+    write_table(name + ".rtbw", WDL_MAGIC, True, [header(pieces)] * 4, wdl)
+
+    team, plies = DTZ_LAYOUT[PAWN]
+    flags = team | FLAG_MAPPED | ((FLAG_WIN_PLIES | FLAG_LOSS_PLIES) if plies else 0)
+    dtz = []
+    dtz_map = bytearray()
+    for file in range(4):
+        symbols, file_map = dtz_symbols(tables[(team, file)], plies)
+        dtz.append(compress(symbols, flags))
+        dtz_map += file_map
+    write_table(name + ".rtbz", DTZ_MAGIC, True, [header(pieces)] * 4, dtz, bytes(dtz_map))
+
+if __name__ == "__main__":
+    os.makedirs(OUTPUT_DIRECTORY, exist_ok=True)
+    init_encoding()
+
+    promotions = {}
+    for piece in (KNIGHT, BISHOP, ROOK, QUEEN):
+        print("Solving K{}vK".format(PIECE_NAMES[piece]))
+        promotions[piece] = solve_pieces(piece)
+        generate_pieces(piece, promotions[piece])
+
+    print("Solving KPvK")
+    generate_pawn(solve_pawn(promotions))
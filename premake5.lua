@@ -1,3 +1,15 @@
+newoption
+{
+    trigger = "pext",
+    description = "Use BMI2 pext instructions for sliding piece attacks instead of magic multiplication"
+}
+
+newoption
+{
+    trigger = "stats",
+    description = "Collect search statistics (TT hits, cutoffs, pruning and reduction counts) for the stats command"
+}
+
 workspace "Boxfish"
     architecture "x64"
 
@@ -20,12 +32,25 @@ workspace "Boxfish"
             "ReleaseShared",
         }
 
+    -- Defined for every project as the attack lookups are inlined from Attacks.h
+    filter "options:pext"
+        defines "BOX_USE_PEXT"
+
+    filter "options:stats"
+        defines "BOX_SEARCH_STATS"
+
+    filter { "options:pext", "system:not windows" }
+        buildoptions { "-mbmi2" }
+
+    filter {}
+
 include ("Paths.lua")
 
 include (BoxfishLibDir)
 include (BoxfishCliDir)
 include (BoxfishTestDir)
 include (BoxfishBookDir)
+include (BoxfishBenchDir)
 
 if os.target() == "windows" then
     -- Windows